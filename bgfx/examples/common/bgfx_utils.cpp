@@ -17,6 +17,12 @@ namespace stl = tinystl;
 #include <bx/math.h>
 #include <bx/readerwriter.h>
 #include <bx/string.h>
+#include <bx/handlealloc.h>
+#include <bx/hash.h>
+#include <bx/mutex.h>
+#include <bx/semaphore.h>
+#include <bx/thread.h>
+#include <bx/file.h>
 #include "entry/entry.h"
 #include <meshoptimizer/src/meshoptimizer.h>
 
@@ -90,7 +96,6 @@ static bgfx::ShaderHandle loadShader(bx::FileReaderI *_reader, const char *_name
     const char *shaderPath = "???";
 
     switch (bgfx::getRendererType()) {
-        case bgfx::RendererType::Noop:
         case bgfx::RendererType::Direct3D9:
             shaderPath = "shaders/dx9/";
             break;
@@ -108,6 +113,8 @@ static bgfx::ShaderHandle loadShader(bx::FileReaderI *_reader, const char *_name
         case bgfx::RendererType::Nvn:
             shaderPath = "shaders/nvn/";
             break;
+        // the noop renderer only parses the shader header, any compiled set will do
+        case bgfx::RendererType::Noop:
         case bgfx::RendererType::OpenGL:
             shaderPath = "shaders/glsl/";
             break;
@@ -131,7 +138,12 @@ static bgfx::ShaderHandle loadShader(bx::FileReaderI *_reader, const char *_name
     bx::strCat(filePath, BX_COUNTOF(filePath), _name);
     bx::strCat(filePath, BX_COUNTOF(filePath), ".bin");
 
-    bgfx::ShaderHandle handle = bgfx::createShader(loadMem(_reader, filePath));
+    const bgfx::Memory *mem = loadMem(_reader, filePath);
+    if (NULL == mem) {
+        return BGFX_INVALID_HANDLE;
+    }
+
+    bgfx::ShaderHandle handle = bgfx::createShader(mem);
     bgfx::setName(handle, _name);
 
     return handle;
@@ -161,6 +173,55 @@ static void imageReleaseCb(void *_ptr, void *_userData) {
     bimg::imageFree(imageContainer);
 }
 
+// takes ownership of _imageContainer, it is freed once bgfx is done with the texture data
+static bgfx::TextureHandle
+createTexture(bimg::ImageContainer *_imageContainer, const char *_filePath, uint64_t _flags, bgfx::TextureInfo *_info,
+              bimg::Orientation::Enum *_orientation) {
+    bgfx::TextureHandle handle = BGFX_INVALID_HANDLE;
+
+    if (NULL != _orientation) {
+        *_orientation = _imageContainer->m_orientation;
+    }
+
+    const bgfx::Memory *mem = bgfx::makeRef(
+            _imageContainer->m_data, _imageContainer->m_size, imageReleaseCb, _imageContainer
+    );
+
+    if (_imageContainer->m_cubeMap) {
+        handle = bgfx::createTextureCube(
+                uint16_t(_imageContainer->m_width), 1 < _imageContainer->m_numMips, _imageContainer->m_numLayers,
+                bgfx::TextureFormat::Enum(_imageContainer->m_format), _flags, mem
+        );
+    } else if (1 < _imageContainer->m_depth) {
+        handle = bgfx::createTexture3D(
+                uint16_t(_imageContainer->m_width), uint16_t(_imageContainer->m_height),
+                uint16_t(_imageContainer->m_depth), 1 < _imageContainer->m_numMips,
+                bgfx::TextureFormat::Enum(_imageContainer->m_format), _flags, mem
+        );
+    } else if (bgfx::isTextureValid(0, false, _imageContainer->m_numLayers,
+                                    bgfx::TextureFormat::Enum(_imageContainer->m_format), _flags)) {
+        handle = bgfx::createTexture2D(
+                uint16_t(_imageContainer->m_width), uint16_t(_imageContainer->m_height),
+                1 < _imageContainer->m_numMips, _imageContainer->m_numLayers,
+                bgfx::TextureFormat::Enum(_imageContainer->m_format), _flags, mem
+        );
+    }
+
+    if (bgfx::isValid(handle)) {
+        bgfx::setName(handle, _filePath);
+    }
+
+    if (NULL != _info) {
+        bgfx::calcTextureSize(
+                *_info, uint16_t(_imageContainer->m_width), uint16_t(_imageContainer->m_height),
+                uint16_t(_imageContainer->m_depth), _imageContainer->m_cubeMap, 1 < _imageContainer->m_numMips,
+                _imageContainer->m_numLayers, bgfx::TextureFormat::Enum(_imageContainer->m_format)
+        );
+    }
+
+    return handle;
+}
+
 bgfx::TextureHandle
 loadTexture(bx::FileReaderI *_reader, const char *_filePath, uint64_t _flags, uint8_t _skip, bgfx::TextureInfo *_info,
             bimg::Orientation::Enum *_orientation) {
@@ -171,48 +232,10 @@ loadTexture(bx::FileReaderI *_reader, const char *_filePath, uint64_t _flags, ui
     void *data = load(_reader, entry::getAllocator(), _filePath, &size);
     if (NULL != data) {
         bimg::ImageContainer *imageContainer = bimg::imageParse(entry::getAllocator(), data, size);
+        unload(data);
 
         if (NULL != imageContainer) {
-            if (NULL != _orientation) {
-                *_orientation = imageContainer->m_orientation;
-            }
-
-            const bgfx::Memory *mem = bgfx::makeRef(
-                    imageContainer->m_data, imageContainer->m_size, imageReleaseCb, imageContainer
-            );
-            unload(data);
-
-            if (imageContainer->m_cubeMap) {
-                handle = bgfx::createTextureCube(
-                        uint16_t(imageContainer->m_width), 1 < imageContainer->m_numMips, imageContainer->m_numLayers,
-                        bgfx::TextureFormat::Enum(imageContainer->m_format), _flags, mem
-                );
-            } else if (1 < imageContainer->m_depth) {
-                handle = bgfx::createTexture3D(
-                        uint16_t(imageContainer->m_width), uint16_t(imageContainer->m_height),
-                        uint16_t(imageContainer->m_depth), 1 < imageContainer->m_numMips,
-                        bgfx::TextureFormat::Enum(imageContainer->m_format), _flags, mem
-                );
-            } else if (bgfx::isTextureValid(0, false, imageContainer->m_numLayers,
-                                            bgfx::TextureFormat::Enum(imageContainer->m_format), _flags)) {
-                handle = bgfx::createTexture2D(
-                        uint16_t(imageContainer->m_width), uint16_t(imageContainer->m_height),
-                        1 < imageContainer->m_numMips, imageContainer->m_numLayers,
-                        bgfx::TextureFormat::Enum(imageContainer->m_format), _flags, mem
-                );
-            }
-
-            if (bgfx::isValid(handle)) {
-                bgfx::setName(handle, _filePath);
-            }
-
-            if (NULL != _info) {
-                bgfx::calcTextureSize(
-                        *_info, uint16_t(imageContainer->m_width), uint16_t(imageContainer->m_height),
-                        uint16_t(imageContainer->m_depth), imageContainer->m_cubeMap, 1 < imageContainer->m_numMips,
-                        imageContainer->m_numLayers, bgfx::TextureFormat::Enum(imageContainer->m_format)
-                );
-            }
+            handle = createTexture(imageContainer, _filePath, _flags, _info, _orientation);
         }
     }
 
@@ -335,7 +358,9 @@ void Group::reset() {
     m_vertices = NULL;
     m_numIndices = 0;
     m_indices = NULL;
+    m_index32 = false;
     m_prims.clear();
+    m_lods.clear();
 }
 
 namespace bgfx {
@@ -343,11 +368,50 @@ namespace bgfx {
 }
 
 void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
+    decode(_reader);
+    upload(_ramcopy);
+}
+
+// Reads an index buffer body, _indexSize is 2 or 4 bytes depending on the chunk version.
+static void *readIndices(bx::ReaderI *_reader, uint32_t _numIndices, uint32_t _indexSize, bool _compressed,
+                         bx::Error *_err) {
+    bx::AllocatorI *allocator = entry::getAllocator();
+
+    void *indices = BX_ALLOC(allocator, _numIndices * _indexSize);
+
+    if (!_compressed) {
+        bx::read(_reader, indices, _numIndices * _indexSize, _err);
+        return indices;
+    }
+
+    uint32_t compressedSize;
+    bx::read(_reader, compressedSize, _err);
+
+    void *compressedIndices = BX_ALLOC(allocator, compressedSize);
+
+    bx::read(_reader, compressedIndices, compressedSize, _err);
+
+    meshopt_decodeIndexBuffer(indices, _numIndices, _indexSize, (uint8_t *) compressedIndices, compressedSize);
+
+    BX_FREE(allocator, compressedIndices);
+
+    return indices;
+}
+
+void Mesh::decode(bx::ReaderSeekerI *_reader) {
     constexpr uint32_t kChunkVertexBuffer = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
     constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
     constexpr uint32_t kChunkIndexBuffer = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
     constexpr uint32_t kChunkIndexBufferCompressed = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
     constexpr uint32_t kChunkPrimitive = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
+    constexpr uint32_t kChunkIndexBufferLod = BX_MAKEFOURCC('I', 'B', 'L', 0x0);
+    constexpr uint32_t kChunkIndexBufferLodCompressed = BX_MAKEFOURCC('I', 'B', 'L', 0x1);
+    constexpr uint32_t kChunkVertexBuffer32 = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+    constexpr uint32_t kChunkVertexBufferCompressed32 = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+    constexpr uint32_t kChunkIndexBuffer32 = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+    constexpr uint32_t kChunkIndexBufferCompressed32 = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
+    constexpr uint32_t kChunkIndexBufferLod32 = BX_MAKEFOURCC('I', 'B', 'L', 0x2);
+    constexpr uint32_t kChunkIndexBufferLodCompressed32 = BX_MAKEFOURCC('I', 'B', 'L', 0x3);
 
     using namespace bx;
     using namespace bgfx;
@@ -361,7 +425,8 @@ void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
     while (4 == bx::read(_reader, chunk, &err)
            && err.isOk()) {
         switch (chunk) {
-            case kChunkVertexBuffer: {
+            case kChunkVertexBuffer:
+            case kChunkVertexBuffer32: {
                 read(_reader, group.m_sphere, &err);
                 read(_reader, group.m_aabb, &err);
                 read(_reader, group.m_obb, &err);
@@ -370,20 +435,22 @@ void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
 
                 uint16_t stride = m_layout.getStride();
 
-                read(_reader, group.m_numVertices, &err);
-                const bgfx::Memory *mem = bgfx::alloc(group.m_numVertices * stride);
-                read(_reader, mem->data, mem->size, &err);
-
-                if (_ramcopy) {
-                    group.m_vertices = (uint8_t *) BX_ALLOC(allocator, group.m_numVertices * stride);
-                    bx::memCopy(group.m_vertices, mem->data, mem->size);
+                group.m_index32 = kChunkVertexBuffer32 == chunk;
+                if (group.m_index32) {
+                    read(_reader, group.m_numVertices, &err);
+                } else {
+                    uint16_t numVertices;
+                    read(_reader, numVertices, &err);
+                    group.m_numVertices = numVertices;
                 }
 
-                group.m_vbh = bgfx::createVertexBuffer(mem, m_layout);
+                group.m_vertices = (uint8_t *) BX_ALLOC(allocator, group.m_numVertices * stride);
+                read(_reader, group.m_vertices, group.m_numVertices * stride, &err);
             }
                 break;
 
-            case kChunkVertexBufferCompressed: {
+            case kChunkVertexBufferCompressed:
+            case kChunkVertexBufferCompressed32: {
                 read(_reader, group.m_sphere, &err);
                 read(_reader, group.m_aabb, &err);
                 read(_reader, group.m_obb, &err);
@@ -392,9 +459,16 @@ void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
 
                 uint16_t stride = m_layout.getStride();
 
-                read(_reader, group.m_numVertices, &err);
+                group.m_index32 = kChunkVertexBufferCompressed32 == chunk;
+                if (group.m_index32) {
+                    read(_reader, group.m_numVertices, &err);
+                } else {
+                    uint16_t numVertices;
+                    read(_reader, numVertices, &err);
+                    group.m_numVertices = numVertices;
+                }
 
-                const bgfx::Memory *mem = bgfx::alloc(group.m_numVertices * stride);
+                group.m_vertices = (uint8_t *) BX_ALLOC(allocator, group.m_numVertices * stride);
 
                 uint32_t compressedSize;
                 bx::read(_reader, compressedSize, &err);
@@ -402,58 +476,41 @@ void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
                 void *compressedVertices = BX_ALLOC(allocator, compressedSize);
                 bx::read(_reader, compressedVertices, compressedSize, &err);
 
-                meshopt_decodeVertexBuffer(mem->data, group.m_numVertices, stride, (uint8_t *) compressedVertices,
-                                           compressedSize);
+                meshopt_decodeVertexBuffer(group.m_vertices, group.m_numVertices, stride,
+                                           (uint8_t *) compressedVertices, compressedSize);
 
                 BX_FREE(allocator, compressedVertices);
-
-                if (_ramcopy) {
-                    group.m_vertices = (uint8_t *) BX_ALLOC(allocator, group.m_numVertices * stride);
-                    bx::memCopy(group.m_vertices, mem->data, mem->size);
-                }
-
-                group.m_vbh = bgfx::createVertexBuffer(mem, m_layout);
             }
                 break;
 
-            case kChunkIndexBuffer: {
-                read(_reader, group.m_numIndices, &err);
+            case kChunkIndexBuffer:
+            case kChunkIndexBuffer32:
+            case kChunkIndexBufferCompressed:
+            case kChunkIndexBufferCompressed32: {
+                const bool index32 = kChunkIndexBuffer32 == chunk || kChunkIndexBufferCompressed32 == chunk;
+                const bool compressed = kChunkIndexBufferCompressed == chunk || kChunkIndexBufferCompressed32 == chunk;
+                BX_ASSERT(index32 == group.m_index32, "Index width does not match the vertex buffer chunk.");
 
-                const bgfx::Memory *mem = bgfx::alloc(group.m_numIndices * 2);
-                read(_reader, mem->data, mem->size, &err);
-
-                if (_ramcopy) {
-                    group.m_indices = (uint16_t *) BX_ALLOC(allocator, group.m_numIndices * 2);
-                    bx::memCopy(group.m_indices, mem->data, mem->size);
-                }
-
-                group.m_ibh = bgfx::createIndexBuffer(mem);
+                read(_reader, group.m_numIndices, &err);
+                group.m_indices = readIndices(_reader, group.m_numIndices, index32 ? 4 : 2, compressed, &err);
             }
                 break;
 
-            case kChunkIndexBufferCompressed: {
-                bx::read(_reader, group.m_numIndices, &err);
-
-                const bgfx::Memory *mem = bgfx::alloc(group.m_numIndices * 2);
-
-                uint32_t compressedSize;
-                bx::read(_reader, compressedSize, &err);
-
-                void *compressedIndices = BX_ALLOC(allocator, compressedSize);
-
-                bx::read(_reader, compressedIndices, compressedSize, &err);
-
-                meshopt_decodeIndexBuffer(mem->data, group.m_numIndices, 2, (uint8_t *) compressedIndices,
-                                          compressedSize);
-
-                BX_FREE(allocator, compressedIndices);
-
-                if (_ramcopy) {
-                    group.m_indices = (uint16_t *) BX_ALLOC(allocator, group.m_numIndices * 2);
-                    bx::memCopy(group.m_indices, mem->data, mem->size);
-                }
-
-                group.m_ibh = bgfx::createIndexBuffer(mem);
+            case kChunkIndexBufferLod:
+            case kChunkIndexBufferLod32:
+            case kChunkIndexBufferLodCompressed:
+            case kChunkIndexBufferLodCompressed32: {
+                const bool index32 = kChunkIndexBufferLod32 == chunk || kChunkIndexBufferLodCompressed32 == chunk;
+                const bool compressed = kChunkIndexBufferLodCompressed == chunk
+                                        || kChunkIndexBufferLodCompressed32 == chunk;
+
+                GroupLod lod;
+                lod.m_ibh.idx = bgfx::kInvalidHandle;
+                read(_reader, lod.m_error, &err);
+                read(_reader, lod.m_numIndices, &err);
+
+                lod.m_indices = readIndices(_reader, lod.m_numIndices, index32 ? 4 : 2, compressed, &err);
+                group.m_lods.push_back(lod);
             }
                 break;
 
@@ -499,12 +556,66 @@ void Mesh::load(bx::ReaderSeekerI *_reader, bool _ramcopy) {
     }
 }
 
+static void meshReleaseCb(void *_ptr, void *_userData) {
+    BX_UNUSED(_userData);
+    BX_FREE(entry::getAllocator(), _ptr);
+}
+
+void Mesh::upload(bool _ramcopy) {
+    const uint16_t stride = m_layout.getStride();
+
+    for (GroupArray::iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it) {
+        Group &group = *it;
+
+        // without a ram copy bgfx takes over the decoded buffers and frees them after upload
+        const uint32_t verticesSize = group.m_numVertices * stride;
+        group.m_vbh = bgfx::createVertexBuffer(
+                _ramcopy
+                ? bgfx::copy(group.m_vertices, verticesSize)
+                : bgfx::makeRef(group.m_vertices, verticesSize, meshReleaseCb), m_layout
+        );
+
+        const uint32_t indexSize = group.m_index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+        const uint16_t indexFlags = group.m_index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE;
+
+        if (NULL != group.m_indices) {
+            const uint32_t indicesSize = group.m_numIndices * indexSize;
+            group.m_ibh = bgfx::createIndexBuffer(
+                    _ramcopy
+                    ? bgfx::copy(group.m_indices, indicesSize)
+                    : bgfx::makeRef(group.m_indices, indicesSize, meshReleaseCb), indexFlags
+            );
+        }
+
+        for (GroupLodArray::iterator lodIt = group.m_lods.begin(), lodEnd = group.m_lods.end();
+             lodIt != lodEnd; ++lodIt) {
+            const uint32_t lodSize = lodIt->m_numIndices * indexSize;
+            lodIt->m_ibh = bgfx::createIndexBuffer(
+                    _ramcopy
+                    ? bgfx::copy(lodIt->m_indices, lodSize)
+                    : bgfx::makeRef(lodIt->m_indices, lodSize, meshReleaseCb), indexFlags
+            );
+
+            if (!_ramcopy) {
+                lodIt->m_indices = NULL;
+            }
+        }
+
+        if (!_ramcopy) {
+            group.m_vertices = NULL;
+            group.m_indices = NULL;
+        }
+    }
+}
+
 void Mesh::unload() {
     bx::AllocatorI *allocator = entry::getAllocator();
 
     for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it) {
         const Group &group = *it;
-        bgfx::destroy(group.m_vbh);
+        if (bgfx::isValid(group.m_vbh)) {
+            bgfx::destroy(group.m_vbh);
+        }
 
         if (bgfx::isValid(group.m_ibh)) {
             bgfx::destroy(group.m_ibh);
@@ -517,6 +628,17 @@ void Mesh::unload() {
         if (NULL != group.m_indices) {
             BX_FREE(allocator, group.m_indices);
         }
+
+        for (GroupLodArray::const_iterator lodIt = group.m_lods.begin(), lodEnd = group.m_lods.end();
+             lodIt != lodEnd; ++lodIt) {
+            if (bgfx::isValid(lodIt->m_ibh)) {
+                bgfx::destroy(lodIt->m_ibh);
+            }
+
+            if (NULL != lodIt->m_indices) {
+                BX_FREE(allocator, lodIt->m_indices);
+            }
+        }
     }
     m_groups.clear();
 }
@@ -586,6 +708,39 @@ void Mesh::submit(const MeshState *const *_state, uint8_t _numPasses, const floa
     bgfx::discard();
 }
 
+void Mesh::submitInstanced(const MeshState *const *_state, uint8_t _numPasses, const float *_mtx,
+                           uint32_t _numInstances) const {
+    bgfx::InstanceDataBuffer idb;
+    const uint32_t numInstances = instanceDataAlloc(&idb, _numInstances);
+    if (0 == numInstances) {
+        return;
+    }
+
+    bx::memCopy(idb.data, _mtx, numInstances * 16 * sizeof(float));
+
+    for (uint32_t pass = 0; pass < _numPasses; ++pass) {
+        const MeshState &state = *_state[pass];
+
+        for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it) {
+            const Group &group = *it;
+
+            bgfx::setState(state.m_state);
+
+            for (uint8_t tex = 0; tex < state.m_numTextures; ++tex) {
+                const MeshState::Texture &texture = state.m_textures[tex];
+                bgfx::setTexture(
+                        texture.m_stage, texture.m_sampler, texture.m_texture, texture.m_flags
+                );
+            }
+
+            bgfx::setInstanceDataBuffer(&idb);
+            bgfx::setIndexBuffer(group.m_ibh);
+            bgfx::setVertexBuffer(0, group.m_vbh);
+            bgfx::submit(state.m_viewId, state.m_program);
+        }
+    }
+}
+
 Mesh *meshLoad(bx::ReaderSeekerI *_reader, bool _ramcopy) {
     Mesh *mesh = new Mesh;
     mesh->load(_reader, _ramcopy);
@@ -617,6 +772,341 @@ void meshStateDestroy(MeshState *_meshState) {
     BX_FREE(entry::getAllocator(), _meshState);
 }
 
+namespace {
+    constexpr uint32_t kMaxAsyncLoadThreads = 8;
+    constexpr uint16_t kMaxAsyncLoads = 64;
+
+    struct AsyncLoadType {
+        enum Enum {
+            Texture,
+            Mesh,
+        };
+    };
+
+    struct AsyncLoad {
+        AsyncLoadType::Enum m_type;
+        AsyncLoadStatus::Enum m_status;
+        char m_filePath[bx::kMaxFilePath];
+        // m_filePath prefixed with entry's current directory, resolved on queue like entry::getFileReader() does
+        char m_fullPath[bx::kMaxFilePath];
+        uint64_t m_flags;
+        bool m_ramcopy;
+
+        // set when the handle is freed while the load is still in flight
+        bool m_cancelled;
+
+        // written by the loader thread, read by asyncLoadUpdate after the load is queued as decoded
+        bimg::ImageContainer *m_imageContainer;
+        Mesh *m_mesh;
+        uint32_t m_hash;
+
+        bgfx::TextureHandle m_texture;
+        bgfx::TextureInfo m_info;
+    };
+
+    // FIFO of load indices, a load is in at most one queue so kMaxAsyncLoads entries never overflow
+    struct AsyncLoadQueue {
+        uint16_t m_idx[kMaxAsyncLoads];
+        uint16_t m_head = 0;
+        uint16_t m_num = 0;
+
+        bool empty() const {
+            return 0 == m_num;
+        }
+
+        void push(uint16_t _idx) {
+            BX_ASSERT(m_num < kMaxAsyncLoads, "Async load queue overflow.");
+            m_idx[(m_head + m_num) % kMaxAsyncLoads] = _idx;
+            ++m_num;
+        }
+
+        uint16_t pop() {
+            BX_ASSERT(0 != m_num, "Async load queue is empty.");
+            const uint16_t idx = m_idx[m_head];
+            m_head = (m_head + 1) % kMaxAsyncLoads;
+            --m_num;
+            return idx;
+        }
+    };
+
+    struct AsyncLoader {
+        AsyncLoad m_loads[kMaxAsyncLoads];
+        bx::HandleAllocT<kMaxAsyncLoads> m_handleAlloc;
+
+        bx::Thread m_threads[kMaxAsyncLoadThreads];
+        uint32_t m_numThreads = 0;
+        bool m_quit = false;
+
+        // m_pending and m_decoded are guarded by m_mutex, m_sem counts m_pending
+        bx::Mutex m_mutex;
+        bx::Semaphore m_sem;
+        AsyncLoadQueue m_pending;
+        AsyncLoadQueue m_decoded;
+    };
+
+    AsyncLoader *s_asyncLoader = NULL;
+
+    void asyncLoadDecode(AsyncLoad &_load) {
+        bx::AllocatorI *allocator = entry::getAllocator();
+
+        // entry::getFileReader() is shared with the main thread, every load opens its own reader on the
+        // path resolved at queue time
+        bx::FileReader reader;
+
+        uint32_t size;
+        void *data = load(&reader, allocator, _load.m_fullPath, &size);
+        if (NULL == data) {
+            return;
+        }
+
+        _load.m_hash = bx::hash<bx::HashMurmur2A>(data, size);
+
+        if (AsyncLoadType::Texture == _load.m_type) {
+            _load.m_imageContainer = bimg::imageParse(allocator, data, size);
+        } else {
+            bx::MemoryReader memoryReader(data, size);
+            _load.m_mesh = new Mesh;
+            _load.m_mesh->decode(&memoryReader);
+        }
+
+        BX_FREE(allocator, data);
+    }
+
+    int32_t asyncLoadThread(bx::Thread *_self, void *_userData) {
+        BX_UNUSED(_self);
+        AsyncLoader &loader = *(AsyncLoader *) _userData;
+
+        for (;;) {
+            loader.m_sem.wait();
+
+            uint16_t idx;
+            bool cancelled;
+            {
+                bx::MutexScope scope(loader.m_mutex);
+                if (loader.m_quit) {
+                    break;
+                }
+
+                idx = loader.m_pending.pop();
+                cancelled = loader.m_loads[idx].m_cancelled;
+            }
+
+            if (!cancelled) {
+                asyncLoadDecode(loader.m_loads[idx]);
+            }
+
+            bx::MutexScope scope(loader.m_mutex);
+            loader.m_decoded.push(idx);
+        }
+
+        return 0;
+    }
+
+    void asyncLoadRelease(AsyncLoad &_load) {
+        if (NULL != _load.m_imageContainer) {
+            bimg::imageFree(_load.m_imageContainer);
+            _load.m_imageContainer = NULL;
+        }
+
+        if (NULL != _load.m_mesh) {
+            meshUnload(_load.m_mesh);
+            _load.m_mesh = NULL;
+        }
+    }
+
+    bool asyncLoadIsAlive(AsyncLoadHandle _handle) {
+        return NULL != s_asyncLoader
+               && _handle.idx < kMaxAsyncLoads
+               && s_asyncLoader->m_handleAlloc.isValid(_handle.idx);
+    }
+
+    AsyncLoadHandle asyncLoadQueue(AsyncLoadType::Enum _type, const char *_filePath, uint64_t _flags, bool _ramcopy) {
+        AsyncLoadHandle handle = {UINT16_MAX};
+        if (NULL == s_asyncLoader) {
+            return handle;
+        }
+
+        AsyncLoader &loader = *s_asyncLoader;
+        handle.idx = loader.m_handleAlloc.alloc();
+        if (UINT16_MAX == handle.idx) {
+            DBG("Too many async loads in flight, can't load %s.", _filePath);
+            return handle;
+        }
+
+        AsyncLoad &load = loader.m_loads[handle.idx];
+        load.m_type = _type;
+        load.m_status = AsyncLoadStatus::Pending;
+        bx::strCopy(load.m_filePath, BX_COUNTOF(load.m_filePath), _filePath);
+        bx::strCopy(load.m_fullPath, BX_COUNTOF(load.m_fullPath), entry::getCurrentDir());
+        bx::strCat(load.m_fullPath, BX_COUNTOF(load.m_fullPath), _filePath);
+        load.m_flags = _flags;
+        load.m_ramcopy = _ramcopy;
+        load.m_cancelled = false;
+        load.m_imageContainer = NULL;
+        load.m_mesh = NULL;
+        load.m_hash = 0;
+        load.m_texture = BGFX_INVALID_HANDLE;
+
+        {
+            bx::MutexScope scope(loader.m_mutex);
+            loader.m_pending.push(handle.idx);
+        }
+        loader.m_sem.post();
+
+        return handle;
+    }
+}
+
+void asyncLoadInit(uint32_t _numThreads) {
+    BX_ASSERT(NULL == s_asyncLoader, "Async loader is already initialized.");
+
+    s_asyncLoader = new AsyncLoader;
+    s_asyncLoader->m_numThreads = bx::clamp<uint32_t>(_numThreads, 1, kMaxAsyncLoadThreads);
+    for (uint32_t ii = 0; ii < s_asyncLoader->m_numThreads; ++ii) {
+        s_asyncLoader->m_threads[ii].init(asyncLoadThread, s_asyncLoader, 0, "async load");
+    }
+}
+
+void asyncLoadShutdown() {
+    if (NULL == s_asyncLoader) {
+        return;
+    }
+
+    AsyncLoader &loader = *s_asyncLoader;
+    {
+        bx::MutexScope scope(loader.m_mutex);
+        loader.m_quit = true;
+    }
+    loader.m_sem.post(loader.m_numThreads);
+
+    for (uint32_t ii = 0; ii < loader.m_numThreads; ++ii) {
+        loader.m_threads[ii].shutdown();
+    }
+
+    // resources of ready loads belong to the caller, only drop what never got uploaded
+    for (uint16_t ii = 0, num = loader.m_handleAlloc.getNumHandles(); ii < num; ++ii) {
+        AsyncLoad &load = loader.m_loads[loader.m_handleAlloc.getHandleAt(ii)];
+        if (AsyncLoadStatus::Ready != load.m_status) {
+            asyncLoadRelease(load);
+        }
+    }
+
+    delete s_asyncLoader;
+    s_asyncLoader = NULL;
+}
+
+uint32_t asyncLoadUpdate(uint32_t _maxUploads) {
+    if (NULL == s_asyncLoader) {
+        return 0;
+    }
+
+    AsyncLoader &loader = *s_asyncLoader;
+
+    uint32_t num = 0;
+    while (num < _maxUploads) {
+        uint16_t idx;
+        {
+            bx::MutexScope scope(loader.m_mutex);
+            if (loader.m_decoded.empty()) {
+                break;
+            }
+
+            idx = loader.m_decoded.pop();
+        }
+
+        AsyncLoad &load = loader.m_loads[idx];
+        if (load.m_cancelled) {
+            asyncLoadRelease(load);
+            loader.m_handleAlloc.free(idx);
+            continue;
+        }
+
+        if (NULL != load.m_imageContainer) {
+            load.m_texture = createTexture(load.m_imageContainer, load.m_filePath, load.m_flags, &load.m_info, NULL);
+            load.m_imageContainer = NULL;
+            load.m_status = bgfx::isValid(load.m_texture) ? AsyncLoadStatus::Ready : AsyncLoadStatus::Failed;
+        } else if (NULL != load.m_mesh && !load.m_mesh->m_groups.empty()) {
+            load.m_mesh->upload(load.m_ramcopy);
+            load.m_status = AsyncLoadStatus::Ready;
+        } else {
+            asyncLoadRelease(load);
+            load.m_status = AsyncLoadStatus::Failed;
+        }
+
+        if (AsyncLoadStatus::Failed == load.m_status) {
+            DBG("Failed to load: %s.", load.m_filePath);
+        }
+
+        ++num;
+    }
+
+    return num;
+}
+
+AsyncLoadHandle loadTextureAsync(const char *_filePath, uint64_t _flags) {
+    return asyncLoadQueue(AsyncLoadType::Texture, _filePath, _flags, false);
+}
+
+AsyncLoadHandle meshLoadAsync(const char *_filePath, bool _ramcopy) {
+    return asyncLoadQueue(AsyncLoadType::Mesh, _filePath, 0, _ramcopy);
+}
+
+AsyncLoadStatus::Enum asyncLoadStatus(AsyncLoadHandle _handle) {
+    if (!asyncLoadIsAlive(_handle)) {
+        return AsyncLoadStatus::Invalid;
+    }
+
+    const AsyncLoad &load = s_asyncLoader->m_loads[_handle.idx];
+    return load.m_cancelled ? AsyncLoadStatus::Invalid : load.m_status;
+}
+
+bgfx::TextureHandle asyncLoadTexture(AsyncLoadHandle _handle, bgfx::TextureHandle _placeholder,
+                                     bgfx::TextureInfo *_info) {
+    if (AsyncLoadStatus::Ready != asyncLoadStatus(_handle)) {
+        return _placeholder;
+    }
+
+    const AsyncLoad &load = s_asyncLoader->m_loads[_handle.idx];
+    if (NULL != _info) {
+        *_info = load.m_info;
+    }
+
+    return load.m_texture;
+}
+
+Mesh *asyncLoadMesh(AsyncLoadHandle _handle, Mesh *_placeholder) {
+    if (AsyncLoadStatus::Ready != asyncLoadStatus(_handle)) {
+        return _placeholder;
+    }
+
+    return s_asyncLoader->m_loads[_handle.idx].m_mesh;
+}
+
+uint32_t asyncLoadHash(AsyncLoadHandle _handle) {
+    if (AsyncLoadStatus::Ready != asyncLoadStatus(_handle)) {
+        return 0;
+    }
+
+    return s_asyncLoader->m_loads[_handle.idx].m_hash;
+}
+
+void asyncLoadFree(AsyncLoadHandle _handle) {
+    if (!asyncLoadIsAlive(_handle)) {
+        return;
+    }
+
+    AsyncLoader &loader = *s_asyncLoader;
+    AsyncLoad &load = loader.m_loads[_handle.idx];
+    if (AsyncLoadStatus::Pending == load.m_status) {
+        // the loader thread still owns the slot, asyncLoadUpdate frees it once the decode finished
+        bx::MutexScope scope(loader.m_mutex);
+        load.m_cancelled = true;
+        return;
+    }
+
+    loader.m_handleAlloc.free(_handle.idx);
+}
+
 void meshSubmit(const Mesh *_mesh, bgfx::ViewId _id, bgfx::ProgramHandle _program, const float *_mtx, uint64_t _state) {
     _mesh->submit(_id, _program, _mtx, _state);
 }
@@ -626,6 +1116,26 @@ void meshSubmit(const Mesh *_mesh, const MeshState *const *_state, uint8_t _numP
     _mesh->submit(_state, _numPasses, _mtx, _numMatrices);
 }
 
+void meshSubmitInstanced(const Mesh *_mesh, const MeshState *const *_state, uint8_t _numPasses, const float *_mtx,
+                         uint32_t _numInstances) {
+    _mesh->submitInstanced(_state, _numPasses, _mtx, _numInstances);
+}
+
+uint32_t instanceDataAlloc(bgfx::InstanceDataBuffer *_idb, uint32_t _num) {
+    if (0 == (bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING)) {
+        return 0;
+    }
+
+    const uint16_t stride = 16 * sizeof(float);
+    const uint32_t num = bgfx::getAvailInstanceDataBuffer(_num, stride);
+    if (0 == num) {
+        return 0;
+    }
+
+    bgfx::allocInstanceDataBuffer(_idb, num, stride);
+    return num;
+}
+
 struct RendererTypeRemap {
     bx::StringView name;
     bgfx::RendererType::Enum type;
@@ -690,6 +1200,11 @@ Args::Args(int _argc, const char *const *_argv)
         }
     }
 
+#if ENTRY_CONFIG_USE_NOOP
+    // headless builds have no window to present to
+    m_type = bgfx::RendererType::Noop;
+#endif // ENTRY_CONFIG_USE_NOOP
+
     if (cmdLine.hasArg("amd")) {
         m_pciId = BGFX_PCI_ID_AMD;
     } else if (cmdLine.hasArg("nvidia")) {
@@ -99,6 +99,19 @@ struct Primitive
 
 typedef stl::vector<Primitive> PrimitiveArray;
 
+/// Simplified index buffer over the vertices of its group, _error is the absolute
+/// geometric error in mesh units, written by geometryc --lod. Index width is the
+/// same as the group's.
+struct GroupLod
+{
+	float m_error;
+	bgfx::IndexBufferHandle m_ibh;
+	uint32_t m_numIndices;
+	void* m_indices;
+};
+
+typedef stl::vector<GroupLod> GroupLodArray;
+
 struct Group
 {
 	Group();
@@ -106,23 +119,28 @@ struct Group
 
 	bgfx::VertexBufferHandle m_vbh;
 	bgfx::IndexBufferHandle m_ibh;
-	uint16_t m_numVertices;
+	uint32_t m_numVertices;
 	uint8_t* m_vertices;
 	uint32_t m_numIndices;
-	uint16_t* m_indices;
+	void* m_indices;
+	bool m_index32; //!< Indices are uint32_t, set for groups with more than 65535 vertices.
 	bx::Sphere m_sphere;
 	bx::Aabb   m_aabb;
 	bx::Obb    m_obb;
 	PrimitiveArray m_prims;
+	GroupLodArray m_lods;
 };
 typedef stl::vector<Group> GroupArray;
 
 struct Mesh
 {
 	void load(bx::ReaderSeekerI* _reader, bool _ramcopy);
+	void decode(bx::ReaderSeekerI* _reader);
+	void upload(bool _ramcopy);
 	void unload();
 	void submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state) const;
 	void submit(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices) const;
+	void submitInstanced(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint32_t _numInstances) const;
 
 	bgfx::VertexLayout m_layout;
 	GroupArray m_groups;
@@ -146,6 +164,67 @@ void meshSubmit(const Mesh* _mesh, bgfx::ViewId _id, bgfx::ProgramHandle _progra
 ///
 void meshSubmit(const Mesh* _mesh, const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices = 1);
 
+/// Submit _numInstances copies of the mesh with one draw per group and pass. Model matrices are
+/// passed as instance data (i_data0..3), so _state programs must use an instanced vertex shader.
+/// Instances that don't fit into the transient instance data buffer are dropped.
+void meshSubmitInstanced(const Mesh* _mesh, const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint32_t _numInstances);
+
+/// Allocate instance data for up to _num model matrices, returns the number of instances allocated,
+/// 0 when instancing is not supported or the transient instance data buffer is full.
+uint32_t instanceDataAlloc(bgfx::InstanceDataBuffer* _idb, uint32_t _num);
+
+///
+struct AsyncLoadHandle { uint16_t idx; };
+
+///
+inline bool isValid(AsyncLoadHandle _handle) { return UINT16_MAX != _handle.idx; }
+
+///
+struct AsyncLoadStatus
+{
+	enum Enum
+	{
+		Invalid, //!< Handle is not (or no longer) valid.
+		Pending, //!< File is being read and decoded, or waits for asyncLoadUpdate to upload it.
+		Ready,   //!< Resource is created, it belongs to the caller from now on.
+		Failed,  //!< File couldn't be opened or decoded.
+
+		Count
+	};
+};
+
+/// Start the background threads that read and decode async loads.
+void asyncLoadInit(uint32_t _numThreads = 2);
+
+/// Stop the background threads. Pending loads are dropped, resources of ready loads are kept.
+void asyncLoadShutdown();
+
+/// Create the bgfx resources of loads whose decode finished. Call once per frame from the thread
+/// that owns the bgfx API, returns the number of loads that became ready or failed.
+uint32_t asyncLoadUpdate(uint32_t _maxUploads = UINT32_MAX);
+
+/// Queue a texture load, file I/O and image parsing happen on a loader thread.
+AsyncLoadHandle loadTextureAsync(const char* _filePath, uint64_t _flags = BGFX_TEXTURE_NONE|BGFX_SAMPLER_NONE);
+
+/// Queue a mesh load, file I/O and meshopt decoding happen on a loader thread.
+AsyncLoadHandle meshLoadAsync(const char* _filePath, bool _ramcopy = false);
+
+///
+AsyncLoadStatus::Enum asyncLoadStatus(AsyncLoadHandle _handle);
+
+/// Loaded texture, or _placeholder until the load is ready. _info is only written once ready.
+bgfx::TextureHandle asyncLoadTexture(AsyncLoadHandle _handle, bgfx::TextureHandle _placeholder, bgfx::TextureInfo* _info = NULL);
+
+/// Loaded mesh, or _placeholder until the load is ready.
+Mesh* asyncLoadMesh(AsyncLoadHandle _handle, Mesh* _placeholder);
+
+/// Hash of the loaded file contents, 0 until the load is ready.
+uint32_t asyncLoadHash(AsyncLoadHandle _handle);
+
+/// Free the handle. A load that is still pending is cancelled, the resource of a ready load is
+/// not destroyed.
+void asyncLoadFree(AsyncLoadHandle _handle);
+
 /// bgfx::RendererType::Enum to name.
 bx::StringView getName(bgfx::RendererType::Enum _type);
 
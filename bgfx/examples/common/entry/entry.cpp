@@ -4,8 +4,10 @@
  */
 
 #include <bx/bx.h>
+#include <bx/commandline.h>
 #include <bx/file.h>
 #include <bx/sort.h>
+#include <bx/timer.h>
 #include <bgfx/bgfx.h>
 
 #include <time.h>
@@ -69,6 +71,11 @@ namespace entry
 		s_currentDir.set(_dir);
 	}
 
+	const char* getCurrentDir()
+	{
+		return s_currentDir.getPtr();
+	}
+
 #if ENTRY_CONFIG_IMPLEMENT_DEFAULT_ALLOCATOR
 	bx::AllocatorI* getDefaultAllocator()
 	{
@@ -508,6 +515,145 @@ BX_PRAGMA_DIAGNOSTIC_POP();
 		return s_numApps;
 	}
 
+	/// Runs the app for a fixed number of frames and writes per frame stats, enabled with
+	/// `--bench <frames>`. Stats go to `--bench-out <file>`, as JSON when the file name ends
+	/// with `.json` and as CSV otherwise, or as CSV to stdout when no file is given.
+	struct Benchmark
+	{
+		Benchmark()
+			: m_numFrames(0)
+			, m_frame(0)
+			, m_writer(NULL)
+			, m_json(false)
+		{
+		}
+
+		bool init(int _argc, const char* const* _argv)
+		{
+			bx::CommandLine cmdLine(_argc, _argv);
+
+			if (!cmdLine.hasArg(m_numFrames, '\0', "bench")
+			||  0 == m_numFrames)
+			{
+				return false;
+			}
+
+			const char* filePath = cmdLine.findOption("bench-out");
+			if (NULL == filePath)
+			{
+				m_writer = bx::getStdOut();
+			}
+			else if (bx::open(&m_fileWriter, filePath) )
+			{
+				m_writer = &m_fileWriter;
+				m_json   = bx::hasSuffix(filePath, ".json");
+			}
+			else
+			{
+				DBG("Failed to open benchmark output %s.", filePath);
+				m_writer = bx::getStdOut();
+			}
+
+			bx::Error err;
+			if (m_json)
+			{
+				bx::write(m_writer, &err, "{\n\t\"renderer\": \"%s\",\n\t\"frames\": [\n"
+					, bgfx::getRendererName(bgfx::getRendererType() )
+					);
+			}
+			else
+			{
+				bx::write(m_writer, &err
+					, "frame,submitMs,frameMs,renderMs,sortMs,waitRenderMs,waitSubmitMs"
+					  ",numDraw,numCompute,numBlit,transientVbUsed,transientIbUsed,numEncoders,encoderMs"
+					  ",submitLatencyMs,numFramesInFlight,maxFramesInFlight,uniformBytesSkipped,uniformBytesUploaded\n"
+					);
+			}
+
+			return true;
+		}
+
+		/// Records one frame, `_submitTime` is the CPU time spent in `AppI::update`. Returns
+		/// false once all frames are recorded.
+		bool frame(int64_t _submitTime)
+		{
+			const bgfx::Stats* stats = bgfx::getStats();
+			const double toMs = 1000.0/double(stats->cpuTimerFreq);
+
+			int64_t encoderTime = 0;
+			for (uint16_t ii = 0; ii < stats->numEncoders; ++ii)
+			{
+				const bgfx::EncoderStats& encoderStats = stats->encoderStats[ii];
+				encoderTime += encoderStats.cpuTimeEnd - encoderStats.cpuTimeBegin;
+			}
+
+			const char* format = m_json
+				? "\t\t{ \"frame\": %u, \"submitMs\": %f, \"frameMs\": %f, \"renderMs\": %f, \"sortMs\": %f"
+				  ", \"waitRenderMs\": %f, \"waitSubmitMs\": %f, \"numDraw\": %u, \"numCompute\": %u"
+				  ", \"numBlit\": %u, \"transientVbUsed\": %d, \"transientIbUsed\": %d"
+				  ", \"numEncoders\": %u, \"encoderMs\": %f, \"submitLatencyMs\": %f"
+				  ", \"numFramesInFlight\": %u, \"maxFramesInFlight\": %u, \"uniformBytesSkipped\": %u, \"uniformBytesUploaded\": %u }%s\n"
+				: "%u,%f,%f,%f,%f,%f,%f,%u,%u,%u,%d,%d,%u,%f,%f,%u,%u,%u,%u%s\n"
+				;
+
+			const bool last = m_frame + 1 == m_numFrames;
+
+			bx::Error err;
+			bx::write(m_writer, &err, format
+				, m_frame
+				, double(_submitTime)*1000.0/double(bx::getHPFrequency() )
+				, double(stats->cpuTimeFrame)*toMs
+				, double(stats->cpuTimeEnd - stats->cpuTimeBegin)*toMs
+				, double(stats->cpuTimeSort)*toMs
+				, double(stats->waitRender)*toMs
+				, double(stats->waitSubmit)*toMs
+				, stats->numDraw
+				, stats->numCompute
+				, stats->numBlit
+				, stats->transientVbUsed
+				, stats->transientIbUsed
+				, uint32_t(stats->numEncoders)
+				, double(encoderTime)*toMs
+				, double(stats->submitLatency)*toMs
+				, stats->numFramesInFlight
+				, stats->maxFramesInFlight
+				, stats->uniformBytesSkipped
+				, stats->uniformBytesUploaded
+				, m_json && !last ? "," : ""
+				);
+
+			++m_frame;
+			return !last;
+		}
+
+		void shutdown()
+		{
+			if (NULL == m_writer)
+			{
+				return;
+			}
+
+			if (m_json)
+			{
+				bx::Error err;
+				bx::write(m_writer, &err, "\t]\n}\n");
+			}
+
+			if (&m_fileWriter == m_writer)
+			{
+				bx::close(&m_fileWriter);
+			}
+
+			m_writer = NULL;
+		}
+
+		uint32_t       m_numFrames;
+		uint32_t       m_frame;
+		bx::FileWriter m_fileWriter;
+		bx::WriterI*   m_writer;
+		bool           m_json;
+	};
+
 	int runApp(AppI* _app, int _argc, const char* const* _argv)
 	{
 		_app->init(_argc, _argv, s_width, s_height);
@@ -516,12 +662,28 @@ BX_PRAGMA_DIAGNOSTIC_POP();
 		WindowHandle defaultWindow = { 0 };
 		setWindowSize(defaultWindow, s_width, s_height);
 
+		Benchmark benchmark;
+		const bool bench = benchmark.init(_argc, _argv);
+
 #if BX_PLATFORM_EMSCRIPTEN
+		BX_UNUSED(bench);
 		s_app = _app;
 		emscripten_set_main_loop(&updateApp, -1, 1);
 #else
-		while (_app->update() )
+		for (;;)
 		{
+			const int64_t updateBegin = bx::getHPCounter();
+			if (!_app->update() )
+			{
+				break;
+			}
+
+			if (bench
+			&&  !benchmark.frame(bx::getHPCounter() - updateBegin) )
+			{
+				break;
+			}
+
 			if (0 != bx::strLen(s_restartArgs) )
 			{
 				break;
@@ -529,6 +691,8 @@ BX_PRAGMA_DIAGNOSTIC_POP();
 		}
 #endif // BX_PLATFORM_EMSCRIPTEN
 
+		benchmark.shutdown();
+
 		return _app->shutdown();
 	}
 
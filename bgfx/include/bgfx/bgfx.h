@@ -404,6 +404,7 @@ namespace bgfx
 	BGFX_HANDLE(ShaderHandle)
 	BGFX_HANDLE(TextureHandle)
 	BGFX_HANDLE(UniformHandle)
+	BGFX_HANDLE(UniformBlockHandle)
 	BGFX_HANDLE(VertexBufferHandle)
 	BGFX_HANDLE(VertexLayoutHandle)
 
@@ -686,6 +687,11 @@ namespace bgfx
 			uint32_t minResourceCbSize; //!< Minimum resource command buffer size.
 			uint32_t transientVbSize;   //!< Maximum transient vertex buffer size.
 			uint32_t transientIbSize;   //!< Maximum transient index buffer size.
+			uint32_t maxDrawCalls;      //!< Maximum number of draw and compute calls per frame.
+			uint32_t maxMatrixCache;    //!< Maximum number of transform matrices per frame.
+			uint32_t maxRectCache;      //!< Maximum number of scissor rectangles per frame.
+			uint8_t  maxFramesInFlight; //!< Number of frames shared by API and render thread (2-3),
+			                            //!  API thread runs ahead by one less. Init only.
 		};
 
 		Limits limits; //!< Configurable runtime limits.
@@ -974,11 +980,17 @@ namespace bgfx
 		int64_t waitRender;                 //!< Time spent waiting for render backend thread to finish issuing
 		                                    //!  draw commands to underlying graphics API.
 		int64_t waitSubmit;                 //!< Time spent waiting for submit thread to advance to next frame.
+		int64_t submitLatency;              //!< Time from `bgfx::frame` submitting frame until render thread
+		                                    //!  started processing it.
+		int64_t cpuTimeSort;                //!< Render thread CPU time spent sorting submitted calls.
 
 		uint32_t numDraw;                   //!< Number of draw calls submitted.
 		uint32_t numCompute;                //!< Number of compute calls submitted.
 		uint32_t numBlit;                   //!< Number of blit calls submitted.
 		uint32_t maxGpuLatency;             //!< GPU driver latency.
+		uint32_t numFramesInFlight;         //!< Number of submitted frames render thread didn't finish yet,
+		                                    //!  including last one submitted by `bgfx::frame`.
+		uint32_t maxFramesInFlight;         //!< Number of frames shared by API and render thread.
 
 		uint16_t numDynamicIndexBuffers;    //!< Number of used dynamic index buffers.
 		uint16_t numDynamicVertexBuffers;   //!< Number of used dynamic vertex buffers.
@@ -996,6 +1008,9 @@ namespace bgfx
 		int64_t rtMemoryUsed;               //!< Estimate of render target memory used.
 		int32_t transientVbUsed;            //!< Amount of transient vertex buffer used.
 		int32_t transientIbUsed;            //!< Amount of transient index buffer used.
+		uint32_t uniformBytesSkipped;       //!< Amount of uniform data encoders didn't copy, or render thread
+		                                    //!  didn't update, because it was unchanged.
+		uint32_t uniformBytesUploaded;      //!< Amount of uniform data render thread updated.
 
 		uint32_t numPrims[Topology::Count]; //!< Number of primitives rendered.
 
@@ -1170,6 +1185,19 @@ namespace bgfx
 			, uint16_t _num = 1
 			);
 
+		/// Set uniform block for draw primitive.
+		///
+		/// @param[in] _stage Uniform block stage, `_reg` of `UNIFORM_BLOCK_BEGIN`
+		///   in shader. Shares stages with textures and buffers.
+		/// @param[in] _handle Uniform block.
+		///
+		/// @attention C99 equivalent is `bgfx_encoder_set_uniform_block`.
+		///
+		void setUniformBlock(
+			  uint8_t _stage
+			, UniformBlockHandle _handle
+			);
+
 		/// Set index buffer for draw primitive.
 		///
 		/// @param[in] _handle Index buffer.
@@ -1991,6 +2019,9 @@ namespace bgfx
 	///     frame. This flag only has effect when `BGFX_CONFIG_MULTITHREADED=0`.
 	///   - `BGFX_RESET_SRGB_BACKBUFFER` - Enable sRGB backbuffer.
 	/// @param[in] _format Texture format. See: `TextureFormat::Enum`.
+	/// @param[in] _limits When not NULL, per frame capacity (`maxDrawCalls`,
+	///   `maxMatrixCache` and `maxRectCache`) is resized to these limits, other
+	///   fields are ignored. Frames are resized when they are next submitted to.
 	///
 	/// @attention This call doesn't actually change window size, it just
 	///   resizes back-buffer. Windowing code has to change window size.
@@ -2002,6 +2033,7 @@ namespace bgfx
 		, uint32_t _height
 		, uint32_t _flags = BGFX_RESET_NONE
 		, TextureFormat::Enum _format = TextureFormat::Count
+		, const Init::Limits* _limits = NULL
 		);
 
 	/// Begin submitting draw calls from thread.
@@ -3204,6 +3236,62 @@ namespace bgfx
 	///
 	void destroy(UniformHandle _handle);
 
+	/// Create uniform block. Block holds values of member uniforms in a GPU
+	/// buffer which is updated once and bound to many draw calls, instead of
+	/// setting the same uniforms for each draw call.
+	///
+	/// @param[in] _uniforms Member uniforms, in the same order they are declared
+	///   between `UNIFORM_BLOCK_BEGIN` and `UNIFORM_BLOCK_END` in shader.
+	/// @param[in] _num Number of member uniforms.
+	///
+	/// @returns Handle to uniform block object.
+	///
+	/// @remarks
+	///   1. Members are laid out with std140 rules, only `UniformType::Vec4`,
+	///      `UniformType::Mat3` and `UniformType::Mat4` uniforms can be members,
+	///      and uniform can be member of only one block.
+	///
+	///   2. Shaders compiled for SPIR-V, GLSL 420+ and ESSL 310+ read block from
+	///      GPU buffer. For other shader profiles, HLSL for Direct3D and Metal
+	///      included, members are declared as regular uniforms, and are set from
+	///      block data for each draw call block is bound to.
+	///
+	/// @attention C99 equivalent is `bgfx_create_uniform_block`.
+	///
+	UniformBlockHandle createUniformBlock(
+		  const UniformHandle* _uniforms
+		, uint16_t _num
+		);
+
+	/// Update uniform block member.
+	///
+	/// @param[in] _handle Handle to uniform block object.
+	/// @param[in] _uniform Member uniform.
+	/// @param[in] _value Pointer to uniform data.
+	/// @param[in] _num Number of elements. Passing `UINT16_MAX` will
+	///   use the _num passed on uniform creation.
+	///
+	/// @remarks
+	///   Block is uploaded to GPU once per frame, on `bgfx::frame`. Update it
+	///   before submitting draw calls which use it.
+	///
+	/// @attention C99 equivalent is `bgfx_update_uniform_block`.
+	///
+	void updateUniformBlock(
+		  UniformBlockHandle _handle
+		, UniformHandle _uniform
+		, const void* _value
+		, uint16_t _num = 1
+		);
+
+	/// Destroy uniform block.
+	///
+	/// @param[in] _handle Handle to uniform block object.
+	///
+	/// @attention C99 equivalent is `bgfx_destroy_uniform_block`.
+	///
+	void destroy(UniformBlockHandle _handle);
+
 	/// Create occlusion query.
 	///
 	/// @returns Handle to occlusion query object.
@@ -3621,6 +3709,19 @@ namespace bgfx
 		, uint16_t _num = 1
 		);
 
+	/// Set uniform block for draw primitive.
+	///
+	/// @param[in] _stage Uniform block stage, `_reg` of `UNIFORM_BLOCK_BEGIN`
+	///   in shader. Shares stages with textures and buffers.
+	/// @param[in] _handle Uniform block.
+	///
+	/// @attention C99 equivalent is `bgfx_set_uniform_block`.
+	///
+	void setUniformBlock(
+		  uint8_t _stage
+		, UniformBlockHandle _handle
+		);
+
 	/// Set index buffer for draw primitive.
 	///
 	/// @param[in] _handle Index buffer.
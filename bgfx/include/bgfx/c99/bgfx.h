@@ -460,6 +460,7 @@ typedef struct bgfx_shader_handle_s { uint16_t idx; } bgfx_shader_handle_t;
 typedef struct bgfx_texture_handle_s { uint16_t idx; } bgfx_texture_handle_t;
 
 typedef struct bgfx_uniform_handle_s { uint16_t idx; } bgfx_uniform_handle_t;
+typedef struct bgfx_uniform_block_handle_s { uint16_t idx; } bgfx_uniform_block_handle_t;
 
 typedef struct bgfx_vertex_buffer_handle_s { uint16_t idx; } bgfx_vertex_buffer_handle_t;
 
@@ -636,6 +637,10 @@ typedef struct bgfx_init_limits_s
     uint32_t             minResourceCbSize;  /** Minimum resource command buffer size.    */
     uint32_t             transientVbSize;    /** Maximum transient vertex buffer size.    */
     uint32_t             transientIbSize;    /** Maximum transient index buffer size.     */
+    uint32_t             maxDrawCalls;       /** Maximum number of draw and compute calls per frame. */
+    uint32_t             maxMatrixCache;     /** Maximum number of transform matrices per frame. */
+    uint32_t             maxRectCache;       /** Maximum number of scissor rectangles per frame. */
+    uint8_t              maxFramesInFlight;  /** Number of frames shared by API and render thread (2-3), API thread runs ahead by one less. Init only. */
 
 } bgfx_init_limits_t;
 
@@ -846,10 +851,14 @@ typedef struct bgfx_stats_s
     int64_t              gpuTimerFreq;       /** GPU timer frequency.                     */
     int64_t              waitRender;         /** Time spent waiting for render backend thread to finish issuing draw commands to underlying graphics API. */
     int64_t              waitSubmit;         /** Time spent waiting for submit thread to advance to next frame. */
+    int64_t              submitLatency;      /** Time from `bgfx::frame` submitting frame until render thread started processing it. */
+    int64_t              cpuTimeSort;        /** Render thread CPU time spent sorting submitted calls. */
     uint32_t             numDraw;            /** Number of draw calls submitted.          */
     uint32_t             numCompute;         /** Number of compute calls submitted.       */
     uint32_t             numBlit;            /** Number of blit calls submitted.          */
     uint32_t             maxGpuLatency;      /** GPU driver latency.                      */
+    uint32_t             numFramesInFlight;  /** Number of submitted frames render thread didn't finish yet, including last one submitted by `bgfx::frame`. */
+    uint32_t             maxFramesInFlight;  /** Number of frames shared by API and render thread. */
     uint16_t             numDynamicIndexBuffers; /** Number of used dynamic index buffers.    */
     uint16_t             numDynamicVertexBuffers; /** Number of used dynamic vertex buffers.   */
     uint16_t             numFrameBuffers;    /** Number of used frame buffers.            */
@@ -865,6 +874,8 @@ typedef struct bgfx_stats_s
     int64_t              rtMemoryUsed;       /** Estimate of render target memory used.   */
     int32_t              transientVbUsed;    /** Amount of transient vertex buffer used.  */
     int32_t              transientIbUsed;    /** Amount of transient index buffer used.   */
+    uint32_t             uniformBytesSkipped; /** Amount of uniform data encoders didn't copy, or render thread didn't update, because it was unchanged. */
+    uint32_t             uniformBytesUploaded; /** Amount of uniform data render thread updated. */
     uint32_t             numPrims[BGFX_TOPOLOGY_COUNT]; /** Number of primitives rendered.           */
     int64_t              gpuMemoryMax;       /** Maximum available GPU memory for application. */
     int64_t              gpuMemoryUsed;      /** Amount of GPU memory used by the application. */
@@ -2127,6 +2138,40 @@ BGFX_C_API void bgfx_get_uniform_info(bgfx_uniform_handle_t _handle, bgfx_unifor
  */
 BGFX_C_API void bgfx_destroy_uniform(bgfx_uniform_handle_t _handle);
 
+/**
+ * Create uniform block. Block holds values of member uniforms in a GPU
+ * buffer which is updated once and bound to many draw calls, instead of
+ * setting the same uniforms for each draw call.
+ *
+ * @param[in] _uniforms Member uniforms, in the same order they are declared
+ *  between `UNIFORM_BLOCK_BEGIN` and `UNIFORM_BLOCK_END` in shader.
+ * @param[in] _num Number of member uniforms.
+ *
+ * @returns Handle to uniform block object.
+ *
+ */
+BGFX_C_API bgfx_uniform_block_handle_t bgfx_create_uniform_block(const bgfx_uniform_handle_t * _uniforms, uint16_t _num);
+
+/**
+ * Update uniform block member.
+ *
+ * @param[in] _handle Handle to uniform block object.
+ * @param[in] _uniform Member uniform.
+ * @param[in] _value Pointer to uniform data.
+ * @param[in] _num Number of elements. Passing `UINT16_MAX` will
+ *  use the _num passed on uniform creation.
+ *
+ */
+BGFX_C_API void bgfx_update_uniform_block(bgfx_uniform_block_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num);
+
+/**
+ * Destroy uniform block.
+ *
+ * @param[in] _handle Handle to uniform block object.
+ *
+ */
+BGFX_C_API void bgfx_destroy_uniform_block(bgfx_uniform_block_handle_t _handle);
+
 /**
  * Create occlusion query.
  *
@@ -2457,6 +2502,16 @@ BGFX_C_API uint32_t bgfx_encoder_alloc_transform(bgfx_encoder_t* _this, bgfx_tra
  */
 BGFX_C_API void bgfx_encoder_set_uniform(bgfx_encoder_t* _this, bgfx_uniform_handle_t _handle, const void* _value, uint16_t _num);
 
+/**
+ * Set uniform block for draw primitive.
+ *
+ * @param[in] _stage Uniform block stage, `_reg` of `UNIFORM_BLOCK_BEGIN`
+ *  in shader. Shares stages with textures and buffers.
+ * @param[in] _handle Uniform block.
+ *
+ */
+BGFX_C_API void bgfx_encoder_set_uniform_block(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_block_handle_t _handle);
+
 /**
  * Set index buffer for draw primitive.
  *
@@ -3008,6 +3063,16 @@ BGFX_C_API uint32_t bgfx_alloc_transform(bgfx_transform_t* _transform, uint16_t
  */
 BGFX_C_API void bgfx_set_uniform(bgfx_uniform_handle_t _handle, const void* _value, uint16_t _num);
 
+/**
+ * Set uniform block for draw primitive.
+ *
+ * @param[in] _stage Uniform block stage, `_reg` of `UNIFORM_BLOCK_BEGIN`
+ *  in shader. Shares stages with textures and buffers.
+ * @param[in] _handle Uniform block.
+ *
+ */
+BGFX_C_API void bgfx_set_uniform_block(uint8_t _stage, bgfx_uniform_block_handle_t _handle);
+
 /**
  * Set index buffer for draw primitive.
  *
@@ -3646,6 +3711,9 @@ struct bgfx_interface_vtbl
     bgfx_uniform_handle_t (*create_uniform)(const char* _name, bgfx_uniform_type_t _type, uint16_t _num);
     void (*get_uniform_info)(bgfx_uniform_handle_t _handle, bgfx_uniform_info_t * _info);
     void (*destroy_uniform)(bgfx_uniform_handle_t _handle);
+    bgfx_uniform_block_handle_t (*create_uniform_block)(const bgfx_uniform_handle_t * _uniforms, uint16_t _num);
+    void (*update_uniform_block)(bgfx_uniform_block_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num);
+    void (*destroy_uniform_block)(bgfx_uniform_block_handle_t _handle);
     bgfx_occlusion_query_handle_t (*create_occlusion_query)(void);
     bgfx_occlusion_query_result_t (*get_result)(bgfx_occlusion_query_handle_t _handle, int32_t* _result);
     void (*destroy_occlusion_query)(bgfx_occlusion_query_handle_t _handle);
@@ -3674,6 +3742,7 @@ struct bgfx_interface_vtbl
     void (*encoder_set_transform_cached)(bgfx_encoder_t* _this, uint32_t _cache, uint16_t _num);
     uint32_t (*encoder_alloc_transform)(bgfx_encoder_t* _this, bgfx_transform_t* _transform, uint16_t _num);
     void (*encoder_set_uniform)(bgfx_encoder_t* _this, bgfx_uniform_handle_t _handle, const void* _value, uint16_t _num);
+    void (*encoder_set_uniform_block)(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_block_handle_t _handle);
     void (*encoder_set_index_buffer)(bgfx_encoder_t* _this, bgfx_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices);
     void (*encoder_set_dynamic_index_buffer)(bgfx_encoder_t* _this, bgfx_dynamic_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices);
     void (*encoder_set_transient_index_buffer)(bgfx_encoder_t* _this, const bgfx_transient_index_buffer_t* _tib, uint32_t _firstIndex, uint32_t _numIndices);
@@ -3719,6 +3788,7 @@ struct bgfx_interface_vtbl
     void (*set_transform_cached)(uint32_t _cache, uint16_t _num);
     uint32_t (*alloc_transform)(bgfx_transform_t* _transform, uint16_t _num);
     void (*set_uniform)(bgfx_uniform_handle_t _handle, const void* _value, uint16_t _num);
+    void (*set_uniform_block)(uint8_t _stage, bgfx_uniform_block_handle_t _handle);
     void (*set_index_buffer)(bgfx_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices);
     void (*set_dynamic_index_buffer)(bgfx_dynamic_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices);
     void (*set_transient_index_buffer)(const bgfx_transient_index_buffer_t* _tib, uint32_t _firstIndex, uint32_t _numIndices);
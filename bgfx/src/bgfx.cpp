@@ -1211,6 +1211,96 @@ namespace bgfx
 		}
 	}
 
+	void EncoderImpl::expandUniformBlocks(ProgramHandle _program)
+	{
+		if (0 == m_uniformBlockStages
+		||  !isValid(_program) )
+		{
+			return;
+		}
+
+		uint16_t buffers[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
+		uint32_t numBuffers = 0;
+
+		for (uint32_t stage = 0, stageMask = m_uniformBlockStages
+			; 0 != stageMask
+			; stageMask >>= 1, stage += 1
+			)
+		{
+			const uint32_t ntz = bx::uint32_cnttz(stageMask);
+			stageMask >>= ntz;
+			stage     += ntz;
+
+			// the stage could have been rebound to a texture or buffer since
+			const Binding& bind = m_bind.m_bind[stage];
+			if (Binding::UniformBuffer == bind.m_type
+			&&  kInvalidHandle != bind.m_idx)
+			{
+				buffers[numBuffers++] = bind.m_idx;
+			}
+		}
+
+		if (0 == numBuffers)
+		{
+			return;
+		}
+
+		// Shaders compiled without uniform block support list block members as
+		// regular uniforms, set them from bound block.
+		const ProgramRef& program = s_ctx->m_programRef[_program.idx];
+		const ShaderHandle shaders[] = { program.m_vsh, program.m_fsh };
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(shaders); ++ii)
+		{
+			if (!isValid(shaders[ii]) )
+			{
+				continue;
+			}
+
+			const ShaderRef& shader = s_ctx->m_shaderRef[shaders[ii].idx];
+			for (uint16_t jj = 0; jj < shader.m_num; ++jj)
+			{
+				const UniformHandle handle = shader.m_uniforms[jj];
+				const UniformRef& uniform = s_ctx->m_uniformRef[handle.idx];
+
+				if (!isValid(uniform.m_block) )
+				{
+					continue;
+				}
+
+				const UniformBlockRef& block = s_ctx->m_uniformBlockRef[uniform.m_block.idx];
+
+				bool bound = false;
+				for (uint32_t kk = 0; kk < numBuffers && !bound; ++kk)
+				{
+					bound = block.m_buffer.idx == buffers[kk];
+				}
+
+				if (!bound)
+				{
+					continue;
+				}
+
+				const uint8_t* data = &block.m_data[uniform.m_blockOffset];
+
+				if (UniformType::Mat3 == uniform.m_type)
+				{
+					float* mtx = (float*)alloca(uniform.m_num*9*sizeof(float) );
+					for (uint32_t col = 0, num = uniform.m_num*3; col < num; ++col)
+					{
+						bx::memCopy(&mtx[col*3], &data[col*16], 3*sizeof(float) );
+					}
+
+					writeUniform(uniform.m_type, handle, mtx, uniform.m_num);
+				}
+				else
+				{
+					writeUniform(uniform.m_type, handle, data, uniform.m_num);
+				}
+			}
+		}
+	}
+
 	void EncoderImpl::submit(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32_t _depth, uint8_t _flags)
 	{
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM)
@@ -1243,8 +1333,9 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
-		if (BGFX_CONFIG_MAX_DRAW_CALLS <= renderItemIdx)
+		const uint32_t maxDrawCalls  = m_frame->m_maxDrawCalls;
+		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, maxDrawCalls);
+		if (maxDrawCalls <= renderItemIdx)
 		{
 			discard(_flags);
 			++m_numDropped;
@@ -1253,9 +1344,23 @@ namespace bgfx
 
 		++m_numSubmitted;
 
+		expandUniformBlocks(_program);
+
 		UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
 		m_uniformEnd = uniformBuffer->getPos();
 
+		if (_flags & BGFX_DISCARD_STATE)
+		{
+			reuseUniforms();
+		}
+		else
+		{
+			// Next draw starts with uniforms of this one, its range can't be
+			// dropped.
+			m_uniformPrevBegin = 0;
+			m_uniformPrevEnd   = 0;
+		}
+
 		m_key.m_program = isValid(_program)
 			? _program
 			: ProgramHandle{0}
@@ -1312,7 +1417,7 @@ namespace bgfx
 		m_frame->m_renderItemBind[renderItemIdx]  = m_bind;
 
 		m_draw.clear(_flags);
-		m_bind.clear(_flags);
+		clearBind(_flags);
 		if (_flags & BGFX_DISCARD_STATE)
 		{
 			m_uniformBegin = m_uniformEnd;
@@ -1332,8 +1437,9 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
-		if (BGFX_CONFIG_MAX_DRAW_CALLS-1 <= renderItemIdx)
+		const uint32_t maxDrawCalls  = m_frame->m_maxDrawCalls;
+		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, maxDrawCalls);
+		if (maxDrawCalls-1 <= renderItemIdx)
 		{
 			discard(_flags);
 			++m_numDropped;
@@ -1342,8 +1448,11 @@ namespace bgfx
 
 		++m_numSubmitted;
 
+		expandUniformBlocks(_handle);
+
 		UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
 		m_uniformEnd = uniformBuffer->getPos();
+		reuseUniforms();
 
 		m_compute.m_startMatrix = m_draw.m_startMatrix;
 		m_compute.m_numMatrices = m_draw.m_numMatrices;
@@ -1367,7 +1476,7 @@ namespace bgfx
 		m_frame->m_renderItemBind[renderItemIdx]     = m_bind;
 
 		m_compute.clear(_flags);
-		m_bind.clear(_flags);
+		clearBind(_flags);
 		m_uniformBegin = m_uniformEnd;
 	}
 
@@ -1403,10 +1512,17 @@ namespace bgfx
 		}
 	}
 
+	static uint64_t remapSortKeyView(uint64_t _key, const void* _userData)
+	{
+		return SortKey::remapView(_key, (ViewId*)_userData);
+	}
+
 	void Frame::sort()
 	{
 		BGFX_PROFILER_SCOPE("bgfx/Sort", 0xff2040ff);
 
+		const int64_t timeBegin = bx::getHPCounter();
+
 		ViewId viewRemap[BGFX_CONFIG_MAX_VIEWS];
 		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 		{
@@ -1442,19 +1558,24 @@ namespace bgfx
 			}
 		}
 
-		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
-		{
-			m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
-		}
-
-		bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+		s_ctx->m_radixSort.sort(
+			  m_sortKeys
+			, s_ctx->m_tempKeys
+			, m_sortValues
+			, s_ctx->m_tempValues
+			, m_numRenderItems
+			, remapSortKeyView
+			, viewRemap
+			);
 
 		for (uint32_t ii = 0, num = m_numBlitItems; ii < num; ++ii)
 		{
 			m_blitKeys[ii] = BlitKey::remapView(m_blitKeys[ii], viewRemap);
 		}
 
-		bx::radixSort(m_blitKeys, (uint32_t*)&s_ctx->m_tempKeys, m_numBlitItems);
+		bx::radixSort(m_blitKeys, (uint32_t*)s_ctx->m_tempKeys, m_numBlitItems);
+
+		m_perfStats.cpuTimeSort = bx::getHPCounter() - timeBegin;
 	}
 
 	RenderFrame::Enum renderFrame(int32_t _msecs)
@@ -1517,6 +1638,13 @@ namespace bgfx
 		write(&_handle, sizeof(UniformHandle) );
 	}
 
+	void UniformBuffer::writeUniformRef(UniformType::Enum _type, uint16_t _loc, uint32_t _pos, uint16_t _num)
+	{
+		uint32_t opcode = encodeOpcode(_type, _loc, _num, false);
+		write(opcode);
+		write(_pos);
+	}
+
 	void UniformBuffer::writeMarker(const char* _marker)
 	{
 		uint16_t num = (uint16_t)bx::strLen(_marker)+1;
@@ -1907,11 +2035,29 @@ namespace bgfx
 		m_debug   = BGFX_DEBUG_NONE;
 		m_frameTimeLast = bx::getHPCounter();
 
-		m_submit->create(_init.limits.minResourceCbSize);
+		m_maxInitDrawCalls = m_init.limits.maxDrawCalls;
 
-#if BGFX_CONFIG_MULTITHREADED
-		m_render->create(_init.limits.minResourceCbSize);
+		m_numFrames          = m_init.limits.maxFramesInFlight;
+		m_renderIdx          = 0;
+		m_submitIdx          = 0;
+		m_numFramesSubmitted = 0;
+		m_numFramesRendered  = 0;
+		m_render = &m_frame[0];
+		m_submit = &m_frame[0];
 
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
+		{
+			m_frame[ii].create(m_init.limits);
+		}
+
+		// API and render threads are already busy, sort workers get what is left.
+		const uint32_t numCpus = bx::getNumCpus();
+		m_radixSort.init(g_allocator
+			, numCpus > 2 ? numCpus - 2 : 0
+			, BGFX_CONFIG_MIN_PARALLEL_SORT_ITEMS
+			);
+
+#if BGFX_CONFIG_MULTITHREADED
 		if (s_renderFrameCalled)
 		{
 			// When bgfx::renderFrame is called before init render thread
@@ -1979,6 +2125,7 @@ namespace bgfx
 
 		// Make sure renderer init is called from render thread.
 		// g_caps is initialized and available after this point.
+		renderSemWait();
 		frame();
 
 		if (!m_rendererInitialized)
@@ -1986,11 +2133,18 @@ namespace bgfx
 			getCommandBuffer(CommandBuffer::RendererShutdownEnd);
 			frame();
 			frame();
+			renderSemWait();
 			m_vertexLayoutRef.shutdown(m_layoutHandle);
-			m_submit->destroy();
-#if BGFX_CONFIG_MULTITHREADED
-			m_render->destroy();
-#endif // BGFX_CONFIG_MULTITHREADED
+
+			for (uint32_t ii = 0; ii < m_numFrames; ++ii)
+			{
+				m_frame[ii].destroy();
+			}
+
+			m_radixSort.shutdown();
+			BX_FREE(g_allocator, m_tempKeys);
+			BX_FREE(g_allocator, m_tempValues);
+			m_maxTempItems = 0;
 			return false;
 		}
 
@@ -2024,11 +2178,7 @@ namespace bgfx
 		m_textVideoMemBlitter.init();
 		m_clearQuad.init();
 
-		m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.transientVbSize);
-		m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.transientIbSize);
-		frame();
-
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
 		{
 			m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.transientVbSize);
 			m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.transientIbSize);
@@ -2045,20 +2195,22 @@ namespace bgfx
 		getCommandBuffer(CommandBuffer::RendererShutdownBegin);
 		frame();
 
-		destroyTransientVertexBuffer(m_submit->m_transientVb);
-		destroyTransientIndexBuffer(m_submit->m_transientIb);
 		m_textVideoMemBlitter.shutdown();
 		m_clearQuad.shutdown();
-		frame();
 
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
 		{
 			destroyTransientVertexBuffer(m_submit->m_transientVb);
 			destroyTransientIndexBuffer(m_submit->m_transientIb);
 			frame();
 		}
 
-		frame(); // If any VertexLayouts needs to be destroyed.
+		// Release handles still queued in frames in flight, and any VertexLayouts
+		// they free in turn.
+		for (uint32_t ii = 1; ii < m_numFrames; ++ii)
+		{
+			frame();
+		}
 
 		getCommandBuffer(CommandBuffer::RendererShutdownEnd);
 		frame();
@@ -2090,7 +2242,7 @@ namespace bgfx
 
 #if BGFX_CONFIG_MULTITHREADED
 		// Render thread shutdown sequence.
-		renderSemWait(); // Wait for previous frame.
+		renderSemWait(); // Wait for frames in flight.
 		apiSemPost();   // OK to set context to NULL.
 		// s_ctx is NULL here.
 		renderSemWait(); // In RenderFrame::Exiting state.
@@ -2099,14 +2251,20 @@ namespace bgfx
 		{
 			m_thread.shutdown();
 		}
-
-		m_render->destroy();
 #endif // BGFX_CONFIG_MULTITHREADED
 
 		bx::memSet(&g_internalData, 0, sizeof(InternalData) );
 		s_ctx = NULL;
 
-		m_submit->destroy();
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
+		{
+			m_frame[ii].destroy();
+		}
+
+		m_radixSort.shutdown();
+		BX_FREE(g_allocator, m_tempKeys);
+		BX_FREE(g_allocator, m_tempValues);
+		m_maxTempItems = 0;
 
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG) )
 		{
@@ -2181,31 +2339,29 @@ namespace bgfx
 			CHECK_HANDLE_LEAK_RC_NAME("TextureHandle",             m_textureHandle,            TextureRef,     m_textureRef    );
 			CHECK_HANDLE_LEAK_NAME   ("FrameBufferHandle",         m_frameBufferHandle,        FrameBufferRef, m_frameBufferRef);
 			CHECK_HANDLE_LEAK_RC_NAME("UniformHandle",             m_uniformHandle,            UniformRef,     m_uniformRef    );
+			CHECK_HANDLE_LEAK        ("UniformBlockHandle",        m_uniformBlockHandle                                        );
 			CHECK_HANDLE_LEAK        ("OcclusionQueryHandle",      m_occlusionQueryHandle                                      );
 #undef CHECK_HANDLE_LEAK
 #undef CHECK_HANDLE_LEAK_NAME
 		}
 	}
 
-	void Context::freeDynamicBuffers()
+	void Context::freeDynamicBuffers(Frame* _frame)
 	{
-		for (uint16_t ii = 0, num = m_numFreeDynamicIndexBufferHandles; ii < num; ++ii)
+		for (uint16_t ii = 0, num = _frame->m_freeDynamicIndexBuffer.getNumQueued(); ii < num; ++ii)
 		{
-			destroyDynamicIndexBufferInternal(m_freeDynamicIndexBufferHandle[ii]);
+			destroyDynamicIndexBufferInternal(_frame->m_freeDynamicIndexBuffer.get(ii) );
 		}
-		m_numFreeDynamicIndexBufferHandles = 0;
 
-		for (uint16_t ii = 0, num = m_numFreeDynamicVertexBufferHandles; ii < num; ++ii)
+		for (uint16_t ii = 0, num = _frame->m_freeDynamicVertexBuffer.getNumQueued(); ii < num; ++ii)
 		{
-			destroyDynamicVertexBufferInternal(m_freeDynamicVertexBufferHandle[ii]);
+			destroyDynamicVertexBufferInternal(_frame->m_freeDynamicVertexBuffer.get(ii) );
 		}
-		m_numFreeDynamicVertexBufferHandles = 0;
 
-		for (uint16_t ii = 0, num = m_numFreeOcclusionQueryHandles; ii < num; ++ii)
+		for (uint16_t ii = 0, num = _frame->m_freeOcclusionQuery.getNumQueued(); ii < num; ++ii)
 		{
-			m_occlusionQueryHandle.free(m_freeOcclusionQueryHandle[ii].idx);
+			m_occlusionQueryHandle.free(_frame->m_freeOcclusionQuery.get(ii).idx);
 		}
-		m_numFreeOcclusionQueryHandles = 0;
 	}
 
 	void Context::freeAllHandles(Frame* _frame)
@@ -2305,9 +2461,11 @@ namespace bgfx
 
 		m_submit->m_capture = _capture;
 
+		updateUniformBlocks();
+
 		BGFX_PROFILER_SCOPE("bgfx/API thread frame", 0xff2040ff);
-		// wait for render thread to finish
-		renderSemWait();
+		// wait for render thread to finish the frame next in ring
+		renderSemWait(m_numFrames - 2);
 		frameNoRenderWait();
 
 		m_encoder[0].begin(m_submit, 0);
@@ -2319,13 +2477,24 @@ namespace bgfx
 	{
 		swap();
 
+		// Count frames render thread didn't finish yet before releasing it, a fast
+		// render thread could otherwise finish the frame before it's counted.
+		const uint32_t numFramesInFlight = getNumFramesInFlight();
+
 		// release render thread
 		apiSemPost();
+
+		Stats& stats = m_submit->m_perfStats;
+		stats.numFramesInFlight = numFramesInFlight + (m_singleThreaded ? 0 : 1);
+		stats.maxFramesInFlight = m_numFrames;
 	}
 
 	void Context::swap()
 	{
-		freeDynamicBuffers();
+		// Render thread is done with every frame submitted before the one
+		// released here, its handles are safe to reuse.
+		Frame* release = getReleaseFrame();
+		freeDynamicBuffers(release);
 		m_submit->m_resolution = m_init.resolution;
 		m_init.resolution.reset &= ~BGFX_RESET_INTERNAL_FORCE;
 		m_submit->m_debug = m_debug;
@@ -2340,14 +2509,25 @@ namespace bgfx
 			bx::memCopy(m_submit->m_colorPalette, m_clearColor, sizeof(m_clearColor) );
 		}
 
-		freeAllHandles(m_submit);
-		m_submit->resetFreeHandles();
+		freeAllHandles(release);
+		release->resetFreeHandles();
 
 		m_submit->finish();
+		m_submit->m_submitTime = bx::getHPCounter();
 
-		bx::swap(m_render, m_submit);
+		Frame* submitted = m_submit;
+		m_submitIdx = (m_submitIdx + 1) % m_numFrames;
+		m_submit    = &m_frame[m_submitIdx];
 
-		bx::memCopy(m_render->m_occlusion, m_submit->m_occlusion, sizeof(m_submit->m_occlusion) );
+		// the frame handed back to encoders is idle here, apply capacity changed by reset
+		m_submit->resize(m_init.limits);
+
+		// carry latest occlusion results, from frame render thread finished last,
+		// into submitted frame
+		if (submitted != m_submit)
+		{
+			bx::memCopy(submitted->m_occlusion, m_submit->m_occlusion, sizeof(m_submit->m_occlusion) );
+		}
 
 		if (!BX_ENABLED(BGFX_CONFIG_MULTITHREADED)
 		||  m_singleThreaded)
@@ -2361,7 +2541,7 @@ namespace bgfx
 		bx::memSet(m_seq, 0, sizeof(m_seq) );
 
 		m_submit->m_textVideoMem->resize(
-			  m_render->m_textVideoMem->m_small
+			  submitted->m_textVideoMem->m_small
 			, m_init.resolution.width
 			, m_init.resolution.height
 			);
@@ -2371,6 +2551,46 @@ namespace bgfx
 		m_frameTimeLast = now;
 	}
 
+	void Context::setFrameLimits(const Init::Limits& _limits)
+	{
+		uint32_t maxDrawCalls = bx::max<uint32_t>(_limits.maxDrawCalls, 1);
+
+		// these renderers allocate per draw uniform scratch memory at init
+		if (RendererType::Direct3D12 == g_caps.rendererType
+		||  RendererType::Vulkan     == g_caps.rendererType
+		||  RendererType::WebGPU     == g_caps.rendererType)
+		{
+			BX_WARN(maxDrawCalls <= m_maxInitDrawCalls
+				, "%s can't grow draw call capacity past the init limit %d (requested %d)."
+				, getRendererName(g_caps.rendererType)
+				, m_maxInitDrawCalls
+				, maxDrawCalls
+				);
+			maxDrawCalls = bx::min(maxDrawCalls, m_maxInitDrawCalls);
+		}
+
+		m_init.limits.maxDrawCalls   = maxDrawCalls;
+		m_init.limits.maxMatrixCache = bx::max<uint32_t>(_limits.maxMatrixCache, 2);
+		m_init.limits.maxRectCache   = bx::clamp<uint32_t>(_limits.maxRectCache, 2, UINT16_MAX);
+
+		g_caps.limits.maxDrawCalls = maxDrawCalls;
+	}
+
+	void Context::resizeTempItems()
+	{
+		// blit keys are sorted as 32-bit keys through the same scratch memory
+		const uint32_t num = bx::max(m_render->m_maxDrawCalls, uint32_t(BGFX_CONFIG_MAX_BLIT_ITEMS) );
+
+		if (num != m_maxTempItems)
+		{
+			BX_FREE(g_allocator, m_tempKeys);
+			BX_FREE(g_allocator, m_tempValues);
+			m_tempKeys     = (uint64_t*)BX_ALLOC(g_allocator, sizeof(uint64_t)*num);
+			m_tempValues   = (RenderItemCount*)BX_ALLOC(g_allocator, sizeof(RenderItemCount)*num);
+			m_maxTempItems = num;
+		}
+	}
+
 	///
 	RendererContextI* rendererCreate(const Init& _init);
 
@@ -2434,6 +2654,11 @@ namespace bgfx
 
 		if (apiSemWait(_msecs) )
 		{
+			m_render    = &m_frame[m_renderIdx];
+			m_renderIdx = (m_renderIdx + 1) % m_numFrames;
+			m_render->m_perfStats.submitLatency = bx::getHPCounter() - m_render->m_submitTime;
+			resizeTempItems();
+
 			{
 				BGFX_PROFILER_SCOPE("bgfx/Exec commands pre", 0xff2040ff);
 				rendererExecCommands(m_render->m_cmdPre);
@@ -2481,12 +2706,32 @@ namespace bgfx
 			;
 	}
 
-	void rendererUpdateUniforms(RendererContextI* _renderCtx, UniformBuffer* _uniformBuffer, uint32_t _begin, uint32_t _end)
+	bool rendererUpdateUniforms(RendererContextI* _renderCtx, Frame* _render, uint8_t _uniformIdx, uint32_t _begin, uint32_t _end)
 	{
-		_uniformBuffer->reset(_begin);
-		while (_uniformBuffer->getPos() < _end)
+		if (_begin == _end)
 		{
-			uint32_t opcode = _uniformBuffer->read();
+			return false;
+		}
+
+		if (_uniformIdx == _render->m_uniformLastIdx
+		&&  _begin      == _render->m_uniformLastBegin
+		&&  _end        == _render->m_uniformLastEnd)
+		{
+			_render->m_uniformBytesSkipped += _end - _begin;
+			return false;
+		}
+
+		_render->m_uniformLastIdx   = _uniformIdx;
+		_render->m_uniformLastBegin = _begin;
+		_render->m_uniformLastEnd   = _end;
+
+		bool changed = false;
+
+		UniformBuffer* uniformBuffer = _render->m_uniformBuffer[_uniformIdx];
+		uniformBuffer->reset(_begin);
+		while (uniformBuffer->getPos() < _end)
+		{
+			uint32_t opcode = uniformBuffer->read();
 
 			if (UniformType::End == opcode)
 			{
@@ -2499,17 +2744,25 @@ namespace bgfx
 			uint16_t copy;
 			UniformBuffer::decodeOpcode(opcode, type, loc, num, copy);
 
+			// Value not copied by encoder references the earlier write.
 			uint32_t size = g_uniformTypeSize[type]*num;
-			const char* data = _uniformBuffer->read(size);
+			const char* data = copy
+				? uniformBuffer->read(size)
+				: uniformBuffer->getData(uniformBuffer->read() )
+				;
+
 			if (UniformType::Count > type)
 			{
-				if (copy)
+				const bool updated = _renderCtx->updateUniform(loc, data, size);
+
+				if (updated)
 				{
-					_renderCtx->updateUniform(loc, data, size);
+					_render->m_uniformBytesUploaded += size;
+					changed = true;
 				}
 				else
 				{
-					_renderCtx->updateUniform(loc, *(const char**)(data), size);
+					_render->m_uniformBytesSkipped += size;
 				}
 			}
 			else
@@ -2517,6 +2770,8 @@ namespace bgfx
 				_renderCtx->setMarker(data, uint16_t(size)-1);
 			}
 		}
+
+		return changed;
 	}
 
 	void Context::flushTextureUpdateBatch(CommandBuffer& _cmdbuf)
@@ -3433,6 +3688,10 @@ namespace bgfx
 		, minResourceCbSize(BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE)
 		, transientVbSize(BGFX_CONFIG_TRANSIENT_VERTEX_BUFFER_SIZE)
 		, transientIbSize(BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE)
+		, maxDrawCalls(BGFX_CONFIG_MAX_DRAW_CALLS)
+		, maxMatrixCache(BGFX_CONFIG_MAX_MATRIX_CACHE)
+		, maxRectCache(BGFX_CONFIG_MAX_RECT_CACHE)
+		, maxFramesInFlight(BGFX_CONFIG_DEFAULT_FRAMES_IN_FLIGHT)
 	{
 	}
 
@@ -3470,6 +3729,13 @@ namespace bgfx
 
 		init.limits.maxEncoders       = bx::clamp<uint16_t>(init.limits.maxEncoders, 1, (0 != BGFX_CONFIG_MULTITHREADED) ? 128 : 1);
 		init.limits.minResourceCbSize = bx::min<uint32_t>(init.limits.minResourceCbSize, BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE);
+		init.limits.maxDrawCalls      = bx::max<uint32_t>(init.limits.maxDrawCalls, 1);
+		init.limits.maxMatrixCache    = bx::max<uint32_t>(init.limits.maxMatrixCache, 2);
+		init.limits.maxRectCache      = bx::clamp<uint32_t>(init.limits.maxRectCache, 2, UINT16_MAX);
+		init.limits.maxFramesInFlight = (0 != BGFX_CONFIG_MULTITHREADED)
+			? bx::clamp<uint8_t>(init.limits.maxFramesInFlight, 2, BGFX_CONFIG_MAX_FRAMES_IN_FLIGHT)
+			: 1
+			;
 
 		struct ErrorState
 		{
@@ -3504,7 +3770,7 @@ namespace bgfx
 		}
 
 		bx::memSet(&g_caps, 0, sizeof(g_caps) );
-		g_caps.limits.maxDrawCalls            = BGFX_CONFIG_MAX_DRAW_CALLS;
+		g_caps.limits.maxDrawCalls            = init.limits.maxDrawCalls;
 		g_caps.limits.maxBlits                = BGFX_CONFIG_MAX_BLIT_ITEMS;
 		g_caps.limits.maxTextureSize          = 0;
 		g_caps.limits.maxTextureLayers        = 1;
@@ -3618,11 +3884,11 @@ namespace bgfx
 		g_allocator   = NULL;
 	}
 
-	void reset(uint32_t _width, uint32_t _height, uint32_t _flags, TextureFormat::Enum _format)
+	void reset(uint32_t _width, uint32_t _height, uint32_t _flags, TextureFormat::Enum _format, const Init::Limits* _limits)
 	{
 		BGFX_CHECK_API_THREAD();
 		BX_ASSERT(0 == (_flags&BGFX_RESET_RESERVED_MASK), "Do not set reset reserved flags!");
-		s_ctx->reset(_width, _height, _flags, _format);
+		s_ctx->reset(_width, _height, _flags, _format, _limits);
 	}
 
 	Encoder* begin(bool _forThread)
@@ -3688,6 +3954,14 @@ namespace bgfx
 		BGFX_ENCODER(setUniform(uniform.m_type, _handle, _value, UINT16_MAX != _num ? _num : uniform.m_num) );
 	}
 
+	void Encoder::setUniformBlock(uint8_t _stage, UniformBlockHandle _handle)
+	{
+		BX_ASSERT(_stage < BGFX_CONFIG_MAX_TEXTURE_SAMPLERS, "Invalid stage %d (max %d).", _stage, BGFX_CONFIG_MAX_TEXTURE_SAMPLERS);
+		BGFX_CHECK_HANDLE("setUniformBlock", s_ctx->m_uniformBlockHandle, _handle);
+		const UniformBlockRef& block = s_ctx->m_uniformBlockRef[_handle.idx];
+		BGFX_ENCODER(setUniformBlock(_stage, block.m_buffer) );
+	}
+
 	void Encoder::setIndexBuffer(IndexBufferHandle _handle)
 	{
 		setIndexBuffer(_handle, 0, UINT32_MAX);
@@ -5109,6 +5383,22 @@ namespace bgfx
 		s_ctx->destroyUniform(_handle);
 	}
 
+	UniformBlockHandle createUniformBlock(const UniformHandle* _uniforms, uint16_t _num)
+	{
+		return s_ctx->createUniformBlock(_uniforms, _num);
+	}
+
+	void updateUniformBlock(UniformBlockHandle _handle, UniformHandle _uniform, const void* _value, uint16_t _num)
+	{
+		BX_ASSERT(NULL != _value, "_value can't be NULL");
+		s_ctx->updateUniformBlock(_handle, _uniform, _value, _num);
+	}
+
+	void destroy(UniformBlockHandle _handle)
+	{
+		s_ctx->destroyUniformBlock(_handle);
+	}
+
 	OcclusionQueryHandle createOcclusionQuery()
 	{
 		BGFX_CHECK_CAPS(BGFX_CAPS_OCCLUSION_QUERY, "Occlusion query is not supported!");
@@ -5298,6 +5588,12 @@ namespace bgfx
 		s_ctx->m_encoder0->setUniform(_handle, _value, _num);
 	}
 
+	void setUniformBlock(uint8_t _stage, UniformBlockHandle _handle)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->setUniformBlock(_stage, _handle);
+	}
+
 	void setIndexBuffer(IndexBufferHandle _handle)
 	{
 		setIndexBuffer(_handle, 0, UINT32_MAX);
@@ -596,6 +596,26 @@ BGFX_C_API void bgfx_destroy_uniform(bgfx_uniform_handle_t _handle)
 	bgfx::destroy(handle.cpp);
 }
 
+BGFX_C_API bgfx_uniform_block_handle_t bgfx_create_uniform_block(const bgfx_uniform_handle_t * _uniforms, uint16_t _num)
+{
+	union { bgfx_uniform_block_handle_t c; bgfx::UniformBlockHandle cpp; } handle_ret;
+	handle_ret.cpp = bgfx::createUniformBlock((const bgfx::UniformHandle *)_uniforms, _num);
+	return handle_ret.c;
+}
+
+BGFX_C_API void bgfx_update_uniform_block(bgfx_uniform_block_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num)
+{
+	union { bgfx_uniform_block_handle_t c; bgfx::UniformBlockHandle cpp; } handle = { _handle };
+	union { bgfx_uniform_handle_t c; bgfx::UniformHandle cpp; } uniform = { _uniform };
+	bgfx::updateUniformBlock(handle.cpp, uniform.cpp, _value, _num);
+}
+
+BGFX_C_API void bgfx_destroy_uniform_block(bgfx_uniform_block_handle_t _handle)
+{
+	union { bgfx_uniform_block_handle_t c; bgfx::UniformBlockHandle cpp; } handle = { _handle };
+	bgfx::destroy(handle.cpp);
+}
+
 BGFX_C_API bgfx_occlusion_query_handle_t bgfx_create_occlusion_query(void)
 {
 	union { bgfx_occlusion_query_handle_t c; bgfx::OcclusionQueryHandle cpp; } handle_ret;
@@ -753,6 +773,13 @@ BGFX_C_API void bgfx_encoder_set_uniform(bgfx_encoder_t* _this, bgfx_uniform_han
 	This->setUniform(handle.cpp, _value, _num);
 }
 
+BGFX_C_API void bgfx_encoder_set_uniform_block(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_block_handle_t _handle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_uniform_block_handle_t c; bgfx::UniformBlockHandle cpp; } handle = { _handle };
+	This->setUniformBlock(_stage, handle.cpp);
+}
+
 BGFX_C_API void bgfx_encoder_set_index_buffer(bgfx_encoder_t* _this, bgfx_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -1042,6 +1069,12 @@ BGFX_C_API void bgfx_set_uniform(bgfx_uniform_handle_t _handle, const void* _val
 	bgfx::setUniform(handle.cpp, _value, _num);
 }
 
+BGFX_C_API void bgfx_set_uniform_block(uint8_t _stage, bgfx_uniform_block_handle_t _handle)
+{
+	union { bgfx_uniform_block_handle_t c; bgfx::UniformBlockHandle cpp; } handle = { _handle };
+	bgfx::setUniformBlock(_stage, handle.cpp);
+}
+
 BGFX_C_API void bgfx_set_index_buffer(bgfx_index_buffer_handle_t _handle, uint32_t _firstIndex, uint32_t _numIndices)
 {
 	union { bgfx_index_buffer_handle_t c; bgfx::IndexBufferHandle cpp; } handle = { _handle };
@@ -1346,6 +1379,9 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_create_uniform,
 			bgfx_get_uniform_info,
 			bgfx_destroy_uniform,
+			bgfx_create_uniform_block,
+			bgfx_update_uniform_block,
+			bgfx_destroy_uniform_block,
 			bgfx_create_occlusion_query,
 			bgfx_get_result,
 			bgfx_destroy_occlusion_query,
@@ -1374,6 +1410,7 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_encoder_set_transform_cached,
 			bgfx_encoder_alloc_transform,
 			bgfx_encoder_set_uniform,
+			bgfx_encoder_set_uniform_block,
 			bgfx_encoder_set_index_buffer,
 			bgfx_encoder_set_dynamic_index_buffer,
 			bgfx_encoder_set_transient_index_buffer,
@@ -1419,6 +1456,7 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_set_transform_cached,
 			bgfx_alloc_transform,
 			bgfx_set_uniform,
+			bgfx_set_uniform_block,
 			bgfx_set_index_buffer,
 			bgfx_set_dynamic_index_buffer,
 			bgfx_set_transient_index_buffer,
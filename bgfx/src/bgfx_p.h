@@ -144,6 +144,7 @@ namespace bgfx
 
 #include <bgfx/platform.h>
 #include <bimg/bimg.h>
+#include "radixsort.h"
 #include "shader.h"
 #include "vertexlayout.h"
 #include "version.h"
@@ -221,6 +222,8 @@ namespace stl = std;
 
 #define BGFX_MAX_COMPUTE_BINDINGS BGFX_CONFIG_MAX_TEXTURE_SAMPLERS
 
+#define BGFX_BUFFER_INTERNAL_UNIFORM        UINT16_C(0x8000)
+
 #define BGFX_SAMPLER_INTERNAL_DEFAULT       UINT32_C(0x10000000)
 #define BGFX_SAMPLER_INTERNAL_SHARED        UINT32_C(0x20000000)
 
@@ -295,11 +298,8 @@ namespace bgfx
 	extern void isFrameBufferValid(uint8_t _num, const Attachment* _attachment, bx::Error* _err);
 	extern void isIdentifierValid(const bx::StringView& _name, bx::Error* _err);
 
-#if BGFX_CONFIG_MAX_DRAW_CALLS < (64<<10)
-	typedef uint16_t RenderItemCount;
-#else
+	// Draw call capacity is a runtime limit (Init::Limits::maxDrawCalls) and can exceed 16 bits.
 	typedef uint32_t RenderItemCount;
-#endif // BGFX_CONFIG_MAX_DRAW_CALLS < (64<<10)
 
 	struct Handle
 	{
@@ -483,6 +483,13 @@ namespace bgfx
 	};
 
 	extern const uint32_t g_uniformTypeSize[UniformType::Count+1];
+
+	/// Size of uniform inside of uniform block, std140 pads each column of
+	/// 3x3 matrix to vec4.
+	inline uint32_t getUniformBlockTypeSize(UniformType::Enum _type)
+	{
+		return UniformType::Mat3 == _type ? 3*16 : g_uniformTypeSize[_type];
+	}
 	extern CallbackI* g_callback;
 	extern bx::AllocatorI* g_allocator;
 	extern Caps g_caps;
@@ -1287,11 +1294,36 @@ namespace bgfx
 	struct MatrixCache
 	{
 		MatrixCache()
-			: m_num(1)
+			: m_cache(NULL)
+			, m_max(0)
+			, m_num(1)
+		{
+		}
+
+		void create(uint32_t _max)
 		{
+			if (_max == m_max)
+			{
+				return;
+			}
+
+			destroy();
+
+			m_cache = (Matrix4*)BX_ALIGNED_ALLOC(g_allocator, sizeof(Matrix4)*_max, 16);
+			m_max   = _max;
 			m_cache[0].setIdentity();
 		}
 
+		void destroy()
+		{
+			if (NULL != m_cache)
+			{
+				BX_ALIGNED_FREE(g_allocator, m_cache, 16);
+				m_cache = NULL;
+				m_max   = 0;
+			}
+		}
+
 		void reset()
 		{
 			m_num = 1;
@@ -1300,9 +1332,9 @@ namespace bgfx
 		uint32_t reserve(uint16_t* _num)
 		{
 			uint32_t num = *_num;
-			uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, num, BGFX_CONFIG_MAX_MATRIX_CACHE - 1);
-			BX_WARN(first+num < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache overflow. %d (max: %d)", first+num, BGFX_CONFIG_MAX_MATRIX_CACHE);
-			num = bx::min(num, BGFX_CONFIG_MAX_MATRIX_CACHE-1-first);
+			uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, num, m_max - 1);
+			BX_WARN(first+num < m_max, "Matrix cache overflow. %d (max: %d)", first+num, m_max);
+			num = bx::min(num, m_max-1-first);
 			*_num = (uint16_t)num;
 			return first;
 		}
@@ -1321,9 +1353,9 @@ namespace bgfx
 
 		float* toPtr(uint32_t _cacheIdx)
 		{
-			BX_ASSERT(_cacheIdx < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache out of bounds index %d (max: %d)"
+			BX_ASSERT(_cacheIdx < m_max, "Matrix cache out of bounds index %d (max: %d)"
 				, _cacheIdx
-				, BGFX_CONFIG_MAX_MATRIX_CACHE
+				, m_max
 				);
 			return m_cache[_cacheIdx].un.val;
 		}
@@ -1333,15 +1365,41 @@ namespace bgfx
 			return uint32_t( (const Matrix4*)_ptr - m_cache);
 		}
 
-		Matrix4 m_cache[BGFX_CONFIG_MAX_MATRIX_CACHE];
+		Matrix4* m_cache;
+		uint32_t m_max;
 		uint32_t m_num;
 	};
 
 	struct RectCache
 	{
 		RectCache()
-			: m_num(0)
+			: m_cache(NULL)
+			, m_max(0)
+			, m_num(0)
+		{
+		}
+
+		void create(uint32_t _max)
 		{
+			if (_max == m_max)
+			{
+				return;
+			}
+
+			destroy();
+
+			m_cache = (Rect*)BX_ALLOC(g_allocator, sizeof(Rect)*_max);
+			m_max   = _max;
+		}
+
+		void destroy()
+		{
+			if (NULL != m_cache)
+			{
+				BX_FREE(g_allocator, m_cache);
+				m_cache = NULL;
+				m_max   = 0;
+			}
 		}
 
 		void reset()
@@ -1351,8 +1409,8 @@ namespace bgfx
 
 		uint32_t add(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
 		{
-			const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, 1, BGFX_CONFIG_MAX_RECT_CACHE-1);
-			BX_ASSERT(first+1 < BGFX_CONFIG_MAX_RECT_CACHE, "Rect cache overflow. %d (max: %d)", first, BGFX_CONFIG_MAX_RECT_CACHE);
+			const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, 1, m_max-1);
+			BX_ASSERT(first+1 < m_max, "Rect cache overflow. %d (max: %d)", first, m_max);
 
 			Rect& rect = m_cache[first];
 
@@ -1364,7 +1422,8 @@ namespace bgfx
 			return first;
 		}
 
-		Rect     m_cache[BGFX_CONFIG_MAX_RECT_CACHE];
+		Rect*    m_cache;
+		uint32_t m_max;
 		uint32_t m_num;
 	};
 
@@ -1484,6 +1543,11 @@ namespace bgfx
 			return m_pos;
 		}
 
+		const char* getData(uint32_t _pos) const
+		{
+			return &m_buffer[_pos];
+		}
+
 		void reset(uint32_t _pos = 0)
 		{
 			m_pos = _pos;
@@ -1497,6 +1561,7 @@ namespace bgfx
 
 		void writeUniform(UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num = 1);
 		void writeUniformHandle(UniformType::Enum _type, uint16_t _loc, UniformHandle _handle, uint16_t _num = 1);
+		void writeUniformRef(UniformType::Enum _type, uint16_t _loc, uint32_t _pos, uint16_t _num = 1);
 		void writeMarker(const char* _marker);
 
 	private:
@@ -1575,6 +1640,7 @@ namespace bgfx
 			IndexBuffer,
 			VertexBuffer,
 			Texture,
+			UniformBuffer,
 
 			Count
 		};
@@ -1834,10 +1900,23 @@ namespace bgfx
 
 	struct UniformRef
 	{
-		String            m_name;
-		UniformType::Enum m_type;
-		uint16_t          m_num;
-		int16_t           m_refCount;
+		String             m_name;
+		UniformType::Enum  m_type;
+		UniformBlockHandle m_block;
+		uint16_t           m_blockOffset;
+		uint16_t           m_num;
+		int16_t            m_refCount;
+	};
+
+	struct UniformBlockRef
+	{
+		UniformHandle*     m_uniforms;
+		uint8_t*           m_data;
+		VertexBufferHandle m_buffer;
+		uint16_t           m_num;
+		uint32_t           m_size;
+		uint32_t           m_dirtyBegin;
+		uint32_t           m_dirtyEnd;
 	};
 
 	struct TextureRef
@@ -2012,6 +2091,18 @@ namespace bgfx
 
 	struct FrameCache
 	{
+		void create(uint32_t _maxMatrixCache, uint32_t _maxRectCache)
+		{
+			m_matrixCache.create(_maxMatrixCache);
+			m_rectCache.create(_maxRectCache);
+		}
+
+		void destroy()
+		{
+			m_matrixCache.destroy();
+			m_rectCache.destroy();
+		}
+
 		void reset()
 		{
 			m_matrixCache.reset();
@@ -2043,15 +2134,21 @@ namespace bgfx
 	BX_ALIGN_DECL_CACHE_LINE(struct) Frame
 	{
 		Frame()
-			: m_waitSubmit(0)
+			: m_sortKeys(NULL)
+			, m_sortValues(NULL)
+			, m_renderItem(NULL)
+			, m_renderItemBind(NULL)
+			, m_maxDrawCalls(0)
+			, m_waitSubmit(0)
 			, m_waitRender(0)
+			, m_submitTime(0)
+			, m_uniformLastBegin(0)
+			, m_uniformLastEnd(0)
+			, m_uniformLastIdx(UINT8_MAX)
+			, m_uniformBytesSkipped(0)
+			, m_uniformBytesUploaded(0)
 			, m_capture(false)
 		{
-			SortKey term;
-			term.reset();
-			term.m_program = BGFX_INVALID_HANDLE;
-			m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS]   = term.encodeDraw(SortKey::SortProgram);
-			m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS] = BGFX_CONFIG_MAX_DRAW_CALLS;
 			bx::memSet(m_occlusion, 0xff, sizeof(m_occlusion) );
 
 			m_perfStats.viewStats = m_viewStats;
@@ -2061,10 +2158,12 @@ namespace bgfx
 		{
 		}
 
-		void create(uint32_t _minResourceCbSize)
+		void create(const Init::Limits& _limits)
 		{
-			m_cmdPre.init(_minResourceCbSize);
-			m_cmdPost.init(_minResourceCbSize);
+			m_cmdPre.init(_limits.minResourceCbSize);
+			m_cmdPost.init(_limits.minResourceCbSize);
+
+			resize(_limits);
 
 			{
 				const uint32_t num = g_caps.limits.maxEncoders;
@@ -2091,6 +2190,52 @@ namespace bgfx
 
 			BX_FREE(g_allocator, m_uniformBuffer);
 			BX_DELETE(g_allocator, m_textVideoMem);
+
+			destroyRenderItems();
+			m_frameCache.destroy();
+		}
+
+		// Resizes per frame capacity, must only be called while no encoder or renderer uses the frame.
+		void resize(const Init::Limits& _limits)
+		{
+			m_frameCache.create(_limits.maxMatrixCache, _limits.maxRectCache);
+
+			if (_limits.maxDrawCalls == m_maxDrawCalls)
+			{
+				return;
+			}
+
+			destroyRenderItems();
+
+			// one extra item past capacity holds the terminating sort key
+			const uint32_t num = _limits.maxDrawCalls + 1;
+			m_sortKeys       = (uint64_t*)BX_ALLOC(g_allocator, sizeof(uint64_t)*num);
+			m_sortValues     = (RenderItemCount*)BX_ALLOC(g_allocator, sizeof(RenderItemCount)*num);
+			m_renderItem     = (RenderItem*)BX_ALLOC(g_allocator, sizeof(RenderItem)*num);
+			m_renderItemBind = (RenderBind*)BX_ALLOC(g_allocator, sizeof(RenderBind)*num);
+			m_maxDrawCalls   = _limits.maxDrawCalls;
+
+			SortKey term;
+			term.reset();
+			term.m_program = BGFX_INVALID_HANDLE;
+			m_sortKeys[m_maxDrawCalls]   = term.encodeDraw(SortKey::SortProgram);
+			m_sortValues[m_maxDrawCalls] = RenderItemCount(m_maxDrawCalls);
+		}
+
+		void destroyRenderItems()
+		{
+			if (NULL != m_sortKeys)
+			{
+				BX_FREE(g_allocator, m_sortKeys);
+				BX_FREE(g_allocator, m_sortValues);
+				BX_FREE(g_allocator, m_renderItem);
+				BX_FREE(g_allocator, m_renderItemBind);
+				m_sortKeys       = NULL;
+				m_sortValues     = NULL;
+				m_renderItem     = NULL;
+				m_renderItemBind = NULL;
+				m_maxDrawCalls   = 0;
+			}
 		}
 
 		void reset()
@@ -2104,12 +2249,19 @@ namespace bgfx
 		{
 			m_perfStats.transientVbUsed = m_vboffset;
 			m_perfStats.transientIbUsed = m_iboffset;
+			m_perfStats.uniformBytesSkipped  = m_uniformBytesSkipped;
+			m_perfStats.uniformBytesUploaded = m_uniformBytesUploaded;
 
 			m_frameCache.reset();
 			m_numRenderItems = 0;
 			m_numBlitItems   = 0;
 			m_iboffset = 0;
 			m_vboffset = 0;
+			m_uniformLastBegin = 0;
+			m_uniformLastEnd   = 0;
+			m_uniformLastIdx   = UINT8_MAX;
+			m_uniformBytesSkipped  = 0;
+			m_uniformBytesUploaded = 0;
 			m_cmdPre.start();
 			m_cmdPost.start();
 			m_capture = false;
@@ -2202,6 +2354,21 @@ namespace bgfx
 			return m_freeUniform.queue(_handle);
 		}
 
+		bool free(DynamicIndexBufferHandle _handle)
+		{
+			return m_freeDynamicIndexBuffer.queue(_handle);
+		}
+
+		bool free(DynamicVertexBufferHandle _handle)
+		{
+			return m_freeDynamicVertexBuffer.queue(_handle);
+		}
+
+		bool free(OcclusionQueryHandle _handle)
+		{
+			return m_freeOcclusionQuery.queue(_handle);
+		}
+
 		void resetFreeHandles()
 		{
 			m_freeIndexBuffer.reset();
@@ -2212,6 +2379,9 @@ namespace bgfx
 			m_freeTexture.reset();
 			m_freeFrameBuffer.reset();
 			m_freeUniform.reset();
+			m_freeDynamicIndexBuffer.reset();
+			m_freeDynamicVertexBuffer.reset();
+			m_freeOcclusionQuery.reset();
 		}
 
 		ViewId m_viewRemap[BGFX_CONFIG_MAX_VIEWS];
@@ -2221,10 +2391,11 @@ namespace bgfx
 
 		int32_t m_occlusion[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
 
-		uint64_t m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderItemCount m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderItem m_renderItem[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderBind m_renderItemBind[BGFX_CONFIG_MAX_DRAW_CALLS + 1];
+		uint64_t* m_sortKeys;
+		RenderItemCount* m_sortValues;
+		RenderItem* m_renderItem;
+		RenderBind* m_renderItemBind;
+		uint32_t m_maxDrawCalls;
 
 		uint32_t m_blitKeys[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
 		BlitItem m_blitItem[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
@@ -2314,6 +2485,10 @@ namespace bgfx
 		FreeHandle<FrameBufferHandle,  BGFX_CONFIG_MAX_FRAME_BUFFERS>  m_freeFrameBuffer;
 		FreeHandle<UniformHandle,      BGFX_CONFIG_MAX_UNIFORMS>       m_freeUniform;
 
+		FreeHandle<DynamicIndexBufferHandle,  BGFX_CONFIG_MAX_DYNAMIC_INDEX_BUFFERS>  m_freeDynamicIndexBuffer;
+		FreeHandle<DynamicVertexBufferHandle, BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS> m_freeDynamicVertexBuffer;
+		FreeHandle<OcclusionQueryHandle,      BGFX_CONFIG_MAX_OCCLUSION_QUERIES>      m_freeOcclusionQuery;
+
 		TextVideoMem* m_textVideoMem;
 
 		Stats     m_perfStats;
@@ -2321,6 +2496,16 @@ namespace bgfx
 
 		int64_t m_waitSubmit;
 		int64_t m_waitRender;
+		int64_t m_submitTime;
+
+		// Uniform range render thread applied last, draws pointing to the same
+		// range have nothing to update.
+		uint32_t m_uniformLastBegin;
+		uint32_t m_uniformLastEnd;
+		uint8_t  m_uniformLastIdx;
+
+		uint32_t m_uniformBytesSkipped;
+		uint32_t m_uniformBytesUploaded;
 
 		bool m_capture;
 	};
@@ -2341,6 +2526,10 @@ namespace bgfx
 			m_uniformIdx   = _idx;
 			m_uniformBegin = 0;
 			m_uniformEnd   = 0;
+			m_uniformPrevBegin    = 0;
+			m_uniformPrevEnd      = 0;
+			m_uniformBytesSkipped = 0;
+			bx::memSet(m_uniformLast, 0xff, sizeof(m_uniformLast) );
 
 			UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
 			uniformBuffer->reset();
@@ -2359,6 +2548,9 @@ namespace bgfx
 				m_cpuTimeEnd = bx::getHPCounter();
 			}
 
+			bx::atomicFetchAndAdd<uint32_t>(&m_frame->m_uniformBytesSkipped, m_uniformBytesSkipped);
+			m_uniformBytesSkipped = 0;
+
 			if (BX_ENABLED(BGFX_CONFIG_DEBUG_OCCLUSION) )
 			{
 				m_occlusionQuerySet.clear();
@@ -2376,6 +2568,52 @@ namespace bgfx
 			uniformBuffer->writeMarker(_name);
 		}
 
+		// Draws are sorted before rendering, so a value can't be left out just
+		// because previous draw set it. Instead, draw with the same uniforms as
+		// previous draw points to its range, and the copy is dropped.
+		void reuseUniforms()
+		{
+			const uint32_t size = m_uniformEnd - m_uniformBegin;
+			UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
+
+			if (0 != size
+			&&  m_uniformPrevEnd - m_uniformPrevBegin == size
+			&&  0 == bx::memCmp(uniformBuffer->getData(m_uniformBegin), uniformBuffer->getData(m_uniformPrevBegin), size) )
+			{
+				// Values written by this draw are moved to the same place in the
+				// previous range.
+				uniformBuffer->reset(m_uniformBegin);
+				while (uniformBuffer->getPos() < m_uniformEnd)
+				{
+					const uint32_t pos = uniformBuffer->getPos();
+
+					UniformType::Enum type;
+					uint16_t loc;
+					uint16_t num;
+					uint16_t copy;
+					UniformBuffer::decodeOpcode(uniformBuffer->read(), type, loc, num, copy);
+					uniformBuffer->read(copy ? g_uniformTypeSize[type]*num : sizeof(uint32_t) );
+
+					if (copy
+					&&  UniformType::Count > type
+					&&  pos == m_uniformLast[loc])
+					{
+						m_uniformLast[loc] = pos - m_uniformBegin + m_uniformPrevBegin;
+					}
+				}
+
+				uniformBuffer->reset(m_uniformBegin);
+				m_uniformBegin = m_uniformPrevBegin;
+				m_uniformEnd   = m_uniformPrevEnd;
+				m_uniformBytesSkipped += size;
+			}
+			else
+			{
+				m_uniformPrevBegin = m_uniformBegin;
+				m_uniformPrevEnd   = m_uniformEnd;
+			}
+		}
+
 		void setUniform(UniformType::Enum _type, UniformHandle _handle, const void* _value, uint16_t _num)
 		{
 			if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM) )
@@ -2388,9 +2626,32 @@ namespace bgfx
 				m_uniformSet.insert(_handle.idx);
 			}
 
+			writeUniform(_type, _handle, _value, _num);
+		}
+
+		void writeUniform(UniformType::Enum _type, UniformHandle _handle, const void* _value, uint16_t _num)
+		{
 			UniformBuffer::update(&m_frame->m_uniformBuffer[m_uniformIdx]);
 			UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
-			uniformBuffer->writeUniform(_type, _handle.idx, _value, _num);
+
+			// Value identical to the last one written for this uniform is
+			// referenced instead of copied again.
+			const uint32_t opcode = UniformBuffer::encodeOpcode(_type, _handle.idx, _num, true);
+			const uint32_t size   = g_uniformTypeSize[_type]*_num;
+			uint32_t& last = m_uniformLast[_handle.idx];
+
+			if (UINT32_MAX != last
+			&&  0 == bx::memCmp(uniformBuffer->getData(last), &opcode, sizeof(uint32_t) )
+			&&  0 == bx::memCmp(uniformBuffer->getData(last + sizeof(uint32_t) ), _value, size) )
+			{
+				uniformBuffer->writeUniformRef(_type, _handle.idx, last + sizeof(uint32_t), _num);
+				m_uniformBytesSkipped += size;
+			}
+			else
+			{
+				last = uniformBuffer->getPos();
+				uniformBuffer->writeUniform(_type, _handle.idx, _value, _num);
+			}
 		}
 
 		void setState(uint64_t _state, uint32_t _rgba)
@@ -2463,12 +2724,13 @@ namespace bgfx
 
 		void setTransform(uint32_t _cache, uint16_t _num)
 		{
-			BX_ASSERT(_cache < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache out of bounds index %d (max: %d)"
+			const uint32_t maxMatrixCache = m_frame->m_frameCache.m_matrixCache.m_max;
+			BX_ASSERT(_cache < maxMatrixCache, "Matrix cache out of bounds index %d (max: %d)"
 				, _cache
-				, BGFX_CONFIG_MAX_MATRIX_CACHE
+				, maxMatrixCache
 				);
 			m_draw.m_startMatrix = _cache;
-			m_draw.m_numMatrices = uint16_t(bx::min<uint32_t>(_cache+_num, BGFX_CONFIG_MAX_MATRIX_CACHE-1) - _cache);
+			m_draw.m_numMatrices = uint16_t(bx::min<uint32_t>(_cache+_num, maxMatrixCache-1) - _cache);
 		}
 
 		void setIndexBuffer(IndexBufferHandle _handle, const IndexBuffer& _ib, uint32_t _firstIndex, uint32_t _numIndices)
@@ -2646,6 +2908,20 @@ namespace bgfx
 			bind.m_mip    = _mip;
 		}
 
+		void setUniformBlock(uint8_t _stage, VertexBufferHandle _handle)
+		{
+			Binding& bind = m_bind.m_bind[_stage];
+			bind.m_idx    = _handle.idx;
+			bind.m_type   = uint8_t(Binding::UniformBuffer);
+			bind.m_format = 0;
+			bind.m_access = uint8_t(Access::Read);
+			bind.m_mip    = 0;
+
+			m_uniformBlockStages |= UINT32_C(1) << _stage;
+		}
+
+		void expandUniformBlocks(ProgramHandle _program);
+
 		void discard(uint8_t _flags)
 		{
 			if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM) )
@@ -2656,7 +2932,17 @@ namespace bgfx
 			m_discard = false;
 			m_draw.clear(_flags);
 			m_compute.clear(_flags);
+			clearBind(_flags);
+		}
+
+		void clearBind(uint8_t _flags)
+		{
 			m_bind.clear(_flags);
+
+			if (0 != (_flags & BGFX_DISCARD_BINDINGS) )
+			{
+				m_uniformBlockStages = 0;
+			}
 		}
 
 		void submit(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32_t _depth, uint8_t _flags);
@@ -2695,6 +2981,12 @@ namespace bgfx
 
 		uint32_t m_uniformBegin;
 		uint32_t m_uniformEnd;
+		uint32_t m_uniformPrevBegin;
+		uint32_t m_uniformPrevEnd;
+		uint32_t m_uniformBytesSkipped;
+		uint32_t m_uniformLast[BGFX_CONFIG_MAX_UNIFORMS];
+		uint32_t m_uniformBlockStages; // Stages with a uniform block bound.
+		BX_STATIC_ASSERT(BGFX_CONFIG_MAX_TEXTURE_SAMPLERS <= 32);
 		uint32_t m_numVertices[BGFX_CONFIG_MAX_VERTEX_STREAMS];
 		uint8_t  m_uniformIdx;
 		bool     m_discard;
@@ -2968,7 +3260,7 @@ namespace bgfx
 		virtual void destroyUniform(UniformHandle _handle) = 0;
 		virtual void requestScreenShot(FrameBufferHandle _handle, const char* _filePath) = 0;
 		virtual void updateViewName(ViewId _id, const char* _name) = 0;
-		virtual void updateUniform(uint16_t _loc, const void* _data, uint32_t _size) = 0;
+		virtual bool updateUniform(uint16_t _loc, const void* _data, uint32_t _size) = 0;
 		virtual void invalidateOcclusionQuery(OcclusionQueryHandle _handle) = 0;
 		virtual void setMarker(const char* _marker, uint16_t _len) = 0;
 		virtual void setName(Handle _handle, const char* _name, uint16_t _len) = 0;
@@ -2981,7 +3273,7 @@ namespace bgfx
 	{
 	}
 
-	void rendererUpdateUniforms(RendererContextI* _renderCtx, UniformBuffer* _uniformBuffer, uint32_t _begin, uint32_t _end);
+	bool rendererUpdateUniforms(RendererContextI* _renderCtx, Frame* _render, uint8_t _uniformIdx, uint32_t _begin, uint32_t _end);
 
 #if BGFX_CONFIG_DEBUG
 #	define BGFX_API_FUNC(_func) BX_NO_INLINE _func
@@ -2995,10 +3287,16 @@ namespace bgfx
 
 		Context()
 			: m_render(&m_frame[0])
-			, m_submit(&m_frame[BGFX_CONFIG_MULTITHREADED ? 1 : 0])
-			, m_numFreeDynamicIndexBufferHandles(0)
-			, m_numFreeDynamicVertexBufferHandles(0)
-			, m_numFreeOcclusionQueryHandles(0)
+			, m_submit(&m_frame[0])
+			, m_numFrames(1)
+			, m_renderIdx(0)
+			, m_submitIdx(0)
+			, m_numFramesSubmitted(0)
+			, m_numFramesRendered(0)
+			, m_tempKeys(NULL)
+			, m_tempValues(NULL)
+			, m_maxTempItems(0)
+			, m_maxInitDrawCalls(0)
 			, m_colorPaletteDirty(0)
 			, m_frames(0)
 			, m_debug(BGFX_DEBUG_NONE)
@@ -3039,8 +3337,13 @@ namespace bgfx
 			return cmdbuf;
 		}
 
-		BGFX_API_FUNC(void reset(uint32_t _width, uint32_t _height, uint32_t _flags, TextureFormat::Enum _format) )
+		BGFX_API_FUNC(void reset(uint32_t _width, uint32_t _height, uint32_t _flags, TextureFormat::Enum _format, const Init::Limits* _limits) )
 		{
+			if (NULL != _limits)
+			{
+				setFrameLimits(*_limits);
+			}
+
 			const TextureFormat::Enum format = TextureFormat::Count != _format ? _format : m_init.resolution.format;
 
 			if (!g_platformDataChangedSinceReset
@@ -3333,7 +3636,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				getReleaseFrame(1)->free(layoutHandle);
 			}
 
 			m_vertexBufferHandle.free(_handle.idx);
@@ -3493,7 +3796,8 @@ namespace bgfx
 
 			BGFX_CHECK_HANDLE("destroyDynamicIndexBuffer", m_dynamicIndexBufferHandle, _handle);
 
-			m_freeDynamicIndexBufferHandle[m_numFreeDynamicIndexBufferHandles++] = _handle;
+			bool ok = m_submit->free(_handle); BX_UNUSED(ok);
+			BX_ASSERT(ok, "Dynamic index buffer handle %d is already destroyed!", _handle.idx);
 		}
 
 		void destroyDynamicIndexBufferInternal(DynamicIndexBufferHandle _handle)
@@ -3689,7 +3993,8 @@ namespace bgfx
 
 			BGFX_CHECK_HANDLE("destroyDynamicVertexBuffer", m_dynamicVertexBufferHandle, _handle);
 
-			m_freeDynamicVertexBufferHandle[m_numFreeDynamicVertexBufferHandles++] = _handle;
+			bool ok = m_submit->free(_handle); BX_UNUSED(ok);
+			BX_ASSERT(ok, "Dynamic vertex buffer handle %d is already destroyed!", _handle.idx);
 		}
 
 		void destroyDynamicVertexBufferInternal(DynamicVertexBufferHandle _handle)
@@ -3701,7 +4006,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				getReleaseFrame(1)->free(layoutHandle);
 			}
 
 			DynamicVertexBuffer& dvb = m_dynamicVertexBuffers[_handle.idx];
@@ -4459,7 +4764,7 @@ namespace bgfx
 			cmdbuf.write(_handle);
 			cmdbuf.write(_data);
 			cmdbuf.write(_mip);
-			return m_frames + 2;
+			return m_frames + m_numFrames;
 		}
 
 		void resizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, uint16_t _numLayers)
@@ -4769,6 +5074,8 @@ namespace bgfx
 			uniform.m_refCount = 1;
 			uniform.m_type = _type;
 			uniform.m_num  = _num;
+			uniform.m_block.idx   = kInvalidHandle;
+			uniform.m_blockOffset = 0;
 
 			bool ok = m_uniformHashMap.insert(bx::hash<bx::HashMurmur2A>(_name), handle.idx);
 			BX_ASSERT(ok, "Uniform already exists (name: %s)!", _name); BX_UNUSED(ok);
@@ -4819,6 +5126,167 @@ namespace bgfx
 			}
 		}
 
+		BGFX_API_FUNC(UniformBlockHandle createUniformBlock(const UniformHandle* _uniforms, uint16_t _num) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			uint32_t size = 0;
+			for (uint16_t ii = 0; ii < _num; ++ii)
+			{
+				BGFX_CHECK_HANDLE("createUniformBlock", m_uniformHandle, _uniforms[ii]);
+
+				const UniformRef& uniform = m_uniformRef[_uniforms[ii].idx];
+				BX_ASSERT(UniformType::Sampler != uniform.m_type
+					, "Sampler uniform %s can't be uniform block member."
+					, uniform.m_name.getPtr()
+					);
+				BX_ASSERT(!isValid(uniform.m_block)
+					, "Uniform %s is already member of uniform block %d."
+					, uniform.m_name.getPtr()
+					, uniform.m_block.idx
+					);
+				size += getUniformBlockTypeSize(uniform.m_type)*uniform.m_num;
+			}
+
+			// Minimum uniform buffer size guaranteed by all renderers.
+			BX_ASSERT(0 < size && size <= 16<<10, "Invalid uniform block size %d.", size);
+
+			UniformBlockHandle handle = { m_uniformBlockHandle.alloc() };
+			if (!isValid(handle) )
+			{
+				BX_TRACE("Failed to allocate uniform block handle.");
+				return BGFX_INVALID_HANDLE;
+			}
+
+			VertexBufferHandle buffer = { m_vertexBufferHandle.alloc() };
+			if (!isValid(buffer) )
+			{
+				BX_TRACE("Failed to allocate uniform block buffer handle.");
+				m_uniformBlockHandle.free(handle.idx);
+				return BGFX_INVALID_HANDLE;
+			}
+
+			UniformBlockRef& block = m_uniformBlockRef[handle.idx];
+			block.m_uniforms   = (UniformHandle*)BX_ALLOC(g_allocator, _num*sizeof(UniformHandle) );
+			block.m_data       = (uint8_t*)BX_ALLOC(g_allocator, size);
+			block.m_buffer     = buffer;
+			block.m_num        = _num;
+			block.m_size       = size;
+			block.m_dirtyBegin = 0;
+			block.m_dirtyEnd   = size;
+			bx::memCopy(block.m_uniforms, _uniforms, _num*sizeof(UniformHandle) );
+			bx::memSet(block.m_data, 0, size);
+
+			uint32_t offset = 0;
+			for (uint16_t ii = 0; ii < _num; ++ii)
+			{
+				UniformRef& uniform = m_uniformRef[_uniforms[ii].idx];
+				uniform.m_block       = handle;
+				uniform.m_blockOffset = uint16_t(offset);
+				++uniform.m_refCount;
+
+				offset += getUniformBlockTypeSize(uniform.m_type)*uniform.m_num;
+			}
+
+			uint16_t flags = BGFX_BUFFER_INTERNAL_UNIFORM;
+
+			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateDynamicVertexBuffer);
+			cmdbuf.write(buffer);
+			cmdbuf.write(size);
+			cmdbuf.write(flags);
+
+			return handle;
+		}
+
+		BGFX_API_FUNC(void updateUniformBlock(UniformBlockHandle _handle, UniformHandle _uniform, const void* _value, uint16_t _num) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("updateUniformBlock", m_uniformBlockHandle, _handle);
+			BGFX_CHECK_HANDLE("updateUniformBlock", m_uniformHandle, _uniform);
+
+			const UniformRef& uniform = m_uniformRef[_uniform.idx];
+			BX_ASSERT(uniform.m_block.idx == _handle.idx
+				, "Uniform %s is not member of uniform block %d."
+				, uniform.m_name.getPtr()
+				, _handle.idx
+				);
+			if (uniform.m_block.idx != _handle.idx)
+			{
+				return;
+			}
+
+			_num = bx::min(UINT16_MAX == _num ? uniform.m_num : _num, uniform.m_num);
+
+			UniformBlockRef& block = m_uniformBlockRef[_handle.idx];
+			uint8_t* dst = &block.m_data[uniform.m_blockOffset];
+
+			if (UniformType::Mat3 == uniform.m_type)
+			{
+				const float* src = (const float*)_value;
+				for (uint32_t ii = 0, num = _num*3; ii < num; ++ii)
+				{
+					bx::memCopy(&dst[ii*16], &src[ii*3], 3*sizeof(float) );
+				}
+			}
+			else
+			{
+				bx::memCopy(dst, _value, g_uniformTypeSize[uniform.m_type]*_num);
+			}
+
+			const uint32_t begin = uniform.m_blockOffset;
+			const uint32_t end   = begin + getUniformBlockTypeSize(uniform.m_type)*_num;
+			block.m_dirtyBegin = bx::min(block.m_dirtyBegin, begin);
+			block.m_dirtyEnd   = bx::max(block.m_dirtyEnd,   end);
+		}
+
+		BGFX_API_FUNC(void destroyUniformBlock(UniformBlockHandle _handle) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("destroyUniformBlock", m_uniformBlockHandle, _handle);
+
+			UniformBlockRef& block = m_uniformBlockRef[_handle.idx];
+			for (uint16_t ii = 0; ii < block.m_num; ++ii)
+			{
+				m_uniformRef[block.m_uniforms[ii].idx].m_block.idx = kInvalidHandle;
+				destroyUniform(block.m_uniforms[ii]);
+			}
+
+			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyDynamicVertexBuffer);
+			cmdbuf.write(block.m_buffer);
+			m_submit->free(block.m_buffer);
+
+			BX_FREE(g_allocator, block.m_uniforms);
+			BX_FREE(g_allocator, block.m_data);
+			block.m_uniforms = NULL;
+			block.m_data     = NULL;
+
+			m_uniformBlockHandle.free(_handle.idx);
+		}
+
+		void updateUniformBlocks()
+		{
+			for (uint16_t ii = 0, num = m_uniformBlockHandle.getNumHandles(); ii < num; ++ii)
+			{
+				UniformBlockRef& block = m_uniformBlockRef[m_uniformBlockHandle.getHandleAt(ii)];
+
+				if (block.m_dirtyBegin < block.m_dirtyEnd)
+				{
+					const uint32_t size = block.m_dirtyEnd - block.m_dirtyBegin;
+
+					CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::UpdateDynamicVertexBuffer);
+					cmdbuf.write(block.m_buffer);
+					cmdbuf.write(block.m_dirtyBegin);
+					cmdbuf.write(size);
+					cmdbuf.write(copy(&block.m_data[block.m_dirtyBegin], size) );
+
+					block.m_dirtyBegin = UINT32_MAX;
+					block.m_dirtyEnd   = 0;
+				}
+			}
+		}
+
 		BGFX_API_FUNC(OcclusionQueryHandle createOcclusionQuery() )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -4862,7 +5330,8 @@ namespace bgfx
 
 			BGFX_CHECK_HANDLE("destroyOcclusionQuery", m_occlusionQueryHandle, _handle);
 
-			m_freeOcclusionQueryHandle[m_numFreeOcclusionQueryHandles++] = _handle;
+			bool ok = m_submit->free(_handle); BX_UNUSED(ok);
+			BX_ASSERT(ok, "Occlusion query handle %d is already destroyed!", _handle.idx);
 		}
 
 		BGFX_API_FUNC(void requestScreenShot(FrameBufferHandle _handle, const char* _filePath) )
@@ -5005,10 +5474,21 @@ namespace bgfx
 		}
 
 		void dumpViewStats();
-		void freeDynamicBuffers();
+		void freeDynamicBuffers(Frame* _frame);
 		void freeAllHandles(Frame* _frame);
+
+		// Frame whose free queues are released by the swap `_numSwaps` from now.
+		// Handles destroyed in a frame are released once every frame submitted
+		// before it is rendered, that is `m_numFrames-2` swaps later.
+		Frame* getReleaseFrame(uint32_t _numSwaps = 0)
+		{
+			return &m_frame[(m_submitIdx + 2 + _numSwaps) % m_numFrames];
+		}
+
 		void frameNoRenderWait();
 		void swap();
+		void setFrameLimits(const Init::Limits& _limits);
+		void resizeTempItems();
 
 		// render thread
 		void flip();
@@ -5021,6 +5501,7 @@ namespace bgfx
 		{
 			if (!m_singleThreaded)
 			{
+				++m_numFramesSubmitted;
 				m_apiSem.post();
 			}
 		}
@@ -5037,7 +5518,7 @@ namespace bgfx
 			bool ok = m_apiSem.wait(_msecs);
 			if (ok)
 			{
-				m_render->m_waitSubmit = bx::getHPCounter()-start;
+				m_frame[m_renderIdx].m_waitSubmit = bx::getHPCounter()-start;
 				m_submit->m_perfStats.waitSubmit = m_submit->m_waitSubmit;
 				return true;
 			}
@@ -5053,19 +5534,37 @@ namespace bgfx
 			}
 		}
 
-		void renderSemWait()
+		// Waits until render thread is left with at most `_maxFramesInFlight`
+		// submitted frames.
+		void renderSemWait(uint32_t _maxFramesInFlight = 0)
 		{
 			if (!m_singleThreaded)
 			{
 				BGFX_PROFILER_SCOPE("bgfx/Render thread wait", 0xff2040ff);
 				int64_t start = bx::getHPCounter();
-				bool ok = m_renderSem.wait();
-				BX_ASSERT(ok, "Semaphore wait failed."); BX_UNUSED(ok);
+				while (m_numFramesSubmitted - m_numFramesRendered > _maxFramesInFlight)
+				{
+					bool ok = m_renderSem.wait();
+					BX_ASSERT(ok, "Semaphore wait failed."); BX_UNUSED(ok);
+					++m_numFramesRendered;
+				}
 				m_submit->m_waitRender = bx::getHPCounter() - start;
 				m_submit->m_perfStats.waitRender = m_submit->m_waitRender;
 			}
 		}
 
+		// Counts frames render thread finished since last wait, without blocking.
+		uint32_t getNumFramesInFlight()
+		{
+			while (m_numFramesSubmitted != m_numFramesRendered
+			&&     m_renderSem.wait(0) )
+			{
+				++m_numFramesRendered;
+			}
+
+			return m_numFramesSubmitted - m_numFramesRendered;
+		}
+
 		void encoderApiWait()
 		{
 			uint16_t numEncoders = m_encoderHandle->getNumHandles();
@@ -5110,8 +5609,14 @@ namespace bgfx
 		{
 		}
 
-		void renderSemWait()
+		void renderSemWait(uint32_t _maxFramesInFlight = 0)
 		{
+			BX_UNUSED(_maxFramesInFlight);
+		}
+
+		uint32_t getNumFramesInFlight()
+		{
+			return 0;
 		}
 
 		void encoderApiWait()
@@ -5128,12 +5633,24 @@ namespace bgfx
 		uint32_t      m_numEncoders;
 		bx::HandleAlloc* m_encoderHandle;
 
-		Frame  m_frame[1+(BGFX_CONFIG_MULTITHREADED ? 1 : 0)];
+		// Frames are submitted and rendered in ring order, API thread waits for
+		// render thread only when the next frame in the ring is still in flight.
+		Frame  m_frame[BGFX_CONFIG_MULTITHREADED ? BGFX_CONFIG_MAX_FRAMES_IN_FLIGHT : 1];
 		Frame* m_render;
 		Frame* m_submit;
-
-		uint64_t m_tempKeys[BGFX_CONFIG_MAX_DRAW_CALLS];
-		RenderItemCount m_tempValues[BGFX_CONFIG_MAX_DRAW_CALLS];
+		uint32_t m_numFrames;
+		uint32_t m_renderIdx;
+		uint32_t m_submitIdx;
+		uint32_t m_numFramesSubmitted;
+		uint32_t m_numFramesRendered;
+
+		// radix sort scratch owned by render thread, sized for the frame being
+		// rendered and also reused for blit keys
+		uint64_t* m_tempKeys;
+		RenderItemCount* m_tempValues;
+		uint32_t m_maxTempItems;
+		uint32_t m_maxInitDrawCalls;
+		RadixSort m_radixSort;
 
 		IndexBuffer  m_indexBuffers[BGFX_CONFIG_MAX_INDEX_BUFFERS];
 		VertexBuffer m_vertexBuffers[BGFX_CONFIG_MAX_VERTEX_BUFFERS];
@@ -5141,13 +5658,6 @@ namespace bgfx
 		DynamicIndexBuffer  m_dynamicIndexBuffers[BGFX_CONFIG_MAX_DYNAMIC_INDEX_BUFFERS];
 		DynamicVertexBuffer m_dynamicVertexBuffers[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
 
-		uint16_t m_numFreeDynamicIndexBufferHandles;
-		uint16_t m_numFreeDynamicVertexBufferHandles;
-		uint16_t m_numFreeOcclusionQueryHandles;
-		DynamicIndexBufferHandle  m_freeDynamicIndexBufferHandle[BGFX_CONFIG_MAX_DYNAMIC_INDEX_BUFFERS];
-		DynamicVertexBufferHandle m_freeDynamicVertexBufferHandle[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
-		OcclusionQueryHandle      m_freeOcclusionQueryHandle[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
-
 		NonLocalAllocator m_dynIndexBufferAllocator;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_DYNAMIC_INDEX_BUFFERS> m_dynamicIndexBufferHandle;
 		NonLocalAllocator m_dynVertexBufferAllocator;
@@ -5162,12 +5672,15 @@ namespace bgfx
 		bx::HandleAllocT<BGFX_CONFIG_MAX_TEXTURES> m_textureHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_FRAME_BUFFERS> m_frameBufferHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORMS> m_uniformHandle;
+		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORM_BLOCKS> m_uniformBlockHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_OCCLUSION_QUERIES> m_occlusionQueryHandle;
 
 		typedef bx::HandleHashMapT<BGFX_CONFIG_MAX_UNIFORMS*2> UniformHashMap;
 		UniformHashMap m_uniformHashMap;
 		UniformRef     m_uniformRef[BGFX_CONFIG_MAX_UNIFORMS];
 
+		UniformBlockRef m_uniformBlockRef[BGFX_CONFIG_MAX_UNIFORM_BLOCKS];
+
 		typedef bx::HandleHashMapT<BGFX_CONFIG_MAX_SHADERS*2> ShaderHashMap;
 		ShaderHashMap m_shaderHashMap;
 		ShaderRef     m_shaderRef[BGFX_CONFIG_MAX_SHADERS];
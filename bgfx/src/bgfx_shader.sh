@@ -679,6 +679,28 @@ mat3 mtxFromCols(vec3 _0, vec3 _1, vec3 _2)
 #define mtxFromCols4(_0, _1, _2, _3) transpose(mat4(_0, _1, _2, _3) )
 #endif // BGFX_SHADER_LANGUAGE_GLSL
 
+#if BGFX_SHADER_LANGUAGE_SPIRV
+// shaderc shifts uniform buffer bindings by the stage's own uniform block binding (1 for
+// fragment shaders), block bindings are compensated so they end up at '_reg + 2' in every stage.
+#	if BGFX_SHADER_TYPE_FRAGMENT
+#		define UNIFORM_BLOCK_BEGIN(_name, _reg) [[vk::binding(_reg + 1)]] cbuffer _name {
+#	else
+#		define UNIFORM_BLOCK_BEGIN(_name, _reg) [[vk::binding(_reg + 2)]] cbuffer _name {
+#	endif // BGFX_SHADER_TYPE_FRAGMENT
+#	define UNIFORM_BLOCK_MEMBER(_type, _name) _type _name
+#	define UNIFORM_BLOCK_END() };
+#elif BGFX_SHADER_LANGUAGE_GLSL >= 420 || (BGFX_SHADER_LANGUAGE_GLSL >= 310 && BGFX_SHADER_LANGUAGE_GLSL < 330)
+#	define UNIFORM_BLOCK_BEGIN(_name, _reg) layout(std140, binding=_reg) uniform _name {
+#	define UNIFORM_BLOCK_MEMBER(_type, _name) _type _name
+#	define UNIFORM_BLOCK_END() };
+#else
+// HLSL, Metal and older GLSL, members are regular uniforms set from block data on every draw. Direct3D 11
+// and 12 share shader binaries and the Direct3D 12 root signature has a single constant buffer.
+#	define UNIFORM_BLOCK_BEGIN(_name, _reg)
+#	define UNIFORM_BLOCK_MEMBER(_type, _name) uniform _type _name
+#	define UNIFORM_BLOCK_END()
+#endif // BGFX_SHADER_LANGUAGE_*
+
 uniform vec4  u_viewRect;
 uniform vec4  u_viewTexel;
 uniform mat4  u_view;
@@ -221,6 +221,7 @@
 #	define BGFX_CONFIG_MULTITHREADED ( (0 == BX_PLATFORM_EMSCRIPTEN) ? 1 : 0)
 #endif // BGFX_CONFIG_MULTITHREADED
 
+/// Default value of Init::Limits::maxDrawCalls.
 #ifndef BGFX_CONFIG_MAX_DRAW_CALLS
 #	define BGFX_CONFIG_MAX_DRAW_CALLS ( (64<<10)-1)
 #endif // BGFX_CONFIG_MAX_DRAW_CALLS
@@ -229,10 +230,33 @@
 #	define BGFX_CONFIG_MAX_BLIT_ITEMS (1<<10)
 #endif // BGFX_CONFIG_MAX_BLIT_ITEMS
 
+/// Maximum number of frames shared by API and render thread.
+#ifndef BGFX_CONFIG_MAX_FRAMES_IN_FLIGHT
+#	define BGFX_CONFIG_MAX_FRAMES_IN_FLIGHT 3
+#endif // BGFX_CONFIG_MAX_FRAMES_IN_FLIGHT
+
+/// Default value of Init::Limits::maxFramesInFlight.
+#ifndef BGFX_CONFIG_DEFAULT_FRAMES_IN_FLIGHT
+#	define BGFX_CONFIG_DEFAULT_FRAMES_IN_FLIGHT 2
+#endif // BGFX_CONFIG_DEFAULT_FRAMES_IN_FLIGHT
+
+/// Maximum number of worker threads sorting draw call keys together with the
+/// API thread. Fewer are started when the machine has few cores.
+#ifndef BGFX_CONFIG_MAX_SORT_WORKERS
+#	define BGFX_CONFIG_MAX_SORT_WORKERS ( (0 != BGFX_CONFIG_MULTITHREADED) ? 3 : 0)
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS
+
+/// Draw call count below which keys are sorted on the API thread only.
+#ifndef BGFX_CONFIG_MIN_PARALLEL_SORT_ITEMS
+#	define BGFX_CONFIG_MIN_PARALLEL_SORT_ITEMS (16<<10)
+#endif // BGFX_CONFIG_MIN_PARALLEL_SORT_ITEMS
+
+/// Default value of Init::Limits::maxMatrixCache.
 #ifndef BGFX_CONFIG_MAX_MATRIX_CACHE
 #	define BGFX_CONFIG_MAX_MATRIX_CACHE (BGFX_CONFIG_MAX_DRAW_CALLS+1)
 #endif // BGFX_CONFIG_MAX_MATRIX_CACHE
 
+/// Default value of Init::Limits::maxRectCache.
 #ifndef BGFX_CONFIG_MAX_RECT_CACHE
 #	define BGFX_CONFIG_MAX_RECT_CACHE (4<<10)
 #endif //  BGFX_CONFIG_MAX_RECT_CACHE
@@ -320,6 +344,10 @@ BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS m
 #	define BGFX_CONFIG_MAX_UNIFORMS 512
 #endif // BGFX_CONFIG_MAX_UNIFORMS
 
+#ifndef BGFX_CONFIG_MAX_UNIFORM_BLOCKS
+#	define BGFX_CONFIG_MAX_UNIFORM_BLOCKS 64
+#endif // BGFX_CONFIG_MAX_UNIFORM_BLOCKS
+
 #ifndef BGFX_CONFIG_MAX_OCCLUSION_QUERIES
 #	define BGFX_CONFIG_MAX_OCCLUSION_QUERIES 256
 #endif // BGFX_CONFIG_MAX_OCCLUSION_QUERIES
@@ -0,0 +1,379 @@
+/*
+ * Copyright 2011-2022 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#include <bx/allocator.h>
+#include <bx/cpu.h>
+#include <bx/debug.h>
+#include <bx/math.h>
+#include <bx/os.h>
+
+#include "radixsort.h"
+
+namespace bgfx
+{
+	static constexpr uint32_t kBits       = 11;
+	static constexpr uint32_t kNumBuckets = 1<<kBits;
+	static constexpr uint32_t kMask       = kNumBuckets-1;
+	static constexpr uint32_t kNumPasses  = (64+kBits-1)/kBits;
+
+	// Input with at most this many descending neighbours is tried with
+	// insertion sort first, bounded to as many moves as there are keys.
+	static constexpr uint32_t kMaxNearlySortedDescents = 64;
+
+	RadixSort::RadixSort()
+		: m_allocator(NULL)
+		, m_numWorkers(0)
+		, m_minParallelSize(UINT32_MAX)
+		, m_exit(false)
+		, m_histogram(NULL)
+		, m_descents(NULL)
+		, m_keys(NULL)
+		, m_tempKeys(NULL)
+		, m_values(NULL)
+		, m_tempValues(NULL)
+		, m_size(0)
+		, m_numChunks(0)
+		, m_keyFn(NULL)
+		, m_userData(NULL)
+		, m_phase(Phase::Scan)
+		, m_pass(0)
+		, m_nextChunk(0)
+	{
+	}
+
+	RadixSort::~RadixSort()
+	{
+		BX_ASSERT(NULL == m_histogram, "RadixSort::shutdown was not called.");
+	}
+
+	void RadixSort::init(bx::AllocatorI* _allocator, uint32_t _numWorkers, uint32_t _minParallelSize)
+	{
+		m_allocator       = _allocator;
+		m_numWorkers      = bx::min<uint32_t>(_numWorkers, BGFX_CONFIG_MAX_SORT_WORKERS);
+		m_minParallelSize = bx::max<uint32_t>(_minParallelSize, m_numWorkers+1);
+		m_exit            = false;
+
+		const uint32_t maxChunks = m_numWorkers+1;
+		m_histogram = (uint32_t*)BX_ALLOC(m_allocator, (maxChunks+1)*kNumPasses*kNumBuckets*sizeof(uint32_t) );
+		m_descents  = (uint32_t*)BX_ALLOC(m_allocator, maxChunks*sizeof(uint32_t) );
+
+#if BGFX_CONFIG_MAX_SORT_WORKERS > 0
+		for (uint32_t ii = 0; ii < m_numWorkers; ++ii)
+		{
+			m_thread[ii].init(workerFn, this, 0, "bgfx - sort worker");
+		}
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS > 0
+	}
+
+	void RadixSort::shutdown()
+	{
+#if BGFX_CONFIG_MAX_SORT_WORKERS > 0
+		m_exit = true;
+		m_start.post(m_numWorkers);
+
+		for (uint32_t ii = 0; ii < m_numWorkers; ++ii)
+		{
+			m_thread[ii].shutdown();
+		}
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS > 0
+
+		m_numWorkers = 0;
+
+		BX_FREE(m_allocator, m_descents);
+		BX_FREE(m_allocator, m_histogram);
+		m_descents  = NULL;
+		m_histogram = NULL;
+	}
+
+	void RadixSort::sort(
+		  uint64_t* _keys
+		, uint64_t* _tempKeys
+		, uint32_t* _values
+		, uint32_t* _tempValues
+		, uint32_t _size
+		, RadixSortKeyFn _keyFn
+		, const void* _userData
+		)
+	{
+		if (0 == _size)
+		{
+			return;
+		}
+
+		m_keys       = _keys;
+		m_tempKeys   = _tempKeys;
+		m_values     = _values;
+		m_tempValues = _tempValues;
+		m_size       = _size;
+		m_numChunks  = _size < m_minParallelSize ? 1 : m_numWorkers+1;
+		m_keyFn      = _keyFn;
+		m_userData   = _userData;
+
+		// Scan applies the key transform, histograms every digit at once and
+		// counts descending neighbours inside each chunk.
+		dispatch(Phase::Scan, 0);
+
+		uint32_t descents = 0;
+		for (uint32_t chunk = 0; chunk < m_numChunks; ++chunk)
+		{
+			descents += m_descents[chunk];
+
+			const uint32_t begin = uint32_t(uint64_t(_size)*chunk/m_numChunks);
+			if (0 < begin
+			&&  _keys[begin-1] > _keys[begin])
+			{
+				++descents;
+			}
+		}
+
+		if (0 == descents)
+		{
+			return;
+		}
+
+		// Insertion moves keys across chunks, so histograms per chunk must be
+		// recounted if it gives up. Totals stay valid, keys are only permuted.
+		bool chunkHistogramValid = true;
+
+		if (kMaxNearlySortedDescents >= descents)
+		{
+			if (insertionSort(_size) )
+			{
+				return;
+			}
+
+			chunkHistogramValid = 1 == m_numChunks;
+		}
+
+		// Totals live past the last chunk histogram.
+		uint32_t* total = &m_histogram[(m_numWorkers+1)*kNumPasses*kNumBuckets];
+		bx::memCopy(total, m_histogram, kNumPasses*kNumBuckets*sizeof(uint32_t) );
+
+		for (uint32_t chunk = 1; chunk < m_numChunks; ++chunk)
+		{
+			const uint32_t* histogram = &m_histogram[chunk*kNumPasses*kNumBuckets];
+			for (uint32_t ii = 0; ii < kNumPasses*kNumBuckets; ++ii)
+			{
+				total[ii] += histogram[ii];
+			}
+		}
+
+		uint32_t numSwaps = 0;
+
+		for (uint32_t pass = 0; pass < kNumPasses; ++pass)
+		{
+			// Every key has the same digit, order is unchanged by this pass.
+			const uint32_t shift = pass*kBits;
+			const uint32_t digit = uint32_t(m_keys[0]>>shift) & kMask;
+			if (_size == total[pass*kNumBuckets + digit])
+			{
+				continue;
+			}
+
+			// Single chunk histogram is the total and never changes. Split
+			// input is permuted by every scatter and must be counted again.
+			if (!chunkHistogramValid)
+			{
+				dispatch(Phase::Count, pass);
+			}
+
+			chunkHistogramValid = 1 == m_numChunks;
+
+			// Turn counts into scatter offsets, chunks of the same bucket are
+			// written in chunk order to keep the sort stable.
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < kNumBuckets; ++bucket)
+			{
+				for (uint32_t chunk = 0; chunk < m_numChunks; ++chunk)
+				{
+					uint32_t& count = m_histogram[(chunk*kNumPasses + pass)*kNumBuckets + bucket];
+					const uint32_t num = count;
+					count   = offset;
+					offset += num;
+				}
+			}
+
+			dispatch(Phase::Scatter, pass);
+
+			bx::swap(m_keys,   m_tempKeys);
+			bx::swap(m_values, m_tempValues);
+			++numSwaps;
+		}
+
+		if (0 != (numSwaps & 1) )
+		{
+			bx::memCopy(_keys,   m_keys,   _size*sizeof(uint64_t) );
+			bx::memCopy(_values, m_values, _size*sizeof(uint32_t) );
+		}
+	}
+
+	void RadixSort::dispatch(Phase::Enum _phase, uint32_t _pass)
+	{
+		m_phase     = _phase;
+		m_pass      = _pass;
+		m_nextChunk = 0;
+
+#if BGFX_CONFIG_MAX_SORT_WORKERS > 0
+		if (1 < m_numChunks)
+		{
+			m_start.post(m_numWorkers);
+			runChunks();
+
+			for (uint32_t ii = 0; ii < m_numWorkers; ++ii)
+			{
+				m_done.wait();
+			}
+
+			return;
+		}
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS > 0
+
+		runChunks();
+	}
+
+	void RadixSort::runChunks()
+	{
+		for (uint32_t chunk = bx::atomicFetchAndAdd<uint32_t>(&m_nextChunk, 1)
+			; chunk < m_numChunks
+			; chunk = bx::atomicFetchAndAdd<uint32_t>(&m_nextChunk, 1)
+			)
+		{
+			runChunk(chunk);
+		}
+	}
+
+	void RadixSort::runChunk(uint32_t _chunk)
+	{
+		const uint32_t begin = uint32_t(uint64_t(m_size)*(_chunk+0)/m_numChunks);
+		const uint32_t end   = uint32_t(uint64_t(m_size)*(_chunk+1)/m_numChunks);
+
+		uint32_t* histogram = &m_histogram[_chunk*kNumPasses*kNumBuckets];
+		uint64_t* keys      = m_keys;
+
+		switch (m_phase)
+		{
+		case Phase::Scan:
+			{
+				bx::memSet(histogram, 0, kNumPasses*kNumBuckets*sizeof(uint32_t) );
+
+				uint32_t descents = 0;
+				uint64_t prev     = 0;
+
+				for (uint32_t ii = begin; ii < end; ++ii)
+				{
+					uint64_t key = keys[ii];
+					if (NULL != m_keyFn)
+					{
+						key = m_keyFn(key, m_userData);
+						keys[ii] = key;
+					}
+
+					descents += ii != begin && prev > key;
+					prev = key;
+
+					for (uint32_t pass = 0; pass < kNumPasses; ++pass)
+					{
+						++histogram[pass*kNumBuckets + (uint32_t(key>>(pass*kBits) ) & kMask)];
+					}
+				}
+
+				m_descents[_chunk] = descents;
+			}
+			break;
+
+		case Phase::Count:
+			{
+				const uint32_t shift = m_pass*kBits;
+				uint32_t* counts = &histogram[m_pass*kNumBuckets];
+				bx::memSet(counts, 0, kNumBuckets*sizeof(uint32_t) );
+
+				for (uint32_t ii = begin; ii < end; ++ii)
+				{
+					++counts[uint32_t(keys[ii]>>shift) & kMask];
+				}
+			}
+			break;
+
+		case Phase::Scatter:
+			{
+				const uint32_t shift = m_pass*kBits;
+				uint32_t* offsets = &histogram[m_pass*kNumBuckets];
+				uint64_t* dst       = m_tempKeys;
+				uint32_t* values    = m_values;
+				uint32_t* dstValues = m_tempValues;
+
+				for (uint32_t ii = begin; ii < end; ++ii)
+				{
+					const uint64_t key  = keys[ii];
+					const uint32_t dest = offsets[uint32_t(key>>shift) & kMask]++;
+					dst[dest]       = key;
+					dstValues[dest] = values[ii];
+				}
+			}
+			break;
+		}
+	}
+
+	bool RadixSort::insertionSort(uint32_t _maxMoves)
+	{
+		uint64_t* keys   = m_keys;
+		uint32_t* values = m_values;
+
+		uint32_t moves = 0;
+
+		for (uint32_t ii = 1, num = m_size; ii < num; ++ii)
+		{
+			const uint64_t key = keys[ii];
+			if (keys[ii-1] <= key)
+			{
+				continue;
+			}
+
+			const uint32_t value = values[ii];
+
+			uint32_t jj = ii;
+			for (; 0 < jj && keys[jj-1] > key; --jj)
+			{
+				keys[jj]   = keys[jj-1];
+				values[jj] = values[jj-1];
+			}
+
+			keys[jj]   = key;
+			values[jj] = value;
+
+			moves += ii - jj;
+			if (moves > _maxMoves)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+#if BGFX_CONFIG_MAX_SORT_WORKERS > 0
+	int32_t RadixSort::workerFn(bx::Thread* _thread, void* _userData)
+	{
+		BX_UNUSED(_thread);
+		RadixSort* radixSort = (RadixSort*)_userData;
+
+		for (;;)
+		{
+			radixSort->m_start.wait();
+
+			if (radixSort->m_exit)
+			{
+				break;
+			}
+
+			radixSort->runChunks();
+			radixSort->m_done.post();
+		}
+
+		return 0;
+	}
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS > 0
+
+} // namespace bgfx
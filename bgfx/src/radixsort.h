@@ -0,0 +1,121 @@
+/*
+ * Copyright 2011-2022 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx/blob/master/LICENSE
+ */
+
+#ifndef BGFX_RADIXSORT_H_HEADER_GUARD
+#define BGFX_RADIXSORT_H_HEADER_GUARD
+
+#include <bx/allocator.h>
+#include <bx/semaphore.h>
+#include <bx/thread.h>
+
+#include "config.h"
+
+namespace bgfx
+{
+	/// Key transform applied while keys are scanned, e.g. view remapping.
+	typedef uint64_t (*RadixSortKeyFn)(uint64_t _key, const void* _userData);
+
+	/// Stable LSD radix sort of 64-bit keys with 32-bit values. Large inputs are
+	/// split into chunks histogrammed and scattered by worker threads together
+	/// with the calling thread. Sorted input returns after a single scan, nearly
+	/// sorted input is fixed up by insertion, and passes whose digit is the same
+	/// for every key are skipped.
+	///
+	class RadixSort
+	{
+		BX_CLASS(RadixSort
+			, NO_COPY
+			, NO_ASSIGNMENT
+			);
+
+	public:
+		///
+		RadixSort();
+
+		///
+		~RadixSort();
+
+		/// Starts worker threads, zero workers sorts on the calling thread only.
+		///
+		/// @param[in] _allocator Allocator for per chunk histograms.
+		/// @param[in] _numWorkers Number of worker threads.
+		/// @param[in] _minParallelSize Inputs smaller than this are not split.
+		///
+		void init(bx::AllocatorI* _allocator, uint32_t _numWorkers, uint32_t _minParallelSize);
+
+		///
+		void shutdown();
+
+		/// Sorts keys and values in place.
+		///
+		/// @param[in] _keys Keys, transformed by `_keyFn` before sorting when set.
+		/// @param[in] _tempKeys Scratch keys, at least `_size` items.
+		/// @param[in] _values Values moved along with keys.
+		/// @param[in] _tempValues Scratch values, at least `_size` items.
+		/// @param[in] _size Number of keys.
+		/// @param[in] _keyFn Optional key transform.
+		/// @param[in] _userData User data passed to `_keyFn`.
+		///
+		void sort(
+			  uint64_t* _keys
+			, uint64_t* _tempKeys
+			, uint32_t* _values
+			, uint32_t* _tempValues
+			, uint32_t _size
+			, RadixSortKeyFn _keyFn = NULL
+			, const void* _userData = NULL
+			);
+
+	private:
+		struct Phase
+		{
+			enum Enum
+			{
+				Scan,
+				Count,
+				Scatter,
+			};
+		};
+
+		void dispatch(Phase::Enum _phase, uint32_t _pass);
+		void runChunks();
+		void runChunk(uint32_t _chunk);
+		bool insertionSort(uint32_t _maxMoves);
+
+#if BGFX_CONFIG_MAX_SORT_WORKERS > 0
+		static int32_t workerFn(bx::Thread* _thread, void* _userData);
+
+		bx::Thread    m_thread[BGFX_CONFIG_MAX_SORT_WORKERS];
+		bx::Semaphore m_start;
+		bx::Semaphore m_done;
+#endif // BGFX_CONFIG_MAX_SORT_WORKERS > 0
+
+		bx::AllocatorI* m_allocator;
+		uint32_t m_numWorkers;
+		uint32_t m_minParallelSize;
+		bool     m_exit;
+
+		// Per chunk histograms of every pass, and per chunk count of descending
+		// neighbours found while scanning.
+		uint32_t* m_histogram;
+		uint32_t* m_descents;
+
+		// Current sort, published to workers by posting m_start.
+		uint64_t*      m_keys;
+		uint64_t*      m_tempKeys;
+		uint32_t*      m_values;
+		uint32_t*      m_tempValues;
+		uint32_t       m_size;
+		uint32_t       m_numChunks;
+		RadixSortKeyFn m_keyFn;
+		const void*    m_userData;
+		Phase::Enum    m_phase;
+		uint32_t       m_pass;
+		uint32_t       m_nextChunk;
+	};
+
+} // namespace bgfx
+
+#endif // BGFX_RADIXSORT_H_HEADER_GUARD
@@ -2045,9 +2045,15 @@ namespace bgfx { namespace d3d11
 				);
 		}
 
-		void updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
+		bool updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
 		{
+			if (0 == bx::memCmp(m_uniforms[_loc], _data, _size) )
+			{
+				return false;
+			}
+
 			bx::memCopy(m_uniforms[_loc], _data, _size);
+			return true;
 		}
 
 		void invalidateOcclusionQuery(OcclusionQueryHandle _handle) override
@@ -2148,7 +2154,7 @@ namespace bgfx { namespace d3d11
 			uint8_t flags = predefined.m_type;
 			setShaderUniform(flags, predefined.m_loc, proj, 4);
 
-			commitShaderConstants();
+			commitShaderConstants(true);
 			m_textures[_blitter.m_texture.idx].commit(0, BGFX_SAMPLER_INTERNAL_DEFAULT, NULL);
 			commitTextureStage();
 		}
@@ -2520,15 +2526,23 @@ namespace bgfx { namespace d3d11
 
 		void setShaderUniform(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
 		{
+			const uint32_t size = _numRegs*16;
+
 			if (_flags&kUniformFragmentBit)
 			{
-				bx::memCopy(&m_fsScratch[_regIndex], _val, _numRegs*16);
-				m_fsChanges += _numRegs;
+				if (0 != bx::memCmp(&m_fsScratch[_regIndex], _val, size) )
+				{
+					bx::memCopy(&m_fsScratch[_regIndex], _val, size);
+					m_fsChanges += _numRegs;
+				}
 			}
 			else
 			{
-				bx::memCopy(&m_vsScratch[_regIndex], _val, _numRegs*16);
-				m_vsChanges += _numRegs;
+				if (0 != bx::memCmp(&m_vsScratch[_regIndex], _val, size) )
+				{
+					bx::memCopy(&m_vsScratch[_regIndex], _val, size);
+					m_vsChanges += _numRegs;
+				}
 			}
 		}
 
@@ -2542,9 +2556,12 @@ namespace bgfx { namespace d3d11
 			setShaderUniform(_flags, _regIndex, _val, _numRegs);
 		}
 
-		void commitShaderConstants()
+		// Scratch is shared by all programs, each shader constant buffer must be
+		// updated after switching program even if scratch didn't change.
+		void commitShaderConstants(bool _force = false)
 		{
-			if (0 < m_vsChanges)
+			if (_force
+			||  0 < m_vsChanges)
 			{
 				if (NULL != m_currentProgram->m_vsh->m_buffer)
 				{
@@ -2554,9 +2571,11 @@ namespace bgfx { namespace d3d11
 				m_vsChanges = 0;
 			}
 
-			if (0 < m_fsChanges)
+			if (_force
+			||  0 < m_fsChanges)
 			{
-				if (NULL != m_currentProgram->m_fsh->m_buffer)
+				if (NULL != m_currentProgram->m_fsh
+				&&  NULL != m_currentProgram->m_fsh->m_buffer)
 				{
 					m_deviceCtx->UpdateSubresource(m_currentProgram->m_fsh->m_buffer, 0, 0, m_fsScratch, 0, 0);
 				}
@@ -5721,8 +5740,7 @@ namespace bgfx { namespace d3d11
 					const RenderCompute& compute = renderItem.compute;
 
 					bool programChanged = false;
-					bool constantsChanged = compute.m_uniformBegin < compute.m_uniformEnd;
-					rendererUpdateUniforms(this, _render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
+					bool constantsChanged = rendererUpdateUniforms(this, _render, compute.m_uniformIdx, compute.m_uniformBegin, compute.m_uniformEnd);
 
 					if (key.m_program.idx != currentProgram.idx)
 					{
@@ -5756,7 +5774,7 @@ namespace bgfx { namespace d3d11
 						if (constantsChanged
 						||  program.m_numPredefined > 0)
 						{
-							commitShaderConstants();
+							commitShaderConstants(programChanged);
 						}
 					}
 					BX_UNUSED(programChanged);
@@ -6012,8 +6030,7 @@ namespace bgfx { namespace d3d11
 				}
 
 				bool programChanged = false;
-				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
-				rendererUpdateUniforms(this, _render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
+				bool constantsChanged = rendererUpdateUniforms(this, _render, draw.m_uniformIdx, draw.m_uniformBegin, draw.m_uniformEnd);
 
 				if (key.m_program.idx != currentProgram.idx)
 				{
@@ -6079,7 +6096,7 @@ namespace bgfx { namespace d3d11
 					if (constantsChanged
 					||  program.m_numPredefined > 0)
 					{
-						commitShaderConstants();
+						commitShaderConstants(programChanged);
 					}
 				}
 
@@ -6135,6 +6152,13 @@ namespace bgfx { namespace d3d11
 										m_textureStage.m_uav[stage]     = NULL;
 									}
 									break;
+
+								case Binding::UniformBuffer:
+									// Uniform block members are written into the constant buffer by the frontend.
+									m_textureStage.m_srv[stage]     = NULL;
+									m_textureStage.m_sampler[stage] = NULL;
+									m_textureStage.m_uav[stage]     = NULL;
+									break;
 								}
 							}
 							else
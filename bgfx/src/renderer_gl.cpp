@@ -2181,6 +2181,7 @@ namespace bgfx { namespace gl
 			, m_occlusionQuerySupport(false)
 			, m_atocSupport(false)
 			, m_conservativeRasterSupport(false)
+			, m_uniformBufferSupport(false)
 			, m_flip(false)
 			, m_hash( (BX_PLATFORM_WINDOWS<<1) | BX_ARCH_64BIT)
 			, m_backBufferFbo(0)
@@ -2933,6 +2934,11 @@ namespace bgfx { namespace gl
 					|| s_extension[Extension::EXT_shader_image_load_store].m_supported
 					;
 
+				m_uniformBufferSupport = false
+					|| BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGLES >= 30)
+					|| s_extension[Extension::ARB_uniform_buffer_object].m_supported
+					;
+
 				g_caps.supported |= 0
 					| (m_atocSupport               ? BGFX_CAPS_ALPHA_TO_COVERAGE      : 0)
 					| (m_conservativeRasterSupport ? BGFX_CAPS_CONSERVATIVE_RASTER    : 0)
@@ -3519,9 +3525,15 @@ namespace bgfx { namespace gl
 				);
 		}
 
-		void updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
+		bool updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
 		{
+			if (0 == bx::memCmp(m_uniforms[_loc], _data, _size) )
+			{
+				return false;
+			}
+
 			bx::memCopy(m_uniforms[_loc], _data, _size);
+			return true;
 		}
 
 		void invalidateOcclusionQuery(OcclusionQueryHandle _handle) override
@@ -4534,6 +4546,7 @@ namespace bgfx { namespace gl
 		bool m_atocSupport;
 		bool m_conservativeRasterSupport;
 		bool m_imageLoadStoreSupport;
+		bool m_uniformBufferSupport;
 		bool m_flip;
 
 		uint64_t m_hash;
@@ -4952,6 +4965,13 @@ namespace bgfx { namespace gl
 				loc = glGetUniformLocation(m_id, name);
 			}
 
+			if (-1 == loc)
+			{
+				// Uniform block member, it's read from buffer bound to block.
+				BX_TRACE("\tuniform %s %s is in uniform block", glslTypeName(gltype), name);
+				continue;
+			}
+
 			num = bx::uint32_max(num, 1);
 
 			int32_t offset = 0;
@@ -7407,6 +7427,9 @@ namespace bgfx { namespace gl
 						ProgramGL& program = m_program[key.m_program.idx];
 						setProgram(program.m_id);
 
+						const bool programChanged = key.m_program.idx != currentProgram.idx;
+						currentProgram = key.m_program;
+
 						GLbitfield barrier = 0;
 						for (uint32_t ii = 0; ii < maxComputeBindings; ++ii)
 						{
@@ -7452,14 +7475,24 @@ namespace bgfx { namespace gl
 										barrier |= GL_SHADER_STORAGE_BARRIER_BIT;
 									}
 									break;
+
+								case Binding::UniformBuffer:
+									if (m_uniformBufferSupport)
+									{
+										const VertexBufferGL& buffer = m_vertexBuffers[bind.m_idx];
+										GL_CHECK(glBindBufferBase(GL_UNIFORM_BUFFER, ii, buffer.m_id) );
+									}
+									break;
 								}
 							}
 						}
 
 						if (0 != barrier)
 						{
-							bool constantsChanged = compute.m_uniformBegin < compute.m_uniformEnd;
-							rendererUpdateUniforms(this, _render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
+							const bool constantsChanged = false
+								|| rendererUpdateUniforms(this, _render, compute.m_uniformIdx, compute.m_uniformBegin, compute.m_uniformEnd)
+								|| programChanged
+								;
 
 							if (constantsChanged
 							&&  NULL != program.m_constantBuffer)
@@ -7892,9 +7925,8 @@ namespace bgfx { namespace gl
 				}
 
 				bool programChanged = false;
-				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
+				bool constantsChanged = rendererUpdateUniforms(this, _render, draw.m_uniformIdx, draw.m_uniformBegin, draw.m_uniformEnd);
 				bool bindAttribs = false;
-				rendererUpdateUniforms(this, _render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				if (key.m_program.idx != currentProgram.idx)
 				{
@@ -7972,6 +8004,14 @@ namespace bgfx { namespace gl
 											GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, stage, buffer.m_id) );
 										}
 										break;
+
+									case Binding::UniformBuffer:
+										if (m_uniformBufferSupport)
+										{
+											const VertexBufferGL& buffer = m_vertexBuffers[bind.m_idx];
+											GL_CHECK(glBindBufferBase(GL_UNIFORM_BUFFER, stage, buffer.m_id) );
+										}
+										break;
 									}
 								}
 							}
@@ -843,6 +843,10 @@ typedef uint64_t GLuint64;
 #	define GL_SHADER_STORAGE_BUFFER 0x90D2
 #endif // GL_SHADER_STORAGE_BUFFER
 
+#ifndef GL_UNIFORM_BUFFER
+#	define GL_UNIFORM_BUFFER 0x8A11
+#endif // GL_UNIFORM_BUFFER
+
 #ifndef GL_IMAGE_1D
 #	define GL_IMAGE_1D 0x904C
 #endif // GL_IMAGE_1D
@@ -223,8 +223,9 @@ namespace bgfx { namespace noop
 		{
 		}
 
-		void updateUniform(uint16_t /*_loc*/, const void* /*_data*/, uint32_t /*_size*/) override
+		bool updateUniform(uint16_t /*_loc*/, const void* /*_data*/, uint32_t /*_size*/) override
 		{
+			return true;
 		}
 
 		void invalidateOcclusionQuery(OcclusionQueryHandle /*_handle*/) override
@@ -244,11 +245,42 @@ namespace bgfx { namespace noop
 			const int64_t timerFreq = bx::getHPFrequency();
 			const int64_t timeBegin = bx::getHPCounter();
 
+			// Sort and walk the submitted calls like the other backends do, so headless runs
+			// measure the API side cost of a frame.
+			_render->sort();
+
+			uint32_t statsKeyType[2] = {};
+			SortKey key;
+			for (uint32_t item = 0, numItems = _render->m_numRenderItems; item < numItems; ++item)
+			{
+				const bool isCompute = key.decode(_render->m_sortKeys[item], _render->m_viewRemap);
+				statsKeyType[isCompute]++;
+
+				const RenderItem& renderItem = _render->m_renderItem[_render->m_sortValues[item] ];
+				if (isCompute)
+				{
+					const RenderCompute& compute = renderItem.compute;
+					rendererUpdateUniforms(this, _render, compute.m_uniformIdx, compute.m_uniformBegin, compute.m_uniformEnd);
+				}
+				else
+				{
+					const RenderDraw& draw = renderItem.draw;
+					rendererUpdateUniforms(this, _render, draw.m_uniformIdx, draw.m_uniformBegin, draw.m_uniformEnd);
+				}
+			}
+
+			const int64_t timeEnd = bx::getHPCounter();
+
 			Stats& perfStats = _render->m_perfStats;
 			perfStats.cpuTimeBegin  = timeBegin;
-			perfStats.cpuTimeEnd    = timeBegin;
+			perfStats.cpuTimeEnd    = timeEnd;
 			perfStats.cpuTimerFreq  = timerFreq;
 
+			perfStats.numDraw       = statsKeyType[0];
+			perfStats.numCompute    = statsKeyType[1];
+			perfStats.numBlit       = _render->m_numBlitItems;
+			perfStats.maxGpuLatency = 0;
+
 			perfStats.gpuTimeBegin  = 0;
 			perfStats.gpuTimeEnd    = 0;
 			perfStats.gpuTimerFreq  = 1000000000;
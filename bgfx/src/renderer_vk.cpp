@@ -1063,6 +1063,8 @@ VK_IMPORT_DEVICE
 			, m_captureBuffer(VK_NULL_HANDLE)
 			, m_captureMemory(VK_NULL_HANDLE)
 			, m_captureSize(0)
+			, m_vsChanges(0)
+			, m_fsChanges(0)
 		{
 		}
 
@@ -1875,6 +1877,7 @@ VK_IMPORT_DEVICE
 					{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          MAX_DESCRIPTOR_SETS * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS },
 					{ VK_DESCRIPTOR_TYPE_SAMPLER,                MAX_DESCRIPTOR_SETS * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS },
 					{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, MAX_DESCRIPTOR_SETS * 2                                },
+					{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         MAX_DESCRIPTOR_SETS * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS },
 					{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         MAX_DESCRIPTOR_SETS * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS },
 					{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          MAX_DESCRIPTOR_SETS * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS },
 				};
@@ -1912,7 +1915,7 @@ VK_IMPORT_DEVICE
 
 			{
 				const uint32_t size = 128;
-				const uint32_t count = BGFX_CONFIG_MAX_DRAW_CALLS;
+				const uint32_t count = g_caps.limits.maxDrawCalls;
 				for (uint32_t ii = 0; ii < m_numFramesInFlight; ++ii)
 				{
 					BX_TRACE("Create scratch buffer %d", ii);
@@ -2420,9 +2423,15 @@ VK_IMPORT_DEVICE
 				);
 		}
 
-		void updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
+		bool updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
 		{
+			if (0 == bx::memCmp(m_uniforms[_loc], _data, _size) )
+			{
+				return false;
+			}
+
 			bx::memCopy(m_uniforms[_loc], _data, _size);
+			return true;
 		}
 
 		void invalidateOcclusionQuery(OcclusionQueryHandle _handle) override
@@ -2735,13 +2744,23 @@ VK_IMPORT_DEVICE
 
 		void setShaderUniform(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
 		{
+			const uint32_t size = _numRegs*16;
+
 			if (_flags & kUniformFragmentBit)
 			{
-				bx::memCopy(&m_fsScratch[_regIndex], _val, _numRegs*16);
+				if (0 != bx::memCmp(&m_fsScratch[_regIndex], _val, size) )
+				{
+					bx::memCopy(&m_fsScratch[_regIndex], _val, size);
+					m_fsChanges += _numRegs;
+				}
 			}
 			else
 			{
-				bx::memCopy(&m_vsScratch[_regIndex], _val, _numRegs*16);
+				if (0 != bx::memCmp(&m_vsScratch[_regIndex], _val, size) )
+				{
+					bx::memCopy(&m_vsScratch[_regIndex], _val, size);
+					m_vsChanges += _numRegs;
+				}
 			}
 		}
 
@@ -3799,6 +3818,7 @@ VK_IMPORT_DEVICE
 
 					case Binding::VertexBuffer:
 					case Binding::IndexBuffer:
+					case Binding::UniformBuffer:
 						{
 							wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 							wds[wdsCount].pNext            = NULL;
@@ -3806,14 +3826,17 @@ VK_IMPORT_DEVICE
 							wds[wdsCount].dstBinding       = bindInfo.binding;
 							wds[wdsCount].dstArrayElement  = 0;
 							wds[wdsCount].descriptorCount  = 1;
-							wds[wdsCount].descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+							wds[wdsCount].descriptorType   = bind.m_type == Binding::UniformBuffer
+								? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+								: VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+								;
 							wds[wdsCount].pImageInfo       = NULL;
 							wds[wdsCount].pBufferInfo      = NULL;
 							wds[wdsCount].pTexelBufferView = NULL;
 
-							const BufferVK& sb = bind.m_type == Binding::VertexBuffer
-								? m_vertexBuffers[bind.m_idx]
-								: m_indexBuffers[bind.m_idx]
+							const BufferVK& sb = bind.m_type == Binding::IndexBuffer
+								? m_indexBuffers[bind.m_idx]
+								: m_vertexBuffers[bind.m_idx]
 								;
 
 							bufferInfo[bufferCount].buffer = sb.m_buffer;
@@ -4419,6 +4442,8 @@ VK_IMPORT_DEVICE
 
 		uint8_t m_fsScratch[64<<10];
 		uint8_t m_vsScratch[64<<10];
+		uint32_t m_vsChanges;
+		uint32_t m_fsChanges;
 
 		FrameBufferHandle m_fbh;
 	};
@@ -4614,6 +4639,7 @@ VK_DESTROY
 
 		const bool storage  = m_flags & BGFX_BUFFER_COMPUTE_READ_WRITE;
 		const bool indirect = m_flags & BGFX_BUFFER_DRAW_INDIRECT;
+		const bool uniform  = m_flags & BGFX_BUFFER_INTERNAL_UNIFORM;
 
 		VkBufferCreateInfo bci;
 		bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -4624,6 +4650,7 @@ VK_DESTROY
 			| (_vertex              ? VK_BUFFER_USAGE_VERTEX_BUFFER_BIT   : VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
 			| (storage || indirect  ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT  : 0)
 			| (indirect             ? VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT : 0)
+			| (uniform              ? VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT  : 0)
 			| VK_BUFFER_USAGE_TRANSFER_DST_BIT
 			;
 		bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -4822,6 +4849,17 @@ VK_DESTROY
 						m_predefined[m_numPredefined].m_type  = uint8_t(predefined|fragmentBit);
 						m_numPredefined++;
 					}
+					else if (UniformType::End == (~kUniformMask & type)
+					&&       DescriptorType::UniformBuffer == idToDescriptorType(regCount) )
+					{
+						const uint16_t stage = regIndex - kSpirvBindShift; // regIndex is used for uniform block binding index
+
+						m_bindInfo[stage].type          = BindType::UniformBuffer;
+						m_bindInfo[stage].uniformHandle = { 0 };
+						m_bindInfo[stage].binding       = regIndex;
+
+						kind = "block";
+					}
 					else if (UniformType::End == (~kUniformMask & type) )
 					{
 						// regCount is used for descriptor type
@@ -5015,6 +5053,18 @@ VK_DESTROY
 				}
 				break;
 
+				case BindType::UniformBuffer:
+				{
+					VkDescriptorSetLayoutBinding& binding = m_bindings[bidx];
+					binding.stageFlags = shaderStage;
+					binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+					binding.binding = m_bindInfo[ii].binding;
+					binding.pImmutableSamplers = NULL;
+					binding.descriptorCount = 1;
+					bidx++;
+				}
+				break;
+
 				case BindType::Sampler:
 				{
 					VkDescriptorSetLayoutBinding& textureBinding = m_bindings[bidx];
@@ -8071,6 +8121,9 @@ VK_DESTROY
 
 		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
 		bool hasPredefined = false;
+		bool uniformsChanged = false;
+		uint32_t currentNumOffset = 0;
+		uint32_t currentOffsets[2] = { 0, 0 };
 		VkPipeline currentPipeline = VK_NULL_HANDLE;
 		VkDescriptorSet currentDescriptorSet = VK_NULL_HANDLE;
 		uint32_t currentBindHash = 0;
@@ -8269,7 +8322,7 @@ VK_DESTROY
 					if (compute.m_uniformBegin < compute.m_uniformEnd
 					||  currentProgram.idx != key.m_program.idx)
 					{
-						rendererUpdateUniforms(this, _render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
+						rendererUpdateUniforms(this, _render, compute.m_uniformIdx, compute.m_uniformBegin, compute.m_uniformEnd);
 
 						currentProgram = key.m_program;
 						ProgramVK& program = m_program[currentProgram.idx];
@@ -8369,7 +8422,10 @@ VK_DESTROY
 
 				const RenderDraw& draw = renderItem.draw;
 
-				rendererUpdateUniforms(this, _render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
+				// Draw may be skipped before committing, keep changes until the next commit.
+				uniformsChanged = rendererUpdateUniforms(this, _render, draw.m_uniformIdx, draw.m_uniformBegin, draw.m_uniformEnd)
+					|| uniformsChanged
+					;
 
 				const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
 				{
@@ -8563,12 +8619,13 @@ VK_DESTROY
 						}
 					}
 
-					bool constantsChanged = false;
-					if (draw.m_uniformBegin < draw.m_uniformEnd
-					||  currentProgram.idx != key.m_program.idx
+					const bool programChanged = currentProgram.idx != key.m_program.idx;
+					if (uniformsChanged
+					||  programChanged
 					||  BGFX_STATE_ALPHA_REF_MASK & changedFlags)
 					{
-						currentProgram = key.m_program;
+						uniformsChanged = false;
+						currentProgram  = key.m_program;
 						ProgramVK& program = m_program[currentProgram.idx];
 
 						UniformBuffer* vcb = program.m_vsh->m_constantBuffer;
@@ -8587,7 +8644,6 @@ VK_DESTROY
 						}
 
 						hasPredefined = 0 < program.m_numPredefined;
-						constantsChanged = true;
 					}
 
 					const ProgramVK& program = m_program[currentProgram.idx];
@@ -8603,21 +8659,28 @@ VK_DESTROY
 					{
 						const uint32_t vsize = program.m_vsh->m_size;
 						const uint32_t fsize = NULL != program.m_fsh ? program.m_fsh->m_size : 0;
-						uint32_t numOffset = 0;
-						uint32_t offsets[2] = { 0, 0 };
 
-						if (constantsChanged
-						||  hasPredefined)
+						// Scratch is shared by all programs, it's written again after
+						// switching program even if unchanged. Otherwise constants
+						// written by previous draw are reused.
+						if (programChanged
+						||  0 < m_vsChanges
+						||  0 < m_fsChanges)
 						{
+							currentNumOffset = 0;
+
 							if (vsize > 0)
 							{
-								offsets[numOffset++] = scratchBuffer.write(m_vsScratch, vsize);
+								currentOffsets[currentNumOffset++] = scratchBuffer.write(m_vsScratch, vsize);
 							}
 
 							if (fsize > 0)
 							{
-								offsets[numOffset++] = scratchBuffer.write(m_fsScratch, fsize);
+								currentOffsets[currentNumOffset++] = scratchBuffer.write(m_fsScratch, fsize);
 							}
+
+							m_vsChanges = 0;
+							m_fsChanges = 0;
 						}
 
 						bx::HashMurmur2A hash;
@@ -8649,8 +8712,8 @@ VK_DESTROY
 							, 0
 							, 1
 							, &currentDescriptorSet
-							, numOffset
-							, offsets
+							, currentNumOffset
+							, currentOffsets
 							);
 					}
 
@@ -421,6 +421,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 			Buffer,
 			Image,
 			Sampler,
+			UniformBuffer,
 
 			Count
 		};
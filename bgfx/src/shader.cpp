@@ -23,6 +23,7 @@ namespace bgfx
 		// unique and should not be changed if new DescriptorTypes are added.
 		{ DescriptorType::StorageBuffer, 0x0007 },
 		{ DescriptorType::StorageImage,  0x0003 },
+		{ DescriptorType::UniformBuffer, 0x0006 },
 	};
 	BX_STATIC_ASSERT(BX_COUNTOF(s_descriptorTypeToId) == DescriptorType::Count);
 
@@ -16,6 +16,7 @@ namespace bgfx
 		{
 			StorageBuffer,
 			StorageImage,
+			UniformBuffer,
 
 			Count
 		};
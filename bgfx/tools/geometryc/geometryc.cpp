@@ -94,6 +94,14 @@ struct Primitive
 
 typedef stl::vector<Primitive> PrimitiveArray;
 
+struct Lod
+{
+	float m_error;
+	stl::vector<uint32_t> m_indices;
+};
+
+typedef stl::vector<Lod> LodArray;
+
 struct Axis
 {
 	enum Enum
@@ -156,17 +164,27 @@ constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0
 constexpr uint32_t kChunkIndexBuffer            = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
 constexpr uint32_t kChunkIndexBufferCompressed  = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
 constexpr uint32_t kChunkPrimitive              = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
-
-void optimizeVertexCache(uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
+constexpr uint32_t kChunkIndexBufferLod         = BX_MAKEFOURCC('I', 'B', 'L', 0x0);
+constexpr uint32_t kChunkIndexBufferLodCompressed = BX_MAKEFOURCC('I', 'B', 'L', 0x1);
+
+// groups with more than 65535 vertices store a 32-bit vertex count and 32-bit indices
+constexpr uint32_t kChunkVertexBuffer32             = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+constexpr uint32_t kChunkVertexBufferCompressed32   = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+constexpr uint32_t kChunkIndexBuffer32              = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+constexpr uint32_t kChunkIndexBufferCompressed32    = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
+constexpr uint32_t kChunkIndexBufferLod32           = BX_MAKEFOURCC('I', 'B', 'L', 0x2);
+constexpr uint32_t kChunkIndexBufferLodCompressed32 = BX_MAKEFOURCC('I', 'B', 'L', 0x3);
+
+void optimizeVertexCache(uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
 {
-	uint16_t* newIndexList = new uint16_t[_numIndices];
+	uint32_t* newIndexList = new uint32_t[_numIndices];
 	meshopt_optimizeVertexCache(newIndexList, _indices, _numIndices, _numVertices);
-	bx::memCopy(_indices, newIndexList, _numIndices * 2);
+	bx::memCopy(_indices, newIndexList, _numIndices * sizeof(uint32_t) );
 	delete[] newIndexList;
 }
 
 uint32_t optimizeVertexFetch(
-	  uint16_t* _indices
+	  uint32_t* _indices
 	, uint32_t _numIndices
 	, uint8_t* _vertexData
 	, uint32_t _numVertices
@@ -181,11 +199,73 @@ uint32_t optimizeVertexFetch(
 	return uint32_t(vertexCount);
 }
 
+// Simplified index buffers over the same vertices, each level targets half the indices of the
+// previous one. Every level is simplified from the full resolution indices so its error is
+// relative to the original surface, levels stop once the simplifier cannot reach the target
+// within _maxError. The stored error is absolute, in mesh units.
+void generateLods(
+	  LodArray& _lods
+	, const uint32_t* _indices
+	, uint32_t _numIndices
+	, const uint8_t* _vertices
+	, uint32_t _numVertices
+	, const bgfx::VertexLayout& _layout
+	, uint32_t _numLods
+	, float _maxError
+	)
+{
+	_lods.clear();
+
+	const uint16_t stride = _layout.getStride();
+	const float* positions = (const float*)(_vertices + _layout.getOffset(bgfx::Attrib::Position) );
+	const float scale = meshopt_simplifyScale(positions, _numVertices, stride);
+
+	uint32_t prevNumIndices = _numIndices;
+	for (uint32_t lod = 0; lod < _numLods; ++lod)
+	{
+		const size_t target = (_numIndices >> (lod + 1) ) / 3 * 3;
+
+		Lod level;
+		level.m_indices.resize(_numIndices);
+		float error = 0.0f;
+		const size_t numIndices = meshopt_simplify(
+			  level.m_indices.data()
+			, _indices
+			, _numIndices
+			, positions
+			, _numVertices
+			, stride
+			, target
+			, _maxError
+			, &error
+			);
+
+		// stop when the level is not meaningfully smaller than the previous one
+		if (0 == numIndices
+		||  numIndices > prevNumIndices * 3 / 4)
+		{
+			break;
+		}
+
+		level.m_indices.resize(numIndices);
+		level.m_error = error * scale;
+		optimizeVertexCache(level.m_indices.data(), uint32_t(numIndices), _numVertices);
+		_lods.push_back(level);
+
+		bx::printf("LOD %d: indices %10d, error %f\n", lod + 1, uint32_t(numIndices), level.m_error);
+
+		prevNumIndices = uint32_t(numIndices);
+	}
+}
+
+// Index values are encoded independently of their width, _indexSize only matters to the
+// size reported here and to the decoder.
 void writeCompressedIndices(
 	  bx::WriterI* _writer
-	, const uint16_t* _indices
+	, const uint32_t* _indices
 	, uint32_t _numIndices
 	, uint32_t _numVertices
+	, uint32_t _indexSize
 	, bx::Error* _err
 	)
 {
@@ -195,9 +275,9 @@ void writeCompressedIndices(
 	size_t compressedSize = meshopt_encodeIndexBuffer(compressedIndices, maxSize, _indices, _numIndices);
 
 	bx::printf("Indices uncompressed: %10d, compressed: %10d, ratio: %0.2f%%\n"
-		, _numIndices*2
+		, _numIndices*_indexSize
 		, (uint32_t)compressedSize
-		, 100.0f - float(compressedSize ) / float(_numIndices*2)*100.0f
+		, 100.0f - float(compressedSize ) / float(_numIndices*_indexSize)*100.0f
 		);
 
 	bx::write(_writer, (uint32_t)compressedSize, _err);
@@ -206,6 +286,29 @@ void writeCompressedIndices(
 	free(compressedIndices);
 }
 
+void writeIndices(
+	  bx::WriterI* _writer
+	, const uint32_t* _indices
+	, uint32_t _numIndices
+	, bool _index32
+	, bx::Error* _err
+	)
+{
+	if (_index32)
+	{
+		bx::write(_writer, _indices, _numIndices*sizeof(uint32_t), _err);
+		return;
+	}
+
+	stl::vector<uint16_t> indices(_numIndices);
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		indices[ii] = uint16_t(_indices[ii]);
+	}
+
+	bx::write(_writer, indices.data(), _numIndices*sizeof(uint16_t), _err);
+}
+
 void writeCompressedVertices(
 	  bx::WriterI* _writer
 	, const uint8_t* _vertices
@@ -231,7 +334,7 @@ void writeCompressedVertices(
 	free(compressedVertices);
 }
 
-void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _layout, const uint16_t* _indices, uint32_t _numIndices)
+void calcTangents(void* _vertices, uint32_t _numVertices, bgfx::VertexLayout _layout, const uint32_t* _indices, uint32_t _numIndices)
 {
 	struct PosTexcoord
 	{
@@ -254,7 +357,7 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 
 	for (uint32_t ii = 0, num = _numIndices/3; ii < num; ++ii)
 	{
-		const uint16_t* indices = &_indices[ii*3];
+		const uint32_t* indices = &_indices[ii*3];
 		uint32_t i0 = indices[0];
 		uint32_t i1 = indices[1];
 		uint32_t i2 = indices[2];
@@ -328,6 +431,112 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 	delete [] tangents;
 }
 
+// Converts vertices with float normal and tangent into a layout where the whole tangent frame
+// is a single quaternion stored in bgfx::Attrib::Tangent. Handedness of the bitangent is kept
+// in the sign of w, so w is biased away from zero to survive 8-bit packing.
+void encodeTangentFrame(
+	  void* _dstVertices
+	, const bgfx::VertexLayout& _dstLayout
+	, const void* _srcVertices
+	, const bgfx::VertexLayout& _srcLayout
+	, uint32_t _numVertices
+	)
+{
+	bgfx::vertexConvert(_dstLayout, _dstVertices, _srcLayout, _srcVertices, _numVertices);
+
+	const float bias = 1.0f/127.0f;
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		float nxyzw[4];
+		bgfx::vertexUnpack(nxyzw, bgfx::Attrib::Normal, _srcLayout, _srcVertices, ii);
+
+		float txyzw[4];
+		bgfx::vertexUnpack(txyzw, bgfx::Attrib::Tangent, _srcLayout, _srcVertices, ii);
+
+		const bx::Vec3 normal = bx::normalize(bx::load<bx::Vec3>(nxyzw) );
+		bx::Vec3 tangent = bx::load<bx::Vec3>(txyzw);
+
+		if (!bx::isFinite(tangent.x)
+		||  !bx::isFinite(tangent.y)
+		||  !bx::isFinite(tangent.z)
+		||  bx::length(tangent) < 0.5f)
+		{
+			// degenerate texture mapping, any frame around the normal will do
+			bx::Vec3 bitangent(bx::init::None);
+			bx::calcTangentFrame(tangent, bitangent, normal);
+		}
+
+		const bx::Vec3 bitangent = bx::cross(normal, tangent);
+
+		// columns of the rotation matrix are tangent, bitangent and normal
+		const float m00 = tangent.x, m01 = bitangent.x, m02 = normal.x;
+		const float m10 = tangent.y, m11 = bitangent.y, m12 = normal.y;
+		const float m20 = tangent.z, m21 = bitangent.z, m22 = normal.z;
+
+		float quat[4];
+		const float trace = m00 + m11 + m22;
+		if (trace > 0.0f)
+		{
+			const float ss = bx::sqrt(trace + 1.0f) * 2.0f;
+			quat[0] = (m21 - m12) / ss;
+			quat[1] = (m02 - m20) / ss;
+			quat[2] = (m10 - m01) / ss;
+			quat[3] = 0.25f * ss;
+		}
+		else if (m00 > m11 && m00 > m22)
+		{
+			const float ss = bx::sqrt(1.0f + m00 - m11 - m22) * 2.0f;
+			quat[0] = 0.25f * ss;
+			quat[1] = (m01 + m10) / ss;
+			quat[2] = (m02 + m20) / ss;
+			quat[3] = (m21 - m12) / ss;
+		}
+		else if (m11 > m22)
+		{
+			const float ss = bx::sqrt(1.0f + m11 - m00 - m22) * 2.0f;
+			quat[0] = (m01 + m10) / ss;
+			quat[1] = 0.25f * ss;
+			quat[2] = (m12 + m21) / ss;
+			quat[3] = (m02 - m20) / ss;
+		}
+		else
+		{
+			const float ss = bx::sqrt(1.0f + m22 - m00 - m11) * 2.0f;
+			quat[0] = (m02 + m20) / ss;
+			quat[1] = (m12 + m21) / ss;
+			quat[2] = 0.25f * ss;
+			quat[3] = (m10 - m01) / ss;
+		}
+
+		const bx::Quaternion rotation = bx::normalize(bx::Quaternion(quat[0], quat[1], quat[2], quat[3]) );
+		const float sign = rotation.w < 0.0f ? -1.0f : 1.0f;
+		quat[0] = rotation.x * sign;
+		quat[1] = rotation.y * sign;
+		quat[2] = rotation.z * sign;
+		quat[3] = rotation.w * sign;
+
+		if (quat[3] < bias)
+		{
+			const float scale = bx::sqrt(1.0f - bias*bias) / bx::sqrt(quat[0]*quat[0] + quat[1]*quat[1] + quat[2]*quat[2]);
+			quat[0] *= scale;
+			quat[1] *= scale;
+			quat[2] *= scale;
+			quat[3]  = bias;
+		}
+
+		if (txyzw[3] < 0.0f)
+		{
+			quat[0] = -quat[0];
+			quat[1] = -quat[1];
+			quat[2] = -quat[2];
+			quat[3] = -quat[3];
+		}
+
+		bgfx::vertexPack(quat, true, bgfx::Attrib::Tangent, _dstLayout, _dstVertices, ii);
+	}
+}
+
 void write(
 	  bx::WriterI* _writer
 	, const void* _vertices
@@ -365,9 +574,10 @@ void write(
 	, const uint8_t* _vertices
 	, uint32_t _numVertices
 	, const bgfx::VertexLayout& _layout
-	, const uint16_t* _indices
+	, const uint32_t* _indices
 	, uint32_t _numIndices
 	, bool _compress
+	, const LodArray& _lods
 	, const stl::string& _material
 	, const PrimitiveArray& _primitives
 	, bx::Error* _err
@@ -378,39 +588,77 @@ void write(
 
 	uint32_t stride = _layout.getStride();
 
+	const bool index32 = _numVertices > UINT16_MAX;
+	const uint32_t indexSize = index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
 	if (_compress)
 	{
-		write(_writer, kChunkVertexBufferCompressed, _err);
+		write(_writer, index32 ? kChunkVertexBufferCompressed32 : kChunkVertexBufferCompressed, _err);
 		write(_writer, _vertices, _numVertices, stride, _err);
 
 		write(_writer, _layout);
 
-		write(_writer, uint16_t(_numVertices), _err);
+		if (index32)
+		{
+			write(_writer, _numVertices, _err);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices), _err);
+		}
 		writeCompressedVertices(_writer, _vertices, _numVertices, uint16_t(stride), _err);
 	}
 	else
 	{
-		write(_writer, kChunkVertexBuffer, _err);
+		write(_writer, index32 ? kChunkVertexBuffer32 : kChunkVertexBuffer, _err);
 		write(_writer, _vertices, _numVertices, stride, _err);
 
 		write(_writer, _layout, _err);
 
-		write(_writer, uint16_t(_numVertices), _err);
+		if (index32)
+		{
+			write(_writer, _numVertices, _err);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices), _err);
+		}
 		write(_writer, _vertices, _numVertices*stride, _err);
 	}
 
 	if (_compress)
 	{
-		write(_writer, kChunkIndexBufferCompressed, _err);
+		write(_writer, index32 ? kChunkIndexBufferCompressed32 : kChunkIndexBufferCompressed, _err);
 		write(_writer, _numIndices, _err);
 
-		writeCompressedIndices(_writer, _indices, _numIndices, _numVertices, _err);
+		writeCompressedIndices(_writer, _indices, _numIndices, _numVertices, indexSize, _err);
 	}
 	else
 	{
-		write(_writer, kChunkIndexBuffer, _err);
+		write(_writer, index32 ? kChunkIndexBuffer32 : kChunkIndexBuffer, _err);
 		write(_writer, _numIndices, _err);
-		write(_writer, _indices, _numIndices*2, _err);
+		writeIndices(_writer, _indices, _numIndices, index32, _err);
+	}
+
+	for (LodArray::const_iterator lodIt = _lods.begin(); lodIt != _lods.end(); ++lodIt)
+	{
+		const uint32_t numLodIndices = uint32_t(lodIt->m_indices.size() );
+
+		if (_compress)
+		{
+			write(_writer, index32 ? kChunkIndexBufferLodCompressed32 : kChunkIndexBufferLodCompressed, _err);
+			write(_writer, lodIt->m_error, _err);
+			write(_writer, numLodIndices, _err);
+
+			writeCompressedIndices(_writer, lodIt->m_indices.data(), numLodIndices, _numVertices, indexSize, _err);
+		}
+		else
+		{
+			write(_writer, index32 ? kChunkIndexBufferLod32 : kChunkIndexBufferLod, _err);
+			write(_writer, lodIt->m_error, _err);
+			write(_writer, numLodIndices, _err);
+			writeIndices(_writer, lodIt->m_indices.data(), numLodIndices, index32, _err);
+		}
 	}
 
 	write(_writer, kChunkPrimitive, _err);
@@ -964,7 +1212,15 @@ void help(const char* _error = NULL)
 		  "           0 - unpacked 8 bytes (default).\n"
 		  "           1 - packed 4 bytes.\n"
 		  "      --tangent            Calculate tangent vectors (packing mode is the same as normal).\n"
+		  "      --tangentframe       Calculate tangent frame, normal and tangent are packed as quaternion\n"
+		  "           in 4 bytes of bgfx::Attrib::Tangent, the sign of w is bitangent handedness.\n"
 		  "      --barycentric        Adds barycentric vertex attribute (packed in bgfx::Attrib::Color1).\n"
+		  "      --lod <num>          Number of simplified levels of detail written after each group,\n"
+		  "           each level targets half the indices of the previous one. Default value is 0.\n"
+		  "      --lod-error <num>    Maximum simplification error relative to the mesh extent.\n"
+		  "           Default value is 0.01.\n"
+		  "      --index32            Use 32-bit indices for groups with more than 65535 vertices instead\n"
+		  "           of splitting them, each material is then written as a single group.\n"
 		  "  -c, --compress           Compress indices.\n"
 		  "      --[l/r]h-up+[y/z]	  Coordinate system. Default is '--lh-up+y' Left-Handed +Y is up.\n"
 
@@ -1031,9 +1287,25 @@ int main(int _argc, const char* _argv[])
 
 	bool ccw = cmdLine.hasArg("ccw");
 	bool flipV = cmdLine.hasArg("flipv");
-	bool hasTangent = cmdLine.hasArg("tangent");
+	bool hasTangentFrame = cmdLine.hasArg("tangentframe");
+	bool hasTangent = cmdLine.hasArg("tangent") || hasTangentFrame;
 	bool hasBc = cmdLine.hasArg("barycentric");
 
+	bool index32 = cmdLine.hasArg("index32");
+
+	uint32_t numLods = 0;
+	cmdLine.hasArg(numLods, '\0', "lod");
+
+	float lodError = 0.01f;
+	const char* lodErrorArg = cmdLine.findOption("lod-error");
+	if (NULL != lodErrorArg)
+	{
+		if (!bx::fromString(&lodError, lodErrorArg) )
+		{
+			lodError = 0.01f;
+		}
+	}
+
 	CoordinateSystem outputCoordinateSystem;
 	outputCoordinateSystem.m_handness = bx::Handness::Left;
 	outputCoordinateSystem.m_forward = Axis::PositiveZ;
@@ -1195,8 +1467,10 @@ int main(int _argc, const char* _argv[])
 	if (hasNormal)
 	{
 		hasTangent &= hasTexcoord;
+		hasTangentFrame &= hasTangent;
 
-		switch (packNormal)
+		// the tangent frame is encoded from full precision normal and tangent
+		switch (hasTangentFrame ? 0 : packNormal)
 		{
 		default:
 		case 0:
@@ -1219,9 +1493,32 @@ int main(int _argc, const char* _argv[])
 
 	layout.end();
 
+	bgfx::VertexLayout frameLayout;
+	if (hasTangentFrame)
+	{
+		frameLayout.begin();
+		for (uint32_t attr = 0; attr < bgfx::Attrib::Count; ++attr)
+		{
+			if (bgfx::Attrib::Normal  != attr
+			&&  bgfx::Attrib::Tangent != attr
+			&&  layout.has(bgfx::Attrib::Enum(attr) ) )
+			{
+				uint8_t num;
+				bgfx::AttribType::Enum type;
+				bool normalized;
+				bool asInt;
+				layout.decode(bgfx::Attrib::Enum(attr), num, type, normalized, asInt);
+				frameLayout.add(bgfx::Attrib::Enum(attr), num, type, normalized, asInt);
+			}
+		}
+		frameLayout.add(bgfx::Attrib::Tangent, 4, bgfx::AttribType::Uint8, true, true);
+		frameLayout.end();
+	}
+
 	uint32_t stride = layout.getStride();
 	uint8_t* vertexData = new uint8_t[mesh.m_triangles.size() * 3 * stride];
-	uint16_t* indexData = new uint16_t[mesh.m_triangles.size() * 3];
+	uint8_t* frameData = hasTangentFrame ? new uint8_t[mesh.m_triangles.size() * 3 * frameLayout.getStride()] : NULL;
+	uint32_t* indexData = new uint32_t[mesh.m_triangles.size() * 3];
 	int32_t numVertices = 0;
 	int32_t numIndices = 0;
 
@@ -1230,9 +1527,15 @@ int main(int _argc, const char* _argv[])
 	int32_t writtenIndices = 0;
 
 	uint8_t* vertices = vertexData;
-	uint16_t* indices = indexData;
+	uint32_t* indices = indexData;
+
+	// without 32-bit indices groups are split before their vertex count overflows 16 bits
+	const int32_t maxVertices = index32 ? INT32_MAX : 65533;
 
-	const uint32_t tableSize = 65536 * 2;
+	const uint32_t tableSize = index32
+		? bx::uint32_nextpow2(bx::uint32_max(uint32_t(mesh.m_triangles.size() * 3), 65536) ) * 2
+		: 65536 * 2
+		;
 	const uint32_t hashmod = tableSize - 1;
 	uint32_t* table = new uint32_t[tableSize];
 	bx::memSet(table, 0xff, tableSize * sizeof(uint32_t) );
@@ -1240,6 +1543,7 @@ int main(int _argc, const char* _argv[])
 	stl::string material = mesh.m_groups.empty() ? "" : mesh.m_groups.begin()->m_material;
 
 	PrimitiveArray primitives;
+	LodArray lods;
 
 	bx::FileWriter writer;
 	if (!bx::open(&writer, outFilePath) )
@@ -1271,7 +1575,7 @@ int main(int _argc, const char* _argv[])
 		{
 			if (0 != bx::strCmp(material.c_str(), groupIt->m_material.c_str() )
 			||  sentinel
-			||  65533 <= numVertices)
+			||  maxVertices <= numVertices)
 			{
 				prim.m_numVertices = numVertices - prim.m_startVertex;
 				prim.m_numIndices  = numIndices  - prim.m_startIndex;
@@ -1283,7 +1587,16 @@ int main(int _argc, const char* _argv[])
 
 				if (hasTangent)
 				{
-					calcTangents(vertexData, uint16_t(numVertices), layout, indexData, numIndices);
+					calcTangents(vertexData, numVertices, layout, indexData, numIndices);
+				}
+
+				uint8_t* outVertexData = vertexData;
+				const bgfx::VertexLayout* outLayout = &layout;
+				if (hasTangentFrame)
+				{
+					encodeTangentFrame(frameData, frameLayout, vertexData, layout, numVertices);
+					outVertexData = frameData;
+					outLayout = &frameLayout;
 				}
 
 				triReorderElapsed -= bx::getHPCounter();
@@ -1294,20 +1607,23 @@ int main(int _argc, const char* _argv[])
 					optimizeVertexCache(indexData + prim1.m_startIndex, prim1.m_numIndices, numVertices);
 				}
 
-				numVertices = optimizeVertexFetch(indexData, numIndices, vertexData, numVertices, uint16_t(stride) );
+				numVertices = optimizeVertexFetch(indexData, numIndices, outVertexData, numVertices, outLayout->getStride() );
 
 				triReorderElapsed += bx::getHPCounter();
 
+				generateLods(lods, indexData, numIndices, outVertexData, numVertices, *outLayout, numLods, lodError);
+
 				if (0 < numVertices
 				&&  0 < numIndices)
 				{
 					write(&writer
-						, vertexData
+						, outVertexData
 						, numVertices
-						, layout
+						, *outLayout
 						, indexData
 						, numIndices
 						, compress
+						, lods
 						, material
 						, primitives
 						, &err
@@ -1414,7 +1730,7 @@ int main(int _argc, const char* _argv[])
 					exit(bx::kExitFailure);
 				}
 
-				*indices++ = (uint16_t)vertexIndex;
+				*indices++ = vertexIndex;
 				++numIndices;
 			}
 		}
@@ -1445,6 +1761,7 @@ int main(int _argc, const char* _argv[])
 	delete [] table;
 	delete [] indexData;
 	delete [] vertexData;
+	delete [] frameData;
 
 	now = bx::getHPCounter();
 	convertElapsed += now;
@@ -643,6 +643,16 @@ namespace bgfx { namespace spirv
 							continue;
 						}
 
+						// Members of user uniform blocks are bound as a whole buffer, only members of
+						// bgfx's own uniform block go into the uniform array.
+						const int32_t blockIndex = program->getUniformBlockIndex(ii);
+						if (0 <= blockIndex
+						&&  0 != bx::strCmp(program->getUniformBlockName(blockIndex), "UniformBlock")
+						&&  0 != bx::strCmp(program->getUniformBlockName(blockIndex), "$Global") )
+						{
+							continue;
+						}
+
 						un.num = 0;
 						const uint32_t offset = program->getUniformBufferOffset(ii);
 						un.regIndex = uint16_t(offset);
@@ -827,6 +837,28 @@ namespace bgfx { namespace spirv
 						uniforms.push_back(un);
 					}
 
+					// Loop through the user uniform blocks, and extract the block names:
+					for (auto& resource : resourcesrefl.uniform_buffers)
+					{
+						std::string name = refl.get_name(resource.id);
+
+						uint32_t binding_index = refl.get_decoration(resource.id, spv::Decoration::DecorationBinding);
+
+						if (binding_index < kSpirvBindShift)
+						{
+							continue;
+						}
+
+						Uniform un;
+						un.name = name;
+						un.type = UniformType::End;
+						un.num = 0;
+						un.regIndex = uint16_t(binding_index);
+						un.regCount = descriptorTypeToId(DescriptorType::UniformBuffer);
+
+						uniforms.push_back(un);
+					}
+
 					uint16_t size = writeUniformArray( _writer, uniforms, _options.shaderType == 'f');
 
 					uint32_t shaderSize = (uint32_t)spirv.size() * sizeof(uint32_t);
@@ -167,12 +167,34 @@ namespace bimg
 		};
 	};
 
-	///
+	/// Filters each mip of cubemap with lighting model lobe of matching glossiness. Rows are
+	/// distributed over _numThreads threads including caller, 0 uses one per logical processor.
+	/// Result doesn't depend on number of threads.
 	ImageContainer* imageCubemapRadianceFilter(
 		  bx::AllocatorI* _allocator
 		, const ImageContainer& _image
 		, LightingModel::Enum _lightingModel
 		, bx::Error* _err
+		, uint32_t _numThreads = 0
+		);
+
+	/// Projects cubemap radiance onto the first three bands of spherical harmonics, convolved
+	/// with the clamped cosine lobe. Output is 9x1 RGBA32F image, one texel per coefficient
+	/// with basis constants folded in, in order 1, y, z, x, xy, yz, 3z^2-1, xz, x^2-y^2.
+	/// Evaluated at a normal it gives irradiance divided by pi.
+	ImageContainer* imageCubemapIrradianceSh(
+		  bx::AllocatorI* _allocator
+		, const ImageContainer& _image
+		, bx::Error* _err
+		);
+
+	/// Generates the split-sum environment BRDF lookup table of the GGX lighting model, as
+	/// used with a GGX filtered radiance cubemap. Texture coordinate u is N dot V, v is
+	/// roughness. Red and green are scale and bias applied to F0.
+	ImageContainer* imageBrdfLutGgx(
+		  bx::AllocatorI* _allocator
+		, uint16_t _size
+		, bx::Error* _err
 		);
 
 } // namespace bimg
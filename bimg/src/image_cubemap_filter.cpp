@@ -5,7 +5,11 @@
 
 #include "bimg_p.h"
 #include <bimg/encode.h>
+#include <bx/cpu.h>
+#include <bx/os.h>
 #include <bx/rng.h>
+#include <bx/simd_t.h>
+#include <bx/thread.h>
 
 namespace bimg
 {
@@ -687,106 +691,6 @@ namespace bimg
 		}
 	}
 
-	struct Sampler
-	{
-		Sampler(const ImageContainer& _image, uint16_t _side, float _lod, float (*func)(float) )
-		{
-			const float lod = bx::clamp(_lod, 0.0f, float(_image.m_numMips - 1) );
-			imageGetRawData(
-				  _image
-				, _side
-				, uint8_t(func(lod) )
-				, _image.m_data
-				, _image.m_size
-				, mip
-				);
-		}
-
-		ImageMip mip;
-	};
-
-	void texelFetch(float* _rgba, const Sampler& _sampler, uint32_t _u, uint32_t _v)
-	{
-		const uint32_t bpp   = _sampler.mip.m_bpp;
-		const uint32_t pitch = _sampler.mip.m_width*bpp/8;
-		const uint8_t* texel = _sampler.mip.m_data + _v*pitch + _u*bpp/8;
-
-		UnpackFn unpack = getUnpack(_sampler.mip.m_format);
-		unpack(_rgba, texel);
-	}
-
-	void sampleCubeMap(float* _rgba, const ImageContainer& _image, const bx::Vec3& _dir, float _lod)
-	{
-		float uu, vv;
-		uint8_t side;
-		dirToTexelUv(uu, vv, side, _dir);
-
-		const float fu = bx::fract(uu);
-		const float fv = bx::fract(vv);
-		const float fl = bx::fract(_lod);
-
-		float rgbaA[4];
-		{
-			Sampler sampler(_image, side, _lod, bx::floor);
-			const uint32_t widthMinusOne = sampler.mip.m_width-1;
-
-			const uint32_t u0 = uint32_t(uu*widthMinusOne+0.5f);
-			const uint32_t v0 = uint32_t(vv*widthMinusOne+0.5f);
-			const uint32_t u1 = bx::min(u0 + 1, widthMinusOne);
-			const uint32_t v1 = bx::min(v0 + 1, widthMinusOne);
-
-			float rgba00[4];
-			texelFetch(rgba00, sampler, u0, v0);
-
-			float rgba01[4];
-			texelFetch(rgba01, sampler, u0, v1);
-
-			float rgba10[4];
-			texelFetch(rgba10, sampler, u1, v0);
-
-			float rgba11[4];
-			texelFetch(rgba11, sampler, u1, v1);
-
-			rgbaA[0] = bx::lerp(bx::lerp(rgba00[0], rgba01[0], fv), bx::lerp(rgba10[0], rgba11[0], fv), fu);
-			rgbaA[1] = bx::lerp(bx::lerp(rgba00[1], rgba01[1], fv), bx::lerp(rgba10[1], rgba11[1], fv), fu);
-			rgbaA[2] = bx::lerp(bx::lerp(rgba00[2], rgba01[2], fv), bx::lerp(rgba10[2], rgba11[2], fv), fu);
-			rgbaA[3] = bx::lerp(bx::lerp(rgba00[3], rgba01[3], fv), bx::lerp(rgba10[3], rgba11[3], fv), fu);
-		}
-
-		float rgbaB[4];
-		{
-			Sampler sampler(_image, side, _lod, bx::ceil);
-			const uint32_t widthMinusOne = sampler.mip.m_width-1;
-
-			const uint32_t u0 = uint32_t(uu*widthMinusOne+0.5f);
-			const uint32_t v0 = uint32_t(vv*widthMinusOne+0.5f);
-			const uint32_t u1 = bx::min(u0 + 1, widthMinusOne);
-			const uint32_t v1 = bx::min(v0 + 1, widthMinusOne);
-
-			float rgba00[4];
-			texelFetch(rgba00, sampler, u0, v0);
-
-			float rgba01[4];
-			texelFetch(rgba01, sampler, u0, v1);
-
-			float rgba10[4];
-			texelFetch(rgba10, sampler, u1, v0);
-
-			float rgba11[4];
-			texelFetch(rgba11, sampler, u1, v1);
-
-			rgbaB[0] = bx::lerp(bx::lerp(rgba00[0], rgba01[0], fv), bx::lerp(rgba10[0], rgba11[0], fv), fu);
-			rgbaB[1] = bx::lerp(bx::lerp(rgba00[1], rgba01[1], fv), bx::lerp(rgba10[1], rgba11[1], fv), fu);
-			rgbaB[2] = bx::lerp(bx::lerp(rgba00[2], rgba01[2], fv), bx::lerp(rgba10[2], rgba11[2], fv), fu);
-			rgbaB[3] = bx::lerp(bx::lerp(rgba00[3], rgba01[3], fv), bx::lerp(rgba10[3], rgba11[3], fv), fu);
-		}
-
-		_rgba[0] = bx::lerp(rgbaA[0], rgbaB[0], fl);
-		_rgba[1] = bx::lerp(rgbaA[1], rgbaB[1], fl);
-		_rgba[2] = bx::lerp(rgbaA[2], rgbaB[2], fl);
-		_rgba[3] = bx::lerp(rgbaA[3], rgbaB[3], fl);
-	}
-
 	bx::Vec3 importanceSampleGgx(float _u, float _v, float _roughness, const bx::Vec3& _normal, const bx::Vec3& _tangentX, const bx::Vec3& _tangentY)
 	{
 		const float aa  = bx::square(_roughness);
@@ -818,65 +722,201 @@ namespace bimg
 		return alphaSq/(bx::kPi * denomSq);
 	}
 
-	void processFilterAreaGgx(
-		  float* _result
-		, const ImageContainer& _image
-		, uint8_t _lod
-		, const bx::Vec3& _dir
-		, float _roughness
-		)
+	/// Mip chain of RGBA32F cubemap, resolved once so sampling doesn't walk image container.
+	struct CubeMapRgba32f
 	{
-		ImageMip mip;
-		imageGetRawData(_image, 0, _lod, _image.m_data, _image.m_size, mip);
+		void init(const ImageContainer& _image)
+		{
+			BX_ASSERT(TextureFormat::RGBA32F == _image.m_format, "Cubemap must be RGBA32F.");
 
-		const uint32_t bpp = getBitsPerPixel(_image.m_format);
+			numMips = bx::min<uint8_t>(_image.m_numMips, BX_COUNTOF(width) );
 
-		constexpr int32_t kNumSamples = 512;
-		const uint32_t pitch      = mip.m_width*bpp/8;
-		const float widthMinusOne = float(mip.m_width-1);
-		const float mipBias       = 0.5f*bx::log2(bx::square(float(_image.m_width) )/float(kNumSamples) );
+			for (uint8_t lod = 0; lod < numMips; ++lod)
+			{
+				for (uint8_t side = 0; side < 6; ++side)
+				{
+					ImageMip mip;
+					imageGetRawData(_image, side, lod, _image.m_data, _image.m_size, mip);
+					data[side][lod] = (const float*)mip.m_data;
+					width[lod]      = mip.m_width;
+				}
+			}
+		}
 
-		UnpackFn unpack = getUnpack(_image.m_format);
+		const float* data[6][16];
+		uint32_t width[16];
+		uint8_t numMips;
+	};
 
-		float color[3]    = { 0.0f, 0.0f, 0.0f };
-		float totalWeight = 0.0f;
+	inline bx::simd128_t texelFetch(const float* _data, uint32_t _pitch, uint32_t _u, uint32_t _v)
+	{
+		const float* texel = &_data[(_v*_pitch + _u)*4];
+		return bx::simd_ld<bx::simd128_t>(texel[0], texel[1], texel[2], texel[3]);
+	}
 
-		// Golden Ratio Sequences for Low-Discrepancy Sampling
-		// https://web.archive.org/web/20180717194847/https://www.graphics.rwth-aachen.de/publication/2/jgt.pdf
-		//
-		// kGoldenSection = (0.5f*bx::sqrt(5.0f) + 0.5f) - 1.0f = 0.61803398875f
-		//
-		const float kGoldenSection = 0.61803398875f;
-		float offset = kGoldenSection;
+	inline bx::simd128_t sampleBilinear(const CubeMapRgba32f& _cube, uint8_t _side, uint8_t _lod, float _uu, float _vv, bx::simd128_t _fu, bx::simd128_t _fv)
+	{
+		const float* data = _cube.data[_side][_lod];
+		const uint32_t width         = _cube.width[_lod];
+		const uint32_t widthMinusOne = width-1;
+
+		const uint32_t u0 = uint32_t(_uu*widthMinusOne+0.5f);
+		const uint32_t v0 = uint32_t(_vv*widthMinusOne+0.5f);
+		const uint32_t u1 = bx::min(u0 + 1, widthMinusOne);
+		const uint32_t v1 = bx::min(v0 + 1, widthMinusOne);
+
+		const bx::simd128_t rgba00 = texelFetch(data, width, u0, v0);
+		const bx::simd128_t rgba01 = texelFetch(data, width, u0, v1);
+		const bx::simd128_t rgba10 = texelFetch(data, width, u1, v0);
+		const bx::simd128_t rgba11 = texelFetch(data, width, u1, v1);
+
+		return bx::simd_lerp(
+			  bx::simd_lerp(rgba00, rgba01, _fv)
+			, bx::simd_lerp(rgba10, rgba11, _fv)
+			, _fu
+			);
+	}
+
+	/// Bilinear between texels, linear between the two closest mips.
+	inline bx::simd128_t sampleCubeMap(const CubeMapRgba32f& _cube, const bx::Vec3& _dir, float _lod)
+	{
+		float uu, vv;
+		uint8_t side;
+		dirToTexelUv(uu, vv, side, _dir);
+
+		const bx::simd128_t fu = bx::simd_splat(bx::fract(uu) );
+		const bx::simd128_t fv = bx::simd_splat(bx::fract(vv) );
+
+		const float lod = bx::clamp(_lod, 0.0f, float(_cube.numMips - 1) );
+		const bx::simd128_t fl = bx::simd_splat(bx::fract(_lod) );
+
+		const bx::simd128_t rgbaA = sampleBilinear(_cube, side, uint8_t(bx::floor(lod) ), uu, vv, fu, fv);
+		const bx::simd128_t rgbaB = sampleBilinear(_cube, side, uint8_t(bx::ceil(lod) ),  uu, vv, fu, fv);
+
+		return bx::simd_lerp(rgbaA, rgbaB, fl);
+	}
+
+	constexpr uint32_t kGgxNumSamples = 512;
+
+	/// GGX importance samples around +Z. With view vector equal to normal, light direction,
+	/// N dot L and sample lod don't depend on filtered direction, only tangent frame does.
+	struct GgxSamples
+	{
+		void init(float _roughness, uint32_t _imageWidth)
+		{
+			const float mipBias = 0.5f*bx::log2(bx::square(float(_imageWidth) )/float(kGgxNumSamples) );
+
+			const bx::Vec3 normal   = { 0.0f, 0.0f, 1.0f };
+			const bx::Vec3 tangentX = { 1.0f, 0.0f, 0.0f };
+			const bx::Vec3 tangentY = { 0.0f, 1.0f, 0.0f };
+
+			// Golden Ratio Sequences for Low-Discrepancy Sampling
+			// https://web.archive.org/web/20180717194847/https://www.graphics.rwth-aachen.de/publication/2/jgt.pdf
+			//
+			// kGoldenSection = (0.5f*bx::sqrt(5.0f) + 0.5f) - 1.0f = 0.61803398875f
+			//
+			const float kGoldenSection = 0.61803398875f;
+			float offset = kGoldenSection;
+
+			num = 0;
+
+			for (uint32_t ii = 0; ii < kGgxNumSamples; ++ii)
+			{
+				offset += kGoldenSection;
+				const float vv = ii/float(kGgxNumSamples);
+
+				const bx::Vec3 hh  = importanceSampleGgx(offset, vv, _roughness, normal, tangentX, tangentY);
+				const float ndoth  = bx::clamp(hh.z, 0.0f, 1.0f);
+				const bx::Vec3 ll  = bx::sub(bx::mul(hh, 2.0f * hh.z), normal);
+				const float ndotl  = bx::clamp(ll.z, 0.0f, 1.0f);
+
+				if (ndotl > 0.0f)
+				{
+					const float vdoth = ndoth;
+
+					// Chapter 20. GPU-Based Importance Sampling
+					// http://archive.today/2018.07.14-004914/https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch20.html
+					//
+					const float pdf = normalDistributionGgx(ndoth, _roughness) * ndoth / (4.0f * vdoth);
+
+					lx[num]       = ll.x;
+					ly[num]       = ll.y;
+					lz[num]       = ll.z;
+					weight[num]   = ndotl;
+					lod[num]      = bx::max(0.0f, mipBias - 0.5f*bx::log2(pdf) );
+					++num;
+				}
+			}
+
+			// Pad to multiple of 4 with zero weight samples, they are skipped when sampling.
+			for (uint32_t ii = num, end = bx::alignUp(num, 4); ii < end; ++ii)
+			{
+				lx[ii]     = 0.0f;
+				ly[ii]     = 0.0f;
+				lz[ii]     = 1.0f;
+				weight[ii] = 0.0f;
+				lod[ii]    = 0.0f;
+			}
+		}
+
+		BX_ALIGN_DECL_16(float) lx[kGgxNumSamples];
+		BX_ALIGN_DECL_16(float) ly[kGgxNumSamples];
+		BX_ALIGN_DECL_16(float) lz[kGgxNumSamples];
+		BX_ALIGN_DECL_16(float) weight[kGgxNumSamples];
+		BX_ALIGN_DECL_16(float) lod[kGgxNumSamples];
+		uint32_t num;
+	};
+
+	void processFilterAreaGgx(
+		  float* _result
+		, const CubeMapRgba32f& _cube
+		, const GgxSamples& _samples
+		, const bx::Vec3& _dir
+		)
+	{
+		using namespace bx;
 
 		bx::Vec3 tangentX(bx::init::None);
 		bx::Vec3 tangentY(bx::init::None);
 		bx::calcTangentFrame(tangentX, tangentY, _dir);
 
-		for (uint32_t ii = 0; ii < kNumSamples; ++ii)
+		const simd128_t txx = simd_splat(tangentX.x);
+		const simd128_t txy = simd_splat(tangentX.y);
+		const simd128_t txz = simd_splat(tangentX.z);
+		const simd128_t tyx = simd_splat(tangentY.x);
+		const simd128_t tyy = simd_splat(tangentY.y);
+		const simd128_t tyz = simd_splat(tangentY.z);
+		const simd128_t nx  = simd_splat(_dir.x);
+		const simd128_t ny  = simd_splat(_dir.y);
+		const simd128_t nz  = simd_splat(_dir.z);
+
+		simd128_t color       = simd_zero<simd128_t>();
+		simd128_t totalWeight = simd_zero<simd128_t>();
+
+		// Four samples at a time are rotated into filtered direction's tangent frame, then
+		// fetched and accumulated one by one in the same order regardless of thread count.
+		for (uint32_t ii = 0, num = _samples.num; ii < num; ii += 4)
 		{
-			offset += kGoldenSection;
-			const float vv = ii/float(kNumSamples);
+			const simd128_t lx = simd_ld<simd128_t>(&_samples.lx[ii]);
+			const simd128_t ly = simd_ld<simd128_t>(&_samples.ly[ii]);
+			const simd128_t lz = simd_ld<simd128_t>(&_samples.lz[ii]);
 
-			const bx::Vec3 hh  = importanceSampleGgx(offset, vv, _roughness, _dir, tangentX, tangentY);
-			const float ddoth2 = 2.0f * bx::dot(_dir, hh);
-			const bx::Vec3 ll  = bx::sub(bx::mul(hh, ddoth2), _dir);
+			BX_ALIGN_DECL_16(float) wx[4];
+			BX_ALIGN_DECL_16(float) wy[4];
+			BX_ALIGN_DECL_16(float) wz[4];
+			simd_st(wx, simd_madd(lx, txx, simd_madd(ly, tyx, simd_mul(lz, nx) ) ) );
+			simd_st(wy, simd_madd(lx, txy, simd_madd(ly, tyy, simd_mul(lz, ny) ) ) );
+			simd_st(wz, simd_madd(lx, txz, simd_madd(ly, tyz, simd_mul(lz, nz) ) ) );
 
-			const float ndotl = bx::clamp(bx::dot(_dir, ll), 0.0f, 1.0f);
+			totalWeight = simd_add(totalWeight, simd_ld<simd128_t>(&_samples.weight[ii]) );
 
-			if (ndotl > 0.0f)
+			for (uint32_t jj = 0, end = bx::min(num - ii, 4u); jj < end; ++jj)
 			{
-				const float ndoth = bx::clamp(bx::dot(_dir, hh), 0.0f, 1.0f);
-				const float vdoth = ndoth;
-
-				// Chapter 20. GPU-Based Importance Sampling
-				// http://archive.today/2018.07.14-004914/https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch20.html
-				//
-				const float pdf = normalDistributionGgx(ndoth, _roughness) * ndoth / (4.0f * vdoth);
-				const float lod = bx::max(0.0f, mipBias - 0.5f*bx::log2(pdf));
+				const float ndotl = _samples.weight[ii+jj];
+				const simd128_t rgba = sampleCubeMap(_cube, { wx[jj], wy[jj], wz[jj] }, _samples.lod[ii+jj]);
 
-				float rgba[4];
-				sampleCubeMap(rgba, _image, ll, lod);
+				BX_ALIGN_DECL_16(float) tmp[4];
+				simd_st(tmp, rgba);
 
 				// Optimized Reversible Tonemapper for Resolve
 				// https://web.archive.org/web/20180717182019/https://gpuopen.com/optimized-reversible-tonemapper-for-resolve/
@@ -885,30 +925,29 @@ namespace bimg
 				// as a function of how bright they are"
 				// Include ndotl here to "fold the weighting into the tonemap operation"
 				//
-				const float tm = ndotl / (bx::max(rgba[0], rgba[1], rgba[2]) + 1.0f);
+				const float tm = ndotl / (bx::max(tmp[0], tmp[1], tmp[2]) + 1.0f);
 
-				color[0] += rgba[0] * tm;
-				color[1] += rgba[1] * tm;
-				color[2] += rgba[2] * tm;
-				totalWeight += ndotl;
+				color = simd_madd(rgba, simd_splat(tm), color);
 			}
 		}
 
-		if (0.0f < totalWeight)
+		BX_ALIGN_DECL_16(float) weights[4];
+		simd_st(weights, totalWeight);
+		const float weight = (weights[0] + weights[1]) + (weights[2] + weights[3]);
+
+		if (0.0f < weight)
 		{
 			// Optimized Reversible Tonemapper for Resolve
 			// https://web.archive.org/web/20180717182019/https://gpuopen.com/optimized-reversible-tonemapper-for-resolve/
 			// Average, then reverse the tonemapper
 			//
-			const float invWeight = 1.0f/totalWeight;
-			color[0] = color[0] * invWeight;
-			color[1] = color[1] * invWeight;
-			color[2] = color[2] * invWeight;
-
-			const float invTm = 1.0f / (1.0f - bx::max(0.00001f, bx::max(color[0], color[1], color[2])));
-			_result[0] = color[0] * invTm;
-			_result[1] = color[1] * invTm;
-			_result[2] = color[2] * invTm;
+			BX_ALIGN_DECL_16(float) avg[4];
+			simd_st(avg, simd_mul(color, simd_splat(1.0f/weight) ) );
+
+			const float invTm = 1.0f / (1.0f - bx::max(0.00001f, bx::max(avg[0], avg[1], avg[2])));
+			_result[0] = avg[0] * invTm;
+			_result[1] = avg[1] * invTm;
+			_result[2] = avg[2] * invTm;
 		}
 		else
 		{
@@ -916,14 +955,11 @@ namespace bimg
 			uint8_t face;
 			dirToTexelUv(uu, vv, face, _dir);
 
-			imageGetRawData(_image, face, 0, _image.m_data, _image.m_size, mip);
-
+			const uint32_t widthMinusOne = _cube.width[0]-1;
 			const uint32_t xx = uint32_t(uu*widthMinusOne);
 			const uint32_t yy = uint32_t(vv*widthMinusOne);
 
-			float rgba[4];
-			unpack(rgba, mip.m_data + yy*pitch + xx*bpp/8);
-
+			const float* rgba = &_cube.data[face][0][(yy*_cube.width[0] + xx)*4];
 			_result[0] = rgba[0];
 			_result[1] = rgba[1];
 			_result[2] = rgba[2];
@@ -1126,7 +1162,98 @@ namespace bimg
 		return _specularPower;
 	}
 
-	ImageContainer* imageCubemapRadianceFilter(bx::AllocatorI* _allocator, const ImageContainer& _image, LightingModel::Enum _lightingModel, bx::Error* _err)
+	struct RadianceFilterLod
+	{
+		ImageContainer* nsa;
+		GgxSamples* samples;
+		float specularPower;
+		float cosAngle;
+		float filterSize;
+		uint32_t firstRow;
+	};
+
+	/// Rows of all filtered mips and sides are handed out to workers one at a time. Every
+	/// texel depends on the input only, so output doesn't depend on number of threads.
+	struct RadianceFilterContext
+	{
+		void run()
+		{
+			for (;;)
+			{
+				const uint32_t row = bx::atomicFetchAndAdd<uint32_t>(&nextRow, 1);
+
+				if (row >= numRows)
+				{
+					break;
+				}
+
+				processRow(row);
+			}
+		}
+
+		void processRow(uint32_t _row)
+		{
+			uint8_t lod = 1;
+			while (lod + 1 < numMips
+			&&     _row >= lods[lod + 1].firstRow)
+			{
+				++lod;
+			}
+
+			const RadianceFilterLod& params = lods[lod];
+			const uint32_t dstWidth = bx::max<uint32_t>(output->m_width >> lod, 1);
+			const uint32_t local    = _row - params.firstRow;
+			const uint8_t  side     = uint8_t(local / dstWidth);
+			const uint32_t yy       = local % dstWidth;
+
+			ImageMip mip;
+			imageGetRawData(*output, side, lod, output->m_data, output->m_size, mip);
+
+			const uint32_t dstPitch = dstWidth*16;
+			const float texelSize   = 1.0f/float(dstWidth);
+			const float vv          = float(yy)*texelSize*2.0f - 1.0f;
+
+			for (uint32_t xx = 0; xx < dstWidth; ++xx)
+			{
+				float* dstData = (float*)&mip.m_data[yy*dstPitch+xx*16];
+
+				const float uu = float(xx)*texelSize*2.0f - 1.0f;
+
+				bx::Vec3 dir = texelUvToDir(side, uu, vv);
+
+				if (LightingModel::Ggx == lightingModel)
+				{
+					processFilterAreaGgx(dstData, cube, *params.samples, dir);
+				}
+				else
+				{
+					Aabb aabb[6];
+					calcFilterArea(aabb, dir, params.filterSize);
+
+					processFilterArea(dstData, *input, *params.nsa, lod, aabb, dir, params.specularPower, params.cosAngle);
+				}
+			}
+		}
+
+		const ImageContainer* input;
+		ImageContainer* output;
+		LightingModel::Enum lightingModel;
+		CubeMapRgba32f cube;
+		RadianceFilterLod lods[16];
+		uint8_t numMips;
+		uint32_t numRows;
+		uint32_t nextRow;
+	};
+
+	static int32_t radianceFilterThread(bx::Thread* _self, void* _userData)
+	{
+		BX_UNUSED(_self);
+		RadianceFilterContext* ctx = (RadianceFilterContext*)_userData;
+		ctx->run();
+		return 0;
+	}
+
+	ImageContainer* imageCubemapRadianceFilter(bx::AllocatorI* _allocator, const ImageContainer& _image, LightingModel::Enum _lightingModel, bx::Error* _err, uint32_t _numThreads)
 	{
 		if (!_image.m_cubeMap)
 		{
@@ -1158,67 +1285,274 @@ namespace bimg
 			bx::memCopy(dstData, srcMip.m_data, srcMip.m_size);
 		}
 
+		RadianceFilterContext* ctx = BX_ALIGNED_NEW(_allocator, RadianceFilterContext, 16);
+		ctx->input         = input;
+		ctx->output        = output;
+		ctx->lightingModel = _lightingModel;
+		ctx->numMips       = bx::min<uint8_t>(input->m_numMips, BX_COUNTOF(ctx->lods) );
+		ctx->numRows       = 0;
+		ctx->nextRow       = 0;
+		ctx->cube.init(*input);
+
 		const float glossScale = 10.0f;
 		const float glossBias  = 1.0f;
 
-		for (uint8_t lod = 1, numMips = input->m_numMips; lod < numMips; ++lod)
+		for (uint8_t lod = 1, numMips = ctx->numMips; lod < numMips; ++lod)
+		{
+			const uint32_t dstWidth = bx::max<uint32_t>(input->m_width >> lod, 1);
+
+			const float minAngle = bx::atan2(1.0f, float(dstWidth) );
+			const float maxAngle = bx::kPiHalf;
+			const float toFilterSize     = 1.0f/(minAngle*dstWidth*2.0f);
+			const float glossiness       = glossinessFor(lod, float(numMips) );
+			const float roughness        = 1.0f-glossiness;
+			const float specularPowerRef = bx::pow(2.0f, glossiness*glossScale + glossBias);
+			const float specularPower    = applyLightingModel(specularPowerRef, _lightingModel);
+			const float filterAngle      = bx::clamp(cosinePowerFilterAngle(specularPower), minAngle, maxAngle);
+			const float texelSize        = 1.0f/float(dstWidth);
+
+			RadianceFilterLod& params = ctx->lods[lod];
+			params.nsa           = NULL;
+			params.samples       = NULL;
+			params.specularPower = specularPower;
+			params.cosAngle      = bx::max(0.0f, bx::cos(filterAngle) );
+			params.filterSize    = bx::max(texelSize, filterAngle * toFilterSize);
+			params.firstRow      = ctx->numRows;
+
+			if (LightingModel::Ggx == _lightingModel)
+			{
+				params.samples = BX_ALIGNED_NEW(_allocator, GgxSamples, 16);
+				params.samples->init(roughness, input->m_width);
+			}
+			else
+			{
+				params.nsa = imageCubemapNormalSolidAngle(_allocator, dstWidth);
+			}
+
+			ctx->numRows += 6*dstWidth;
+		}
+
+		const uint32_t numThreads = bx::clamp<uint32_t>(
+			  0 == _numThreads ? bx::getNumCpus() : _numThreads
+			, 1
+			, bx::max<uint32_t>(ctx->numRows, 1)
+			);
+
+		// Calling thread works too, only additional workers are spawned.
+		bx::Thread* threads = 1 < numThreads
+			? (bx::Thread*)BX_ALLOC(_allocator, (numThreads-1)*sizeof(bx::Thread) )
+			: NULL
+			;
+
+		for (uint32_t ii = 0; ii < numThreads-1; ++ii)
+		{
+			BX_PLACEMENT_NEW(&threads[ii], bx::Thread);
+			threads[ii].init(radianceFilterThread, ctx, 0, "bimg radiance filter");
+		}
+
+		ctx->run();
+
+		for (uint32_t ii = 0; ii < numThreads-1; ++ii)
+		{
+			threads[ii].shutdown();
+			threads[ii].~Thread();
+		}
+
+		if (NULL != threads)
+		{
+			BX_FREE(_allocator, threads);
+		}
+
+		for (uint8_t lod = 1; lod < ctx->numMips; ++lod)
 		{
-			ImageContainer* nsa = NULL;
+			const RadianceFilterLod& params = ctx->lods[lod];
 
-			if (LightingModel::Ggx != _lightingModel)
+			if (NULL != params.nsa)
 			{
-				nsa = imageCubemapNormalSolidAngle(_allocator, bx::max<uint32_t>(_image.m_width>>lod, 1) );
+				imageFree(params.nsa);
 			}
 
-			for (uint8_t side = 0; side < 6; ++side)
+			if (NULL != params.samples)
 			{
-				ImageMip mip;
-				imageGetRawData(*output, side, lod, output->m_data, output->m_size, mip);
-
-				const uint32_t dstWidth = mip.m_width;
-				const uint32_t dstPitch = dstWidth*16;
-
-				const float minAngle = bx::atan2(1.0f, float(dstWidth) );
-				const float maxAngle = bx::kPiHalf;
-				const float toFilterSize     = 1.0f/(minAngle*dstWidth*2.0f);
-				const float glossiness       = glossinessFor(lod, float(numMips) );
-				const float roughness        = 1.0f-glossiness;
-				const float specularPowerRef = bx::pow(2.0f, glossiness*glossScale + glossBias);
-				const float specularPower    = applyLightingModel(specularPowerRef, _lightingModel);
-				const float filterAngle      = bx::clamp(cosinePowerFilterAngle(specularPower), minAngle, maxAngle);
-				const float cosAngle   = bx::max(0.0f, bx::cos(filterAngle) );
-				const float texelSize  = 1.0f/float(dstWidth);
-				const float filterSize = bx::max(texelSize, filterAngle * toFilterSize);
-
-				for (uint32_t yy = 0; yy < dstWidth; ++yy)
-				{
-					for (uint32_t xx = 0; xx < dstWidth; ++xx)
-					{
-						float* dstData = (float*)&mip.m_data[yy*dstPitch+xx*16];
+				BX_ALIGNED_FREE(_allocator, params.samples, 16);
+			}
+		}
 
-						const float uu = float(xx)*texelSize*2.0f - 1.0f;
-						const float vv = float(yy)*texelSize*2.0f - 1.0f;
+		BX_ALIGNED_FREE(_allocator, ctx, 16);
+		imageFree(input);
 
-						bx::Vec3 dir = texelUvToDir(side, uu, vv);
+		return output;
+	}
 
-						if (LightingModel::Ggx == _lightingModel)
-						{
-							processFilterAreaGgx(dstData, *input, lod, dir, roughness);
-						}
-						else
-						{
-							Aabb aabb[6];
-							calcFilterArea(aabb, dir, filterSize);
+	ImageContainer* imageCubemapIrradianceSh(bx::AllocatorI* _allocator, const ImageContainer& _image, bx::Error* _err)
+	{
+		if (!_image.m_cubeMap)
+		{
+			BX_ERROR_SET(_err, BIMG_ERROR, "Input image is not cubemap.");
+			return NULL;
+		}
 
-							processFilterArea(dstData, *input, *nsa, lod, aabb, dir, specularPower, cosAngle);
-						}
+		ImageContainer* input = imageConvert(_allocator, TextureFormat::RGBA32F, _image, false);
+
+		// An Efficient Representation for Irradiance Environment Maps
+		// https://web.archive.org/web/20180622232018/https://graphics.stanford.edu/papers/envmap/envmap.pdf
+		//
+		constexpr uint32_t kNumCoeffs = 9;
+
+		const float kBasis[kNumCoeffs] =
+		{
+			0.282095f,
+			0.488603f, 0.488603f, 0.488603f,
+			1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f,
+		};
+
+		// Clamped cosine convolution per band, divided by pi.
+		const float kBand[kNumCoeffs] =
+		{
+			1.0f,
+			2.0f/3.0f, 2.0f/3.0f, 2.0f/3.0f,
+			0.25f, 0.25f, 0.25f, 0.25f, 0.25f,
+		};
+
+		double sh[kNumCoeffs][3] = {};
+		double weightSum = 0.0;
+
+		const uint32_t faceSize   = input->m_width;
+		const float invFaceSize   = 1.0f/float(faceSize);
+
+		for (uint8_t side = 0; side < 6; ++side)
+		{
+			ImageMip mip;
+			imageGetRawData(*input, side, 0, input->m_data, input->m_size, mip);
+
+			for (uint32_t yy = 0; yy < faceSize; ++yy)
+			{
+				const float vv = (float(yy) + 0.5f)*invFaceSize*2.0f - 1.0f;
+
+				for (uint32_t xx = 0; xx < faceSize; ++xx)
+				{
+					const float uu = (float(xx) + 0.5f)*invFaceSize*2.0f - 1.0f;
+
+					const float* rgba = (const float*)&mip.m_data[(yy*faceSize + xx)*16];
+					const bx::Vec3 dir  = texelUvToDir(side, uu, vv);
+					const float weight  = texelSolidAngle(uu, vv, invFaceSize);
+
+					const float basis[kNumCoeffs] =
+					{
+						1.0f,
+						dir.y, dir.z, dir.x,
+						dir.x*dir.y, dir.y*dir.z, 3.0f*dir.z*dir.z - 1.0f, dir.x*dir.z, dir.x*dir.x - dir.y*dir.y,
+					};
+
+					for (uint32_t ii = 0; ii < kNumCoeffs; ++ii)
+					{
+						const float ww = weight * basis[ii] * kBasis[ii];
+						sh[ii][0] += rgba[0] * ww;
+						sh[ii][1] += rgba[1] * ww;
+						sh[ii][2] += rgba[2] * ww;
 					}
+
+					weightSum += weight;
 				}
 			}
+		}
+
+		imageFree(input);
+
+		ImageContainer* output = imageAlloc(_allocator, TextureFormat::RGBA32F, kNumCoeffs, 1, 1, 1, false, false);
+
+		ImageMip mip;
+		imageGetRawData(*output, 0, 0, output->m_data, output->m_size, mip);
+		float* dstData = (float*)const_cast<uint8_t*>(mip.m_data);
+
+		// Texel solid angles sum up to 4*pi, normalizing by actual sum removes remaining error.
+		const double norm = 4.0 * bx::kPi / weightSum;
+
+		for (uint32_t ii = 0; ii < kNumCoeffs; ++ii)
+		{
+			const float scale = float(norm) * kBand[ii] * kBasis[ii];
+			dstData[ii*4 + 0] = float(sh[ii][0]) * scale;
+			dstData[ii*4 + 1] = float(sh[ii][1]) * scale;
+			dstData[ii*4 + 2] = float(sh[ii][2]) * scale;
+			dstData[ii*4 + 3] = 0.0f;
+		}
+
+		return output;
+	}
+
+	static float geometrySmithGgxIbl(float _ndotv, float _ndotl, float _roughness)
+	{
+		// Schlick-GGX with k = alpha/2, the remapping used for image based lighting.
+		const float kk = bx::square(_roughness) * 0.5f;
+		const float gv = _ndotv / (_ndotv * (1.0f - kk) + kk);
+		const float gl = _ndotl / (_ndotl * (1.0f - kk) + kk);
+		return gv * gl;
+	}
+
+	ImageContainer* imageBrdfLutGgx(bx::AllocatorI* _allocator, uint16_t _size, bx::Error* _err)
+	{
+		if (0 == _size)
+		{
+			BX_ERROR_SET(_err, BIMG_ERROR, "Invalid BRDF LUT size.");
+			return NULL;
+		}
+
+		ImageContainer* output = imageAlloc(_allocator, TextureFormat::RG16F, _size, _size, 1, 1, false, false);
+
+		ImageMip mip;
+		imageGetRawData(*output, 0, 0, output->m_data, output->m_size, mip);
+		uint16_t* dstData = (uint16_t*)const_cast<uint8_t*>(mip.m_data);
+
+		// Real Shading in Unreal Engine 4
+		// https://web.archive.org/web/20180710193013/https://cdn2.unrealengine.com/Resources/files/2013SiggraphPresentationsNotes-26876-cdn.pdf
+		//
+		constexpr int32_t kNumSamples = 512;
+		const float kGoldenSection = 0.61803398875f;
+
+		const bx::Vec3 normal   = { 0.0f, 0.0f, 1.0f };
+		const bx::Vec3 tangentX = { 1.0f, 0.0f, 0.0f };
+		const bx::Vec3 tangentY = { 0.0f, 1.0f, 0.0f };
+
+		for (uint32_t yy = 0; yy < _size; ++yy)
+		{
+			const float roughness = (float(yy) + 0.5f) / float(_size);
 
-			if (NULL != nsa)
+			for (uint32_t xx = 0; xx < _size; ++xx)
 			{
-				imageFree(nsa);
+				const float ndotv = (float(xx) + 0.5f) / float(_size);
+				const bx::Vec3 view = { bx::sqrt(1.0f - bx::square(ndotv) ), 0.0f, ndotv };
+
+				float scale = 0.0f;
+				float bias  = 0.0f;
+				float offset = kGoldenSection;
+
+				for (uint32_t ii = 0; ii < kNumSamples; ++ii)
+				{
+					offset += kGoldenSection;
+					const float vv = ii/float(kNumSamples);
+
+					const bx::Vec3 hh  = importanceSampleGgx(offset, vv, roughness, normal, tangentX, tangentY);
+					const float vdoth  = bx::dot(view, hh);
+					const bx::Vec3 ll  = bx::sub(bx::mul(hh, 2.0f * vdoth), view);
+
+					const float ndotl = bx::clamp(ll.z, 0.0f, 1.0f);
+
+					if (ndotl > 0.0f)
+					{
+						const float ndoth = bx::clamp(hh.z, 0.0f, 1.0f);
+						const float vdothClamped = bx::clamp(vdoth, 0.0f, 1.0f);
+
+						const float gg   = geometrySmithGgxIbl(ndotv, ndotl, roughness);
+						const float gVis = gg * vdothClamped / (ndoth * ndotv);
+						const float fc   = bx::pow(1.0f - vdothClamped, 5.0f);
+
+						scale += (1.0f - fc) * gVis;
+						bias  += fc * gVis;
+					}
+				}
+
+				dstData[(yy*_size + xx)*2 + 0] = bx::halfFromFloat(scale / float(kNumSamples) );
+				dstData[(yy*_size + xx)*2 + 1] = bx::halfFromFloat(bias  / float(kNumSamples) );
 			}
 		}
 
@@ -20,6 +20,7 @@
 #include <bx/bx.h>
 #include <bx/commandline.h>
 #include <bx/file.h>
+#include <bx/timer.h>
 
 #include <string>
 
@@ -43,6 +44,8 @@ struct Options
 			"\t      pma: %s\n"
 			"\t      sdf: %s\n"
 			"\t radiance: %s\n"
+			"\t  threads: %d\n"
+			"\tirradiance: %s\n"
 			"\t equirect: %s\n"
 			"\t    strip: %s\n"
 			"\t   linear: %s\n"
@@ -56,6 +59,8 @@ struct Options
 			, pma       ? "true" : "false"
 			, sdf       ? "true" : "false"
 			, radiance  ? "true" : "false"
+			, threads
+			, irradianceSh ? "sh" : "none"
 			, equirect  ? "true" : "false"
 			, strip     ? "true" : "false"
 			, linear    ? "true" : "false"
@@ -64,6 +69,7 @@ struct Options
 
 	uint32_t maxSize = UINT32_MAX;
 	uint32_t mipSkip = 0;
+	uint32_t threads = 0;
 	float edge       = 0.0f;
 	bimg::TextureFormat::Enum format   = bimg::TextureFormat::Count;
 	bimg::Quality::Enum quality        = bimg::Quality::Default;
@@ -77,6 +83,7 @@ struct Options
 	bool sdf       = false;
 	bool alphaTest = false;
 	bool linear    = false;
+	bool irradianceSh = false;
 };
 
 void imageRgba32fNormalize(void* _dst, uint32_t _width, uint32_t _height, uint32_t _srcPitch, const void* _src)
@@ -251,6 +258,7 @@ bimg::ImageContainer* convert(bx::AllocatorI* _allocator, const void* _inputData
 			&& !_options.iqa
 			&& !_options.pma
 			&& (bimg::LightingModel::Count == _options.radiance)
+			&& !_options.irradianceSh
 			;
 
 		if (!_options.sdf
@@ -344,15 +352,54 @@ bimg::ImageContainer* convert(bx::AllocatorI* _allocator, const void* _inputData
 			bimg::imageFree(dst);
 		}
 
+		if (_options.irradianceSh)
+		{
+			output = bimg::imageCubemapIrradianceSh(_allocator, *input, _err);
+
+			if (!_err->isOk() )
+			{
+				return NULL;
+			}
+
+			if (bimg::TextureFormat::Count != _options.format
+			&&  bimg::TextureFormat::RGBA32F != _options.format)
+			{
+				bimg::ImageContainer* temp = bimg::imageConvert(_allocator, _options.format, *output);
+				bimg::imageFree(output);
+
+				output = temp;
+			}
+
+			bimg::imageFree(input);
+			return output;
+		}
+
 		if (bimg::LightingModel::Count != _options.radiance)
 		{
-			output = bimg::imageCubemapRadianceFilter(_allocator, *input, _options.radiance, _err);
+			const int64_t start = bx::getHPCounter();
+
+			output = bimg::imageCubemapRadianceFilter(_allocator, *input, _options.radiance, _err, _options.threads);
 
 			if (!_err->isOk() )
 			{
 				return NULL;
 			}
 
+			const double elapsedMs = double(bx::getHPCounter() - start) * 1000.0 / double(bx::getHPFrequency() );
+
+			uint32_t numTexels = 0;
+			for (uint8_t lod = 1; lod < output->m_numMips; ++lod)
+			{
+				const uint32_t width = bx::max<uint32_t>(output->m_width >> lod, 1);
+				numTexels += 6*width*width;
+			}
+
+			bx::printf("Radiance filter: %u texels in %.1f ms, %.3f Mtexels/s.\n"
+				, numTexels
+				, elapsedMs
+				, double(numTexels) / bx::max(elapsedMs, 0.001) / 1000.0
+				);
+
 			if (bimg::TextureFormat::RGBA32F != outputFormat)
 			{
 				bimg::ImageContainer* temp = bimg::imageEncode(_allocator, outputFormat, _options.quality, *output);
@@ -941,6 +988,9 @@ void help(const char* _error = NULL, bool _showHelp = true)
 		  "      --max <max size>     Maximum width/height (image will be scaled down and\n"
 		  "                           aspect ratio will be preserved)\n"
 		  "      --radiance <model>   Radiance cubemap filter. (Lighting model: Phong, PhongBrdf, Blinn, BlinnBrdf, GGX)\n"
+		  "      --threads <count>    Number of radiance filter threads. (Default: one per logical processor)\n"
+		  "      --irradiance <type>  Irradiance of cubemap. (Type: SH, 9x1 image of spherical harmonics coefficients)\n"
+		  "      --brdf-lut <size>    GGX environment BRDF lookup table, RG16F, no input file. (Implies --linear)\n"
 		  "      --as <extension>     Save as.\n"
 		  "      --formats            List all supported formats.\n"
 		  "      --validate           *DEBUG* Validate that output image produced matches after loading.\n"
@@ -1036,8 +1086,11 @@ int main(int _argc, const char* _argv[])
 		return bx::kExitSuccess;
     }
 
+	const char* brdfLut = cmdLine.findOption("brdf-lut");
+
 	const char* inputFileName = cmdLine.findOption('f');
-	if (NULL == inputFileName)
+	if (NULL == inputFileName
+	&&  NULL == brdfLut)
 	{
 		help("Input file must be specified.");
 		return bx::kExitFailure;
@@ -1106,6 +1159,16 @@ int main(int _argc, const char* _argv[])
 		}
 	}
 
+	const char* threads = cmdLine.findOption("threads");
+	if (NULL != threads)
+	{
+		if (!bx::fromString(&options.threads, threads) )
+		{
+			help("Parsing `--threads` failed.");
+			return bx::kExitFailure;
+		}
+	}
+
 	const char* mipSkip = cmdLine.findOption("mipskip");
 	if (NULL != mipSkip)
 	{
@@ -1183,40 +1246,72 @@ int main(int _argc, const char* _argv[])
 		}
 	}
 
+	const char* irradiance = cmdLine.findOption("irradiance");
+	if (NULL != irradiance)
+	{
+		if (0 == bx::strCmpI(irradiance, "sh") ) { options.irradianceSh = true; }
+		else
+		{
+			help("Invalid irradiance type specified.");
+			return bx::kExitFailure;
+		}
+	}
+
 	const bool validate = cmdLine.hasArg("validate");
 
 	bx::Error err;
 	bx::FileReader reader;
-	if (!bx::open(&reader, inputFileName, &err) )
-	{
-		help("Failed to open input file.", err);
-		return bx::kExitFailure;
-	}
-
-	uint32_t inputSize = (uint32_t)bx::getSize(&reader);
-	if (0 == inputSize)
-	{
-		help("Failed to read input file.", err);
-		return bx::kExitFailure;
-	}
+	uint8_t* inputData = NULL;
+	uint32_t inputSize = 0;
 
 	bx::DefaultAllocator defaultAllocator;
 	AlignedAllocator allocator(&defaultAllocator, 16);
 
-	uint8_t* inputData = (uint8_t*)BX_ALLOC(&allocator, inputSize);
-
-	bx::read(&reader, inputData, inputSize, &err);
-	bx::close(&reader);
+	bimg::ImageContainer* output = NULL;
 
-	if (!err.isOk() )
+	if (NULL != brdfLut)
 	{
-		help("Failed to read input file.", err);
-		return bx::kExitFailure;
+		uint32_t size;
+		if (!bx::fromString(&size, brdfLut)
+		||  UINT16_MAX < size)
+		{
+			help("Parsing `--brdf-lut` failed.");
+			return bx::kExitFailure;
+		}
+
+		options.linear = true;
+		output = bimg::imageBrdfLutGgx(&allocator, uint16_t(size), &err);
 	}
+	else
+	{
+		if (!bx::open(&reader, inputFileName, &err) )
+		{
+			help("Failed to open input file.", err);
+			return bx::kExitFailure;
+		}
 
-	bimg::ImageContainer* output = convert(&allocator, inputData, inputSize, options, &err);
+		inputSize = (uint32_t)bx::getSize(&reader);
+		if (0 == inputSize)
+		{
+			help("Failed to read input file.", err);
+			return bx::kExitFailure;
+		}
 
-	BX_FREE(&allocator, inputData);
+		inputData = (uint8_t*)BX_ALLOC(&allocator, inputSize);
+
+		bx::read(&reader, inputData, inputSize, &err);
+		bx::close(&reader);
+
+		if (!err.isOk() )
+		{
+			help("Failed to read input file.", err);
+			return bx::kExitFailure;
+		}
+
+		output = convert(&allocator, inputData, inputSize, options, &err);
+
+		BX_FREE(&allocator, inputData);
+	}
 
 	if (NULL != output)
 	{
@@ -30,6 +30,9 @@ namespace bx
 	///
 	size_t getProcessMemoryUsed();
 
+	/// Returns number of logical processors available to process, at least one.
+	uint32_t getNumCpus();
+
 	///
 	void* dlopen(const FilePath& _filePath);
 
@@ -173,6 +173,27 @@ namespace bx
 #endif // BX_PLATFORM_*
 	}
 
+	uint32_t getNumCpus()
+	{
+#if BX_PLATFORM_WINDOWS
+		SYSTEM_INFO info;
+		::GetSystemInfo(&info);
+		return 0 < info.dwNumberOfProcessors ? uint32_t(info.dwNumberOfProcessors) : 1;
+#elif  BX_PLATFORM_ANDROID \
+	|| BX_PLATFORM_BSD     \
+	|| BX_PLATFORM_HAIKU   \
+	|| BX_PLATFORM_HURD    \
+	|| BX_PLATFORM_IOS     \
+	|| BX_PLATFORM_LINUX   \
+	|| BX_PLATFORM_OSX     \
+	|| BX_PLATFORM_RPI
+		const long num = ::sysconf(_SC_NPROCESSORS_ONLN);
+		return 0 < num ? uint32_t(num) : 1;
+#else
+		return 1;
+#endif // BX_PLATFORM_*
+	}
+
 	void* dlopen(const FilePath& _filePath)
 	{
 #if BX_PLATFORM_WINDOWS
@@ -4,6 +4,14 @@ set(HOMEWORK_DIR "${CMAKE_CURRENT_SOURCE_DIR}/homework")
 set(HOMEWORK_SOURCES
         ${HOMEWORK_DIR}/homework.cpp
         ${HOMEWORK_DIR}/mesh_producer.h
+        ${HOMEWORK_DIR}/cascaded_shadow.h
+        ${HOMEWORK_DIR}/omni_shadow.h
+        ${HOMEWORK_DIR}/program_cache.h
+        ${HOMEWORK_DIR}/render_list.h
+        ${HOMEWORK_DIR}/resource_cache.h
+        ${HOMEWORK_DIR}/clustered_lights.h
+        ${HOMEWORK_DIR}/ibl.h
+        ${HOMEWORK_DIR}/tone_mapping.h
         ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/3rdparty/FileBrowser/ImGuiFileBrowser.h
         ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/3rdparty/FileBrowser/ImGuiFileBrowser.cpp
         ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/3rdparty/FileBrowser/Dirent/dirent.h)
@@ -12,39 +20,154 @@ add_executable(homework ${HOMEWORK_SOURCES})
 target_link_libraries(homework example-common)
 target_include_directories(homework PRIVATE ${HOMEWORK_DIR})
 
+# shader binaries are compiled with the shaderc built from bgfx/tools/shaderc, the mesh_fs variants and
+# the Direct3D set are only generated here and not kept in the repository
+set(SHADERC $<TARGET_FILE:shaderc>)
+file(MAKE_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl)
+
 add_custom_target(shaders
         ALL
         SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_fs.sc
         SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_fs.sc
         SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_fs.sc
         SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc
-        SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/uniforms.sh ${CMAKE_CURRENT_SOURCE_DIR}/shaders/varying.def.sc
+        SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_fs.sc
+        SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_vs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_fs.sc
+        SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_clear_cs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_cs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/exposure_cs.sc ${CMAKE_CURRENT_SOURCE_DIR}/shaders/exposure.sh
+        SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/shaders/uniforms.sh ${CMAKE_CURRENT_SOURCE_DIR}/shaders/clustered.sh ${CMAKE_CURRENT_SOURCE_DIR}/shaders/invariant.sh ${CMAKE_CURRENT_SOURCE_DIR}/shaders/varying.def.sc
         )
 
 add_custom_command(TARGET shaders
         PRE_BUILD
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_vs.bin --type v --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_fs.bin --type f --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/light_vs.bin --type v --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/light_fs.bin --type f --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/sky_vs.bin --type v --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/sky_fs.bin --type f --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_vs.bin --type v --platform windows
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_fs.bin --type f --platform windows
-
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_vs.bin --type v --platform windows -p vs_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_fs.bin --type f --platform windows -p ps_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/light_vs.bin --type v --platform windows -p vs_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/light_fs.bin --type f --platform windows -p ps_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/sky_vs.bin --type v --platform windows -p vs_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/sky_fs.bin --type f --platform windows -p ps_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_vs.bin --type v --platform windows -p vs_5_0
-        COMMAND ${CMAKE_CURRENT_SOURCE_DIR}/tools/shaderc.exe ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_fs.bin --type f --platform windows -p ps_5_0
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_vs_instanced.bin --type v --platform windows --define INSTANCED=1
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_vs_tangent.bin --type v --platform windows --define USE_VERTEX_TANGENTS=1
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_vs_instanced_tangent.bin --type v --platform windows --define "INSTANCED=1$<SEMICOLON>USE_VERTEX_TANGENTS=1"
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/light_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/light_fs.bin --type f --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/sky_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/sky_fs.bin --type f --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_vs_instanced.bin --type v --platform windows --define INSTANCED=1
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_fs.bin --type f --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/shadow_fs_pd.bin --type f --platform windows --define SHADOW_PACKED_DEPTH=1
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/depth_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/depth_vs_instanced.bin --type v --platform windows --define INSTANCED=1
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/depth_fs.bin --type f --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/tonemap_vs.bin --type v --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/tonemap_fs.bin --type f --platform windows
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_clear_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/histogram_clear_cs.bin --type c --platform linux -p 430
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/histogram_cs.bin --type c --platform linux -p 430
+        COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/exposure_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/exposure_cs.bin --type c --platform linux -p 430
+        VERBATIM
         )
 
+# shaderc compiles HLSL through the D3D compiler, which is only available on Windows, so is the
+# Direct3D renderer
+if (WIN32)
+    file(MAKE_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11)
+    add_custom_command(TARGET shaders
+            PRE_BUILD
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_vs_instanced.bin --type v --platform windows -p vs_5_0 --define INSTANCED=1
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_vs_tangent.bin --type v --platform windows -p vs_5_0 --define USE_VERTEX_TANGENTS=1
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_vs_instanced_tangent.bin --type v --platform windows -p vs_5_0 --define "INSTANCED=1$<SEMICOLON>USE_VERTEX_TANGENTS=1"
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/light_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/light_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/light_fs.bin --type f --platform windows -p ps_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/sky_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/sky_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/sky_fs.bin --type f --platform windows -p ps_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_vs_instanced.bin --type v --platform windows -p vs_5_0 --define INSTANCED=1
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_fs.bin --type f --platform windows -p ps_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/shadow_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/shadow_fs_pd.bin --type f --platform windows -p ps_5_0 --define SHADOW_PACKED_DEPTH=1
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/depth_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/depth_vs_instanced.bin --type v --platform windows -p vs_5_0 --define INSTANCED=1
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/depth_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/depth_fs.bin --type f --platform windows -p ps_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_vs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/tonemap_vs.bin --type v --platform windows -p vs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/tonemap_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/tonemap_fs.bin --type f --platform windows -p ps_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_clear_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/histogram_clear_cs.bin --type c --platform windows -p cs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/histogram_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/histogram_cs.bin --type c --platform windows -p cs_5_0
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/exposure_cs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/exposure_cs.bin --type c --platform windows -p cs_5_0
+            VERBATIM
+            )
+endif ()
+
+# mesh_fs permutations, one binary per valid feature mask named mesh_fs_<mask>.bin
+# the bit order must match RenderCore::MeshFeature in homework/program_cache.h
+set(MESH_FS_FEATURES
+        USE_PBR_MAPS
+        USE_BLINN_PHONG
+        USE_PBR
+        USE_DIFFUSE_IBL
+        USE_SPECULAR_IBL
+        USE_SHADOW_MAP
+        USE_PCSS
+        SHADOW_PACKED_DEPTH
+        USE_VERTEX_TANGENTS
+        USE_POINT_SHADOW)
+list(LENGTH MESH_FS_FEATURES MESH_FS_NUM_FEATURES)
+math(EXPR MESH_FS_LAST_BIT "${MESH_FS_NUM_FEATURES} - 1")
+math(EXPR MESH_FS_LAST_MASK "(1 << ${MESH_FS_NUM_FEATURES}) - 1")
+
+set(MESH_FS_VARIANT_COMMANDS)
+foreach(MASK RANGE ${MESH_FS_LAST_MASK})
+    # skip masks that RenderCore::MeshFeature::sanitize never produces
+    math(EXPR BLINN_PHONG_AND_PBR "${MASK} & 6")
+    math(EXPR SHADOW_MAP "${MASK} & 32")
+    math(EXPR SHADOW_OPTIONS "${MASK} & 704")
+    math(EXPR PCSS_AND_POINT_SHADOW "${MASK} & 576")
+    if(BLINN_PHONG_AND_PBR EQUAL 6 OR (SHADOW_MAP EQUAL 0 AND NOT SHADOW_OPTIONS EQUAL 0)
+            OR PCSS_AND_POINT_SHADOW EQUAL 576)
+        continue()
+    endif()
+
+    # the mask itself is always defined so the define list is never empty
+    set(DEFINES "MESH_FEATURES=${MASK}")
+    foreach(BIT RANGE ${MESH_FS_LAST_BIT})
+        math(EXPR ENABLED "(${MASK} >> ${BIT}) & 1")
+        if(ENABLED)
+            list(GET MESH_FS_FEATURES ${BIT} FEATURE)
+            set(DEFINES "${DEFINES}$<SEMICOLON>${FEATURE}=1")
+        endif()
+    endforeach()
+
+    list(APPEND MESH_FS_VARIANT_COMMANDS
+            COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/glsl/mesh_fs_${MASK}.bin --type f --platform windows --define "${DEFINES}"
+            )
+    if (WIN32)
+        list(APPEND MESH_FS_VARIANT_COMMANDS
+                COMMAND ${SHADERC} ARGS -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/examples/common -i ${CMAKE_CURRENT_SOURCE_DIR}/bgfx/src/ -f ${CMAKE_CURRENT_SOURCE_DIR}/shaders/mesh_fs.sc -o ${CMAKE_CURRENT_SOURCE_DIR}/shaders/dx11/mesh_fs_${MASK}.bin --type f --platform windows -p ps_5_0 --define "${DEFINES}"
+                )
+    endif ()
+endforeach()
+
+add_custom_command(TARGET shaders
+        PRE_BUILD
+        ${MESH_FS_VARIANT_COMMANDS}
+        VERBATIM
+        )
+
+add_dependencies(shaders shaderc)
 add_dependencies(homework shaders)
 
+# Headless build for benchmarking on machines without a GPU, the example common code is
+# compiled against entry_noop.cpp and renders through the noop renderer, e.g.
+#   homework-bench --bench 500 --bench-out stats.csv
+get_target_property(EXAMPLE_COMMON_SOURCES example-common SOURCES)
+add_library(example-common-noop STATIC EXCLUDE_FROM_ALL ${EXAMPLE_COMMON_SOURCES})
+target_include_directories(example-common-noop PUBLIC ${BGFX_DIR}/examples/common)
+target_link_libraries(example-common-noop PUBLIC bgfx bx bimg dear-imgui meshoptimizer)
+target_compile_definitions(example-common-noop PUBLIC ENTRY_CONFIG_USE_NOOP=1)
+target_compile_definitions(example-common-noop PRIVATE "-D_CRT_SECURE_NO_WARNINGS" "-D__STDC_FORMAT_MACROS" "-DENTRY_CONFIG_IMPLEMENT_MAIN=1")
+set_target_properties(example-common-noop PROPERTIES FOLDER "bgfx/examples")
+
+add_executable(homework-bench ${HOMEWORK_SOURCES})
+target_link_libraries(homework-bench example-common-noop)
+target_include_directories(homework-bench PRIVATE ${HOMEWORK_DIR})
+add_dependencies(homework-bench shaders)
+
 # Special Visual Studio Flags
 if (MSVC)
     target_compile_definitions(homework PRIVATE "_CRT_SECURE_NO_WARNINGS")
+    target_compile_definitions(homework-bench PRIVATE "_CRT_SECURE_NO_WARNINGS")
 endif ()
@@ -0,0 +1,214 @@
+//
+// Cascaded shadow map fitting for the directional shadow pass.
+//
+
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_CASCADED_SHADOW_H
+#define ESTARHOMEWORK_CASCADED_SHADOW_H
+
+namespace RenderCore::Shadow {
+    constexpr uint8_t kMaxCascades = 4;
+
+    // atlas tiles, one per cascade of the directional light or per cube face of the point light
+    constexpr uint8_t kMaxViews = 6;
+
+    // how far behind a cascade (towards the light) casters are still captured
+    constexpr float kCasterExtent = 100.0f;
+
+    // number of PCF taps, must match NUM_SAMPLES in mesh_fs.sc
+    constexpr uint16_t kNumPoissonSamples = 64;
+    constexpr uint16_t kNumPoissonRings = 10;
+
+    // spiral poisson disk in the unit circle, radius grows with the sample index so the
+    // outermost samples are stored last, packed two samples per vec4 for u_poissonDisk
+    static void poissonDisk(float *_samples, uint16_t _numSamples, uint16_t _numRings) {
+        const float angleStep = bx::kPi2 * float(_numRings) / float(_numSamples);
+        const float radiusStep = 1.0f / float(_numSamples);
+
+        float angle = 0.0f;
+        float radius = radiusStep;
+        for (uint16_t ii = 0; ii < _numSamples; ++ii) {
+            const float rr = bx::pow(radius, 0.75f);
+            _samples[ii * 2 + 0] = bx::cos(angle) * rr;
+            _samples[ii * 2 + 1] = bx::sin(angle) * rr;
+            radius += radiusStep;
+            angle += angleStep;
+        }
+    }
+
+    struct Cascades {
+        // number of atlas tiles in use
+        uint8_t m_numCascades;
+        uint16_t m_cascadeSize;
+        uint16_t m_atlasWidth;
+        uint16_t m_atlasHeight;
+
+        // view space far distance of each cascade, packed for u_cascadeSplits
+        float m_splits[kMaxCascades];
+
+        // light view and projection per tile, cascades share the view and fit an ortho projection each
+        float m_lightView[kMaxViews][16];
+        float m_lightProj[kMaxViews][16];
+
+        // world space to atlas tile texture space, uploaded as u_lightMtx
+        float m_lightMtx[kMaxViews][16];
+
+        // atlas tile bounds in texture space (min u, min v, max u, max v)
+        float m_tiles[kMaxViews][4];
+
+        // atlas tile view rect in texels (x, y, width, height)
+        uint16_t m_rects[kMaxViews][4];
+    };
+
+    // cascades are laid out in a 2x2 grid at most, 1x1 for a single cascade and 2x1 for two,
+    // the six point light faces in a 3x2 grid
+    static void atlasLayout(uint8_t _numCascades, uint8_t &_cols, uint8_t &_rows) {
+        _cols = _numCascades > 4 ? 3 : _numCascades > 1 ? 2 : 1;
+        _rows = _numCascades > 2 ? 2 : 1;
+    }
+
+    // places tile _index in the atlas and derives its world to tile texture space matrix from the
+    // light view and projection already stored for it
+    static void placeTile(Cascades &_cascades, uint8_t _index, uint8_t _cols, uint8_t _rows) {
+        const bgfx::Caps *caps = bgfx::getCaps();
+        const uint16_t size = _cascades.m_cascadeSize;
+        const float sz = caps->homogeneousDepth ? 0.5f : 1.0f;
+        const float tz = caps->homogeneousDepth ? 0.5f : 0.0f;
+        const float tileW = 1.0f / float(_cols);
+        const float tileH = 1.0f / float(_rows);
+
+        // atlas placement, view rect is top-left based while texture v depends on the renderer
+        const uint8_t col = _index % _cols;
+        const uint8_t row = _index / _cols;
+        _cascades.m_rects[_index][0] = uint16_t(col * size);
+        _cascades.m_rects[_index][1] = uint16_t(row * size);
+        _cascades.m_rects[_index][2] = size;
+        _cascades.m_rects[_index][3] = size;
+
+        const float u0 = float(col) * tileW;
+        const float v0 = caps->originBottomLeft ? 1.0f - float(row + 1) * tileH : float(row) * tileH;
+        _cascades.m_tiles[_index][0] = u0;
+        _cascades.m_tiles[_index][1] = v0;
+        _cascades.m_tiles[_index][2] = u0 + tileW;
+        _cascades.m_tiles[_index][3] = v0 + tileH;
+
+        // cross-platform texture coordinate procession, scaled into the tile
+        const float sy = caps->originBottomLeft ? 0.5f : -0.5f;
+        const float mtxCrop[16] =
+                {
+                        0.5f * tileW, 0.0f, 0.0f, 0.0f,
+                        0.0f, sy * tileH, 0.0f, 0.0f,
+                        0.0f, 0.0f, sz, 0.0f,
+                        u0 + 0.5f * tileW, v0 + 0.5f * tileH, tz, 1.0f,
+                };
+
+        float mtxTmp[16];
+        bx::mtxMul(mtxTmp, _cascades.m_lightProj[_index], mtxCrop);
+        bx::mtxMul(_cascades.m_lightMtx[_index], _cascades.m_lightView[_index], mtxTmp);
+    }
+
+    // unused tiles keep valid data so the uniform arrays are always fully initialized
+    static void fillUnusedTiles(Cascades &_cascades) {
+        for (uint8_t ii = _cascades.m_numCascades; ii < kMaxViews; ++ii) {
+            bx::memCopy(_cascades.m_lightView[ii], _cascades.m_lightView[0], sizeof(float) * 16);
+            bx::memCopy(_cascades.m_lightProj[ii], _cascades.m_lightProj[0], sizeof(float) * 16);
+            bx::memCopy(_cascades.m_lightMtx[ii], _cascades.m_lightMtx[0], sizeof(float) * 16);
+            bx::memCopy(_cascades.m_tiles[ii], _cascades.m_tiles[0], sizeof(float) * 4);
+            bx::memCopy(_cascades.m_rects[ii], _cascades.m_rects[0], sizeof(uint16_t) * 4);
+        }
+    }
+
+    // practical split scheme, blends logarithmic and uniform split distances by _lambda
+    static void computeSplits(float *_splits, uint8_t _numCascades, float _near, float _far, float _lambda) {
+        const float ratio = _far / _near;
+        for (uint8_t ii = 0; ii < _numCascades; ++ii) {
+            const float si = float(ii + 1) / float(_numCascades);
+            const float logSplit = _near * bx::pow(ratio, si);
+            const float uniSplit = _near + (_far - _near) * si;
+            _splits[ii] = bx::lerp(uniSplit, logSplit, _lambda);
+        }
+
+        for (uint8_t ii = _numCascades; ii < kMaxCascades; ++ii) {
+            _splits[ii] = _far;
+        }
+    }
+
+    // bounding sphere of the camera frustum slice [_sliceNear, _sliceFar] in world space
+    static bx::Sphere sliceBoundingSphere(const float *_invView, float _fovy, float _aspect, float _sliceNear,
+                                          float _sliceFar) {
+        const float tanHalfFov = bx::tan(bx::toRad(_fovy) * 0.5f);
+        const float depth[2] = {_sliceNear, _sliceFar};
+
+        bx::Vec3 corners[8] = {bx::init::Zero, bx::init::Zero, bx::init::Zero, bx::init::Zero,
+                               bx::init::Zero, bx::init::Zero, bx::init::Zero, bx::init::Zero};
+        bx::Vec3 center = bx::init::Zero;
+        for (uint8_t ii = 0; ii < 8; ++ii) {
+            const float zz = depth[ii >> 2];
+            const float hh = zz * tanHalfFov;
+            const float ww = hh * _aspect;
+            const bx::Vec3 viewCorner = {ii & 1 ? ww : -ww, ii & 2 ? hh : -hh, zz};
+            corners[ii] = bx::mul(viewCorner, _invView);
+            center = bx::add(center, corners[ii]);
+        }
+        center = bx::mul(center, 1.0f / 8.0f);
+
+        float radius = 0.0f;
+        for (uint8_t ii = 0; ii < 8; ++ii) {
+            radius = bx::max(radius, bx::length(bx::sub(corners[ii], center)));
+        }
+
+        // quantize the radius so the projection size stays constant while the camera rotates
+        radius = bx::ceil(radius * 16.0f) / 16.0f;
+
+        return {center, radius};
+    }
+
+    static void update(Cascades &_cascades, uint8_t _numCascades, uint16_t _cascadeSize, const float *_view,
+                       float _fovy, float _aspect, float _near, float _far, float _splitLambda,
+                       const bx::Vec3 &_lightPos, const bx::Vec3 &_lightAt) {
+        const bgfx::Caps *caps = bgfx::getCaps();
+
+        uint8_t cols, rows;
+        atlasLayout(_numCascades, cols, rows);
+
+        _cascades.m_numCascades = _numCascades;
+        _cascades.m_cascadeSize = _cascadeSize;
+        _cascades.m_atlasWidth = uint16_t(_cascadeSize * cols);
+        _cascades.m_atlasHeight = uint16_t(_cascadeSize * rows);
+
+        computeSplits(_cascades.m_splits, _numCascades, _near, _far, _splitLambda);
+
+        float lightView[16];
+        bx::mtxLookAt(lightView, _lightPos, _lightAt);
+
+        float invView[16];
+        bx::mtxInverse(invView, _view);
+
+        float sliceNear = _near;
+        for (uint8_t ii = 0; ii < _numCascades; ++ii) {
+            const float sliceFar = _cascades.m_splits[ii];
+            const bx::Sphere sphere = sliceBoundingSphere(invView, _fovy, _aspect, sliceNear, sliceFar);
+            sliceNear = sliceFar;
+
+            // fit in light space and snap the origin to whole texels to avoid shimmering
+            const bx::Vec3 center = bx::mul(sphere.center, lightView);
+            const float texel = 2.0f * sphere.radius / float(_cascadeSize);
+            const float left = bx::floor((center.x - sphere.radius) / texel) * texel;
+            const float bottom = bx::floor((center.y - sphere.radius) / texel) * texel;
+            const float extent = 2.0f * sphere.radius;
+
+            bx::memCopy(_cascades.m_lightView[ii], lightView, sizeof(lightView));
+            bx::mtxOrtho(_cascades.m_lightProj[ii], left, left + extent, bottom, bottom + extent,
+                         center.z - sphere.radius - kCasterExtent, center.z + sphere.radius, 0.0f,
+                         caps->homogeneousDepth);
+
+            placeTile(_cascades, ii, cols, rows);
+        }
+
+        fillUnusedTiles(_cascades);
+    }
+}
+
+#endif //ESTARHOMEWORK_CASCADED_SHADOW_H
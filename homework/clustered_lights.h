@@ -0,0 +1,283 @@
+//
+// Clustered forward lighting, point lights binned into a view space froxel grid on the CPU.
+//
+
+#include <vector>
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_CLUSTERED_LIGHTS_H
+#define ESTARHOMEWORK_CLUSTERED_LIGHTS_H
+
+namespace RenderCore::Lights {
+    // grid and texture sizes, must match shaders/clustered.sh
+    constexpr uint16_t kClusterX = 16;
+    constexpr uint16_t kClusterY = 9;
+    constexpr uint16_t kClusterZ = 24;
+    constexpr uint32_t kNumClusters = kClusterX * kClusterY * kClusterZ;
+    constexpr uint16_t kMaxLights = 1024;
+    constexpr uint16_t kMaxLightsPerCluster = 128;
+    constexpr uint16_t kIndexWidth = 1024;
+    constexpr uint16_t kIndexHeight = 32;
+    constexpr uint32_t kMaxIndices = kIndexWidth * kIndexHeight;
+
+    // texture stages used by mesh_fs, following the material textures
+    constexpr uint8_t kPointLightsStage = 7;
+    constexpr uint8_t kLightGridStage = 8;
+    constexpr uint8_t kLightIndicesStage = 9;
+
+    constexpr uint64_t kSamplerFlags = 0
+                                       | BGFX_SAMPLER_POINT
+                                       | BGFX_SAMPLER_U_CLAMP
+                                       | BGFX_SAMPLER_V_CLAMP;
+
+    struct PointLight {
+        float m_pos[3];
+        float m_radius;
+        float m_color[3];
+    };
+
+    struct ClusterStats {
+        uint32_t m_numLights;
+        uint32_t m_numVisible;
+        uint32_t m_numIndices;
+        uint32_t m_maxPerCluster;
+        float m_buildMs;
+    };
+
+    // Lights live in a float texture, one column per light. Every frame each light's view space
+    // bounds are projected to the range of clusters they touch, then the per cluster light lists
+    // are packed into an index texture and a grid texture pointing into it, so a fragment only
+    // loops over the lights of its own cluster.
+    class ClusteredLights {
+    public:
+        void init() {
+            m_pointLights = bgfx::createTexture2D(kMaxLights, 2, false, 1, bgfx::TextureFormat::RGBA32F,
+                                                  BGFX_TEXTURE_NONE | kSamplerFlags);
+            m_lightGrid = bgfx::createTexture2D(kClusterX * kClusterY, kClusterZ, false, 1,
+                                                bgfx::TextureFormat::RG32F, BGFX_TEXTURE_NONE | kSamplerFlags);
+            m_lightIndices = bgfx::createTexture2D(kIndexWidth, kIndexHeight, false, 1, bgfx::TextureFormat::R32F,
+                                                   BGFX_TEXTURE_NONE | kSamplerFlags);
+
+            s_pointLights = bgfx::createUniform("s_pointLights", bgfx::UniformType::Sampler);
+            s_lightGrid = bgfx::createUniform("s_lightGrid", bgfx::UniformType::Sampler);
+            s_lightIndices = bgfx::createUniform("s_lightIndices", bgfx::UniformType::Sampler);
+            u_clusterParams = bgfx::createUniform("u_clusterParams", bgfx::UniformType::Vec4);
+
+            m_grid.resize(kNumClusters * 2);
+            m_counts.resize(kNumClusters);
+            m_cursors.resize(kNumClusters);
+            m_indices.resize(kMaxIndices);
+            m_params[0] = 0.0f;
+            m_params[1] = 0.0f;
+            m_params[2] = 0.0f;
+            m_params[3] = 0.0f;
+            m_stats = {};
+        }
+
+        void destroy() {
+            bgfx::destroy(m_pointLights);
+            bgfx::destroy(m_lightGrid);
+            bgfx::destroy(m_lightIndices);
+            bgfx::destroy(s_pointLights);
+            bgfx::destroy(s_lightGrid);
+            bgfx::destroy(s_lightIndices);
+            bgfx::destroy(u_clusterParams);
+        }
+
+        // bins the lights into the clusters of the camera given by its view and projection matrix,
+        // depth slices are distributed logarithmically between _near and _far
+        void update(const PointLight *_lights, uint32_t _numLights, const float *_view, const float *_proj,
+                    float _near, float _far) {
+            const int64_t begin = bx::getHPCounter();
+
+            const uint32_t numLights = bx::min<uint32_t>(_numLights, kMaxLights);
+            const float logRatio = bx::log(_far / _near);
+            const float sliceScale = float(kClusterZ) / logRatio;
+            const float sliceBias = -float(kClusterZ) * bx::log(_near) / logRatio;
+
+            m_ranges.resize(numLights);
+            bx::memSet(m_counts.data(), 0, kNumClusters * sizeof(uint32_t));
+
+            // count the lights of every cluster
+            uint32_t numVisible = 0;
+            for (uint32_t ii = 0; ii < numLights; ++ii) {
+                ClusterRange &range = m_ranges[ii];
+                range.m_visible = clusterRange(range, _lights[ii], _view, _proj, _near, _far, sliceScale, sliceBias);
+                if (!range.m_visible) {
+                    continue;
+                }
+
+                ++numVisible;
+                forEachCluster(range, [&](uint32_t _cluster) {
+                    ++m_counts[_cluster];
+                });
+            }
+
+            // offsets into the index list, clusters past the index budget are truncated
+            uint32_t offset = 0;
+            uint32_t maxPerCluster = 0;
+            for (uint32_t ii = 0; ii < kNumClusters; ++ii) {
+                const uint32_t count = bx::min<uint32_t>(
+                        bx::min<uint32_t>(m_counts[ii], kMaxLightsPerCluster), kMaxIndices - offset);
+                m_grid[ii * 2 + 0] = float(offset);
+                m_grid[ii * 2 + 1] = float(count);
+                m_cursors[ii] = offset;
+                m_counts[ii] = offset + count;
+                maxPerCluster = bx::max(maxPerCluster, count);
+                offset += count;
+            }
+
+            // fill the lists, m_counts now holds the end of each cluster's list
+            for (uint32_t ii = 0; ii < numLights; ++ii) {
+                if (!m_ranges[ii].m_visible) {
+                    continue;
+                }
+
+                forEachCluster(m_ranges[ii], [&](uint32_t _cluster) {
+                    if (m_cursors[_cluster] < m_counts[_cluster]) {
+                        m_indices[m_cursors[_cluster]++] = float(ii);
+                    }
+                });
+            }
+
+            upload(_lights, numLights, offset);
+
+            m_params[0] = float(numLights);
+            m_params[1] = sliceScale;
+            m_params[2] = sliceBias;
+
+            m_stats.m_numLights = numLights;
+            m_stats.m_numVisible = numVisible;
+            m_stats.m_numIndices = offset;
+            m_stats.m_maxPerCluster = maxPerCluster;
+            m_stats.m_buildMs = float(double(bx::getHPCounter() - begin) * 1000.0 / double(bx::getHPFrequency()));
+        }
+
+        // binds the light textures for the next draw
+        void submit() const {
+            bgfx::setTexture(kPointLightsStage, s_pointLights, m_pointLights, kSamplerFlags);
+            bgfx::setTexture(kLightGridStage, s_lightGrid, m_lightGrid, kSamplerFlags);
+            bgfx::setTexture(kLightIndicesStage, s_lightIndices, m_lightIndices, kSamplerFlags);
+        }
+
+        // u_clusterParams is uploaded once per frame by the owner of the frame uniform block
+        bgfx::UniformHandle paramsUniform() const {
+            return u_clusterParams;
+        }
+
+        const float *params() const {
+            return m_params;
+        }
+
+        const ClusterStats &stats() const {
+            return m_stats;
+        }
+
+    private:
+        struct ClusterRange {
+            uint16_t m_min[3];
+            uint16_t m_max[3];
+            bool m_visible;
+        };
+
+        template<typename Fn>
+        static void forEachCluster(const ClusterRange &_range, const Fn &_fn) {
+            for (uint32_t zz = _range.m_min[2]; zz <= _range.m_max[2]; ++zz) {
+                for (uint32_t yy = _range.m_min[1]; yy <= _range.m_max[1]; ++yy) {
+                    const uint32_t row = (zz * kClusterY + yy) * kClusterX;
+                    for (uint32_t xx = _range.m_min[0]; xx <= _range.m_max[0]; ++xx) {
+                        _fn(row + xx);
+                    }
+                }
+            }
+        }
+
+        static uint16_t tile(float _ndc, uint16_t _numTiles) {
+            const float tt = bx::floor((_ndc * 0.5f + 0.5f) * float(_numTiles));
+            return uint16_t(bx::clamp(tt, 0.0f, float(_numTiles - 1)));
+        }
+
+        // projects the view space bounding box of a light, returns false if it misses the frustum
+        static bool clusterRange(ClusterRange &_range, const PointLight &_light, const float *_view,
+                                 const float *_proj, float _near, float _far, float _sliceScale, float _sliceBias) {
+            const bx::Vec3 center = bx::mul(bx::Vec3(_light.m_pos[0], _light.m_pos[1], _light.m_pos[2]), _view);
+            const float radius = _light.m_radius;
+
+            const float zMin = bx::max(center.z - radius, _near);
+            const float zMax = bx::min(center.z + radius, _far);
+            if (zMin > zMax) {
+                return false;
+            }
+
+            // extremes of x / z over the box, the near or far side depending on the sign of x
+            const float xMin = center.x - radius;
+            const float xMax = center.x + radius;
+            const float yMin = center.y - radius;
+            const float yMax = center.y + radius;
+            const float ndcMinX = _proj[0] * xMin / (xMin >= 0.0f ? zMax : zMin);
+            const float ndcMaxX = _proj[0] * xMax / (xMax >= 0.0f ? zMin : zMax);
+            const float ndcMinY = _proj[5] * yMin / (yMin >= 0.0f ? zMax : zMin);
+            const float ndcMaxY = _proj[5] * yMax / (yMax >= 0.0f ? zMin : zMax);
+            if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) {
+                return false;
+            }
+
+            _range.m_min[0] = tile(ndcMinX, kClusterX);
+            _range.m_max[0] = tile(ndcMaxX, kClusterX);
+            _range.m_min[1] = tile(ndcMinY, kClusterY);
+            _range.m_max[1] = tile(ndcMaxY, kClusterY);
+            _range.m_min[2] = uint16_t(bx::clamp(bx::floor(bx::log(zMin) * _sliceScale + _sliceBias),
+                                                 0.0f, float(kClusterZ - 1)));
+            _range.m_max[2] = uint16_t(bx::clamp(bx::floor(bx::log(zMax) * _sliceScale + _sliceBias),
+                                                 0.0f, float(kClusterZ - 1)));
+            return true;
+        }
+
+        // only the used part of the light and index textures is updated
+        void upload(const PointLight *_lights, uint32_t _numLights, uint32_t _numIndices) {
+            if (0 < _numLights) {
+                const bgfx::Memory *posRadius = bgfx::alloc(_numLights * 4 * sizeof(float));
+                const bgfx::Memory *color = bgfx::alloc(_numLights * 4 * sizeof(float));
+                float *posRadiusData = reinterpret_cast<float *>(posRadius->data);
+                float *colorData = reinterpret_cast<float *>(color->data);
+                for (uint32_t ii = 0; ii < _numLights; ++ii) {
+                    const PointLight &light = _lights[ii];
+                    bx::memCopy(&posRadiusData[ii * 4], light.m_pos, 3 * sizeof(float));
+                    posRadiusData[ii * 4 + 3] = light.m_radius;
+                    bx::memCopy(&colorData[ii * 4], light.m_color, 3 * sizeof(float));
+                    colorData[ii * 4 + 3] = 1.0f;
+                }
+                bgfx::updateTexture2D(m_pointLights, 0, 0, 0, 0, uint16_t(_numLights), 1, posRadius);
+                bgfx::updateTexture2D(m_pointLights, 0, 0, 0, 1, uint16_t(_numLights), 1, color);
+            }
+
+            bgfx::updateTexture2D(m_lightGrid, 0, 0, 0, 0, kClusterX * kClusterY, kClusterZ,
+                                  bgfx::copy(m_grid.data(), uint32_t(m_grid.size() * sizeof(float))));
+
+            if (0 < _numIndices) {
+                const uint16_t numRows = uint16_t((_numIndices + kIndexWidth - 1) / kIndexWidth);
+                bgfx::updateTexture2D(m_lightIndices, 0, 0, 0, 0, kIndexWidth, numRows,
+                                      bgfx::copy(m_indices.data(), numRows * kIndexWidth * sizeof(float)));
+            }
+        }
+
+        bgfx::TextureHandle m_pointLights;
+        bgfx::TextureHandle m_lightGrid;
+        bgfx::TextureHandle m_lightIndices;
+        bgfx::UniformHandle s_pointLights;
+        bgfx::UniformHandle s_lightGrid;
+        bgfx::UniformHandle s_lightIndices;
+        bgfx::UniformHandle u_clusterParams;
+        float m_params[4];
+
+        std::vector<ClusterRange> m_ranges;
+        std::vector<float> m_grid;
+        std::vector<uint32_t> m_counts;
+        std::vector<uint32_t> m_cursors;
+        std::vector<float> m_indices;
+        ClusterStats m_stats;
+    };
+}
+
+#endif //ESTARHOMEWORK_CLUSTERED_LIGHTS_H
@@ -8,29 +8,65 @@
  * */
 
 #include <iostream>
+#include <bx/commandline.h>
+#include <bx/rng.h>
 #include "common.h"
 #include "bgfx_utils.h"
 #include "camera.h"
 #include "imgui/imgui.h"
 #include "FileBrowser/ImGuiFileBrowser.h"
 #include "mesh_producer.h"
+#include "cascaded_shadow.h"
+#include "omni_shadow.h"
+#include "program_cache.h"
+#include "render_list.h"
+#include "resource_cache.h"
+#include "clustered_lights.h"
+#include "ibl.h"
+#include "tone_mapping.h"
 
 namespace RenderCore {
 
-    constexpr int SHADOW_PASS_ID = 0;
-    constexpr int SCENE_PASS_ID = 1;
-    constexpr int SKYBOX_PASS_ID = 2;
+    // one shadow view per cascade, all rendering into the same atlas
+    constexpr int STATIC_SHADOW_PASS_ID = 0;
+    constexpr int SHADOW_PASS_ID = STATIC_SHADOW_PASS_ID + Shadow::kMaxViews;
+    constexpr int DEPTH_PASS_ID = SHADOW_PASS_ID + Shadow::kMaxViews;
+    constexpr int SCENE_PASS_ID = DEPTH_PASS_ID + 1;
+    constexpr int SKYBOX_PASS_ID = SCENE_PASS_ID + 1;
+    constexpr int HISTOGRAM_PASS_ID = SKYBOX_PASS_ID + 1;
+    constexpr int EXPOSURE_PASS_ID = HISTOGRAM_PASS_ID + 1;
+    constexpr int TONEMAP_PASS_ID = EXPOSURE_PASS_ID + 1;
 
+    // raw depth reads of the shadow atlas, bypassing the texture's compare sampler
+    constexpr uint32_t kShadowDepthSamplerFlags = 0
+                                                  | BGFX_SAMPLER_POINT
+                                                  | BGFX_SAMPLER_U_CLAMP
+                                                  | BGFX_SAMPLER_V_CLAMP;
+
+    constexpr float CAMERA_NEAR = 0.1f;
+    constexpr float CAMERA_FAR = 100.0f;
+
+    // per frame bgfx capacity, the scene submits a few dozen draws, --max-draw-calls <num> raises it
+    constexpr uint32_t kDefaultMaxDrawCalls = 4 << 10;
+
+    // per frame matrix cache, every render list item keeps one transform in it so the default leaves room
+    // for tens of thousands of objects, --max-matrix-cache <num> raises it
+    constexpr uint32_t kDefaultMaxMatrixCache = 64 << 10;
+
+    // stage of the per frame camera and light uniform block, see u_frame in uniforms.sh
+    constexpr uint8_t kFrameUniformStage = 11;
+
+    // per material uniforms, the camera and light are in the per frame uniform block
     struct Uniforms {
         enum {
-            NumVec4 = 7
+            NumVec4 = 2
         };
 
         void init() {
             u_params = bgfx::createUniform("u_params", bgfx::UniformType::Vec4, NumVec4);
         }
 
-        void submit() {
+        void submit() const {
             bgfx::setUniform(u_params, m_params, NumVec4);
         }
 
@@ -41,26 +77,11 @@ namespace RenderCore {
         union {
             struct {
                 struct {
-                    float u_lightPos[4];
-                };
-                struct {
-                    float u_lightColor[4];
-                };
-                struct {
-                    float u_viewPos[4];
-                };
-                struct {
-                    float u_roughness, u_metallic, u_exposure, u_usePBRMaps;
+                    float u_roughness, u_metallic, u_unused[2];
                 };
                 struct {
                     float u_diffuseColor[4];
                 };
-                struct {
-                    float u_isFloor, u_pcfFilterSize, u_useBlinnPhong, u_usePBR;
-                };
-                struct {
-                    float u_useDiffuseIBL, u_useSpecularIBL, u_useShadowMap, temp1;
-                };
             };
 
             float m_params[NumVec4 * 4];
@@ -88,7 +109,11 @@ namespace RenderCore {
 
             m_roughness = 0.5f;
             m_metallic = 0.1f;
-            m_exposure = 2.2f;
+            m_exposure.m_autoExposure = true;
+            m_exposure.m_compensation = 0.0f;
+            m_exposure.m_minLogLum = -8.0f;
+            m_exposure.m_maxLogLum = 4.0f;
+            m_exposure.m_adaptationRate = 1.5f;
             m_usePbrMaps = false;
 
             m_diffuseColor[0] = 1.0f;
@@ -96,7 +121,6 @@ namespace RenderCore {
             m_diffuseColor[2] = 1.0f;
             m_diffuseColor[3] = 1.0f;
 
-            m_isFloor = false;
             m_pcfFilterSize = 5.0;
             m_useBlinnPhong = false;
             m_usePBR = true;
@@ -110,6 +134,29 @@ namespace RenderCore {
             m_meshPos[2] = 0.0f;
             m_meshPos[3] = 1.0f;
 
+            // the point light faces take the atlas tiles of the cascades, so the sun casts no shadow
+            m_pointLightShadow = false;
+            m_numCascades = 3;
+            m_cascadeSizeIdx = 1;
+            m_cascadeSplitLambda = 0.75f;
+
+            m_usePCSS = false;
+            m_pcssLightSize = 400.0f;
+            m_cacheStaticShadows = true;
+
+            m_cpuBudgetMB = 256;
+            m_gpuBudgetMB = 512;
+
+            m_depthPrePass = true;
+
+            m_lodPixelError = 1.0f;
+            m_shadowLodBias = 4.0f;
+
+            m_numPointLights = 0;
+            m_pointLightRadius = 6.0f;
+            m_pointLightIntensity = 20.0f;
+            m_animatePointLights = true;
+
             // not passed to uniform
             m_visPbrStone = true;
             m_visSkyBox = true;
@@ -120,10 +167,9 @@ namespace RenderCore {
         float m_lightColor[4];
         float m_roughness;
         float m_metallic;
-        float m_exposure;
+        Post::ExposureSettings m_exposure;
         bool m_visPbrStone;
         float m_diffuseColor[4];
-        bool m_isFloor;
         bool m_usePbrMaps;
         float m_pcfFilterSize;
         bool m_useBlinnPhong;
@@ -135,6 +181,72 @@ namespace RenderCore {
         bool m_useShadowMap;
         bool m_visSkyBox;
         float m_meshPos[4];
+
+        // the point light casts from all six cube faces, otherwise cascades looking at the origin
+        bool m_pointLightShadow;
+
+        // cascaded shadow map, the size is also used for the point light faces
+        int m_numCascades;
+        int m_cascadeSizeIdx;
+        float m_cascadeSplitLambda;
+        bool m_usePCSS;
+        float m_pcssLightSize;
+
+        // static casters are drawn into a cached atlas only when they or the cascades change
+        bool m_cacheStaticShadows;
+
+        // lay down depth first so the scene pass shades each pixel once
+        bool m_depthPrePass;
+
+        // screen space error in pixels a mesh level of detail may have, shadow tiles allow bias times more
+        float m_lodPixelError;
+        float m_shadowLodBias;
+
+        // resource cache budgets in megabytes
+        int m_cpuBudgetMB;
+        int m_gpuBudgetMB;
+
+        // clustered point lights stress scene
+        int m_numPointLights;
+        float m_pointLightRadius;
+        float m_pointLightIntensity;
+        bool m_animatePointLights;
+    };
+
+    static const char *s_cascadeSizeNames[] = {"512", "1024", "2048"};
+    static const uint16_t s_cascadeSizes[] = {512, 1024, 2048};
+    BX_STATIC_ASSERT(BX_COUNTOF(s_cascadeSizes) == BX_COUNTOF(s_cascadeSizeNames));
+
+    namespace MaterialId {
+        enum Enum : uint16_t {
+            Default,
+            Floor,
+            PbrStone,
+            Light,
+
+            Count
+        };
+    }
+
+    // resolved once per frame, everything a scene pass draw binds besides its geometry
+    struct Material {
+        bgfx::ProgramHandle m_program;
+        // invalid when the material has no instanced vertex shader, its batches are then drawn per item
+        bgfx::ProgramHandle m_instancedProgram;
+        uint64_t m_state;
+        // invalid when the material is left out of the depth pre-pass
+        bgfx::ProgramHandle m_depthProgram;
+        bgfx::ProgramHandle m_depthInstancedProgram;
+        uint64_t m_depthState;
+        Uniforms m_uniforms;
+        uint8_t m_numTextures;
+        MeshState::Texture m_textures[7];
+    };
+
+    // the resource in use and the one replacing it once its load finished
+    struct ResourceSlot {
+        ResourceHandle m_current;
+        ResourceHandle m_pending;
     };
 
     class EStarHomework : public entry::AppI {
@@ -153,13 +265,21 @@ namespace RenderCore {
             m_timeOffset = bx::getHPCounter();
 
             bgfx::Init init;
-            // init.type = args.m_type;
-            // init.type = bgfx::RendererType::OpenGL;
-            init.type = bgfx::RendererType::Direct3D11;
+            // Direct3D11 unless a renderer is picked on the command line, e.g. --gl or --noop
+            init.type = bgfx::RendererType::Count != args.m_type ? args.m_type : bgfx::RendererType::Direct3D11;
             init.vendorId = args.m_pciId;
             init.resolution.width = m_width;
             init.resolution.height = m_height;
             init.resolution.reset = m_reset;
+            init.limits.maxDrawCalls = kDefaultMaxDrawCalls;
+            bx::CommandLine(_argc, _argv).hasArg(init.limits.maxDrawCalls, '\0', "max-draw-calls");
+            init.limits.maxMatrixCache = bx::max(kDefaultMaxMatrixCache, init.limits.maxDrawCalls + 1);
+            bx::CommandLine(_argc, _argv).hasArg(init.limits.maxMatrixCache, '\0', "max-matrix-cache");
+            // --frames-in-flight 3 lets the API thread run two frames ahead of the render thread
+            uint32_t framesInFlight = init.limits.maxFramesInFlight;
+            if (bx::CommandLine(_argc, _argv).hasArg(framesInFlight, '\0', "frames-in-flight")) {
+                init.limits.maxFramesInFlight = uint8_t(framesInFlight);
+            }
             bgfx::init(init);
 
             // Enable debug text
@@ -171,9 +291,17 @@ namespace RenderCore {
             u_time = bgfx::createUniform("u_time", bgfx::UniformType::Vec4);
 
             // init shadow map
-            m_shadowMapSize = 512;
+            m_shadowMapSize = 0;
+            m_numCascades = 0;
             s_shadowMap = bgfx::createUniform("s_shadowMap", bgfx::UniformType::Sampler);
-            u_lightMtx = bgfx::createUniform("u_lightMtx", bgfx::UniformType::Mat4);
+            u_lightMtx = bgfx::createUniform("u_lightMtx", bgfx::UniformType::Mat4, Shadow::kMaxViews);
+            u_shadowTiles = bgfx::createUniform("u_shadowTiles", bgfx::UniformType::Vec4, Shadow::kMaxViews);
+            u_cascadeSplits = bgfx::createUniform("u_cascadeSplits", bgfx::UniformType::Vec4);
+            u_shadowParams = bgfx::createUniform("u_shadowParams", bgfx::UniformType::Vec4);
+            s_shadowDepth = bgfx::createUniform("s_shadowDepth", bgfx::UniformType::Sampler);
+            u_poissonDisk = bgfx::createUniform("u_poissonDisk", bgfx::UniformType::Vec4,
+                                                Shadow::kNumPoissonSamples / 2);
+            Shadow::poissonDisk(m_poissonDisk, Shadow::kNumPoissonSamples, Shadow::kNumPoissonRings);
 
             // When using GL clip space depth range [-1, 1] and packing depth into color buffer, we need to
             // adjust the depth range to be [0, 1] for writing to the color buffer
@@ -194,31 +322,61 @@ namespace RenderCore {
             // init a plane
             Triangle::init_plane(m_planeVbh, m_planeIbh);
 
-            // init shadow map program
-            m_shadowProgram = loadProgram("shadow_vs", "shadow_fs");
+            // init shadow map program, prefer hardware depth compare and fall back to
+            // packing depth into a color target when comparison samplers are unavailable
+            m_shadowSamplerSupported = 0 != (caps->supported & BGFX_CAPS_TEXTURE_COMPARE_LEQUAL);
+            const char *shadowFsName = m_shadowSamplerSupported ? "shadow_fs" : "shadow_fs_pd";
+            m_shadowProgram = loadProgram("shadow_vs", shadowFsName);
+            m_shadowInstancedProgram = loadProgram("shadow_vs_instanced", shadowFsName);
+            m_shadowMap = BGFX_INVALID_HANDLE;
             m_shadowMapFB = BGFX_INVALID_HANDLE;
 
+            // the static shadow cache is copied into the working atlas with a blit every frame
+            m_shadowCacheSupported = 0 != (caps->supported & BGFX_CAPS_TEXTURE_BLIT);
+            m_staticShadowMapFB = BGFX_INVALID_HANDLE;
+            m_staticShadowValid = false;
+            m_numStaticShadowUpdates = 0;
+            m_shadowTilesUsed = UINT8_MAX;
+            m_staticShadowTilesUsed = UINT8_MAX;
+            m_numShadowTilesDrawn = 0;
+
+            // depth pre-pass program, positions match mesh_vs exactly for the equal depth test
+            m_depthProgram = loadProgram("depth_vs", "depth_fs");
+            m_depthInstancedProgram = loadProgram("depth_vs_instanced", "depth_fs");
+
             // init a cube light
             Triangle::init_cube(m_lightVbh, m_lightIbh);
             m_lightProgram = loadProgram("light_vs", "light_fs");
-            // u_lightPos = bgfx::createUniform("u_lightPos", bgfx::UniformType::Vec4);
 
             // create mesh program from shaders
             m_pbrStone = meshLoad("../resource/pbr_stone/pbr_stone_mesh.bin");
 
+            // the mesh and the stone textures are loaded in the background through the resource cache,
+            // the scene draws without the mesh and with a white texture until they are resident
+            asyncLoadInit();
+            m_resources.init(uint64_t(m_settings.m_cpuBudgetMB) << 20, uint64_t(m_settings.m_gpuBudgetMB) << 20);
+
+            const uint32_t white = UINT32_MAX;
+            m_texPlaceholder = bgfx::createTexture2D(1, 1, false, 1, bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_NONE,
+                                                     bgfx::copy(&white, sizeof(white)));
+
             m_meshName = "../resource/basic_meshes/bunny.bin";
-            m_mesh = meshLoad(m_meshName.c_str());
-            if (!m_mesh) {
-                std::cout << "mesh not load!" << std::endl;
-                shutdown();
-            }
-            m_meshProgram = loadProgram("mesh_vs", "mesh_fs");
+            m_mesh = NULL;
+            m_meshSlot = {kInvalidResource, m_resources.loadMesh(m_meshName.c_str())};
+            m_meshPrograms.init("mesh_vs", "mesh_fs");
+            m_instancedMeshPrograms.init("mesh_vs_instanced", "mesh_fs");
             // load texture and create texture sampler uniform
-            m_texDiffuse = loadTexture(R"(../resource/pbr_stone/pbr_stone_base_color.dds)");
+            m_texDiffuse = m_texPlaceholder;
+            m_texDiffuseSlot = {kInvalidResource,
+                                m_resources.loadTexture(R"(../resource/pbr_stone/pbr_stone_base_color.dds)")};
             s_texDiffuse = bgfx::createUniform("s_texDiffuse", bgfx::UniformType::Sampler);
-            m_texNormal = loadTexture(R"(../resource/pbr_stone/pbr_stone_normal.dds)");
+            m_texNormal = m_texPlaceholder;
+            m_texNormalSlot = {kInvalidResource,
+                               m_resources.loadTexture(R"(../resource/pbr_stone/pbr_stone_normal.dds)")};
             s_texNormal = bgfx::createUniform("s_texNormal", bgfx::UniformType::Sampler);
-            m_texAORM = loadTexture(R"(../resource/pbr_stone/pbr_stone_aorm.dds)");
+            m_texAORM = m_texPlaceholder;
+            m_texAORMSlot = {kInvalidResource,
+                             m_resources.loadTexture(R"(../resource/pbr_stone/pbr_stone_aorm.dds)")};
             s_texAORM = bgfx::createUniform("s_texAORM", bgfx::UniformType::Sampler);
 
             cameraCreate();
@@ -226,46 +384,51 @@ namespace RenderCore {
 
             m_skyBoxMesh = meshLoad(R"(../resource/basic_meshes/cube.bin)");
             m_skyBoxProgram = loadProgram("sky_vs", "sky_fs");
-            m_texCube = loadTexture(R"(../resource/env_maps/kyoto_lod.dds)");
+            // prefiltered offline, see Ibl::loadRadiance, specular IBL stays off without it
+            m_texCube = Ibl::loadRadiance(R"(../resource/env_maps/kyoto_lod.dds)", &m_texCubeInfo);
+            if (!bgfx::isValid(m_texCube)) {
+                bx::memSet(&m_texCubeInfo, 0, sizeof(m_texCubeInfo));
+                DBG("No prefiltered radiance cubemap, specular IBL is disabled.");
+            }
             s_texCube = bgfx::createUniform("s_texCube", bgfx::UniformType::Sampler);
-            m_texCubeIrr = loadTexture(R"(../resource/env_maps/kyoto_irr.dds)");
-            s_texCubeIrr = bgfx::createUniform("s_texCubeIrr", bgfx::UniformType::Sampler);
+            if (!Ibl::loadIrradianceSh(R"(../resource/env_maps/kyoto_irr.dds)", m_irradianceSh)) {
+                bx::memSet(m_irradianceSh, 0, sizeof(m_irradianceSh));
+            }
+            u_irradianceSh = bgfx::createUniform("u_irradianceSh", bgfx::UniformType::Vec4, Ibl::kNumShCoeffs);
+            m_brdfLut = Ibl::loadBrdfLut(R"(../resource/env_maps/brdf_lut.dds)");
+            s_brdfLut = bgfx::createUniform("s_brdfLut", bgfx::UniformType::Sampler);
 
             // some other meshes
             m_hollowCube = meshLoad(R"(../resource/basic_meshes/hollowcube.bin)");
-            // load m_state
-            m_state[0] = meshStateCreate();
-            m_state[0]->m_state = 0;
-            m_state[0]->m_program = m_shadowProgram;
-            m_state[0]->m_viewId = SHADOW_PASS_ID;
-            m_state[0]->m_numTextures = 0;
-
-            m_state[1] = meshStateCreate();
-            m_state[1]->m_state = 0
-                                  | BGFX_STATE_WRITE_RGB
-                                  | BGFX_STATE_WRITE_A
-                                  | BGFX_STATE_WRITE_Z
-                                  | BGFX_STATE_DEPTH_TEST_LESS
-                                  | BGFX_STATE_CULL_CCW
-                                  | BGFX_STATE_MSAA;
-            m_state[1]->m_program = m_meshProgram;
-            m_state[1]->m_viewId = SCENE_PASS_ID;
-            m_state[1]->m_numTextures = 3;
-            m_state[1]->m_textures[0].m_flags = 0;
-            m_state[1]->m_textures[0].m_stage = 0;
-            m_state[1]->m_textures[0].m_sampler = s_texCube;
-            m_state[1]->m_textures[0].m_texture = m_texCube;
-            m_state[1]->m_textures[1].m_flags = 0;
-            m_state[1]->m_textures[1].m_stage = 1;
-            m_state[1]->m_textures[1].m_sampler = s_texCubeIrr;
-            m_state[1]->m_textures[1].m_texture = m_texCubeIrr;
-            m_state[1]->m_textures[2].m_flags = UINT32_MAX;
-            m_state[1]->m_textures[2].m_stage = 2;
-            m_state[1]->m_textures[2].m_sampler = s_shadowMap;
-            m_state[1]->m_textures[2].m_texture = m_shadowMap;
+            // load the scene into the render list
+            buildRenderList();
 
             // load settings and uniforms
             m_uniforms.init();
+            m_toneMapping.init();
+
+            // --point-lights <count> starts with the stress scene enabled, e.g. for headless benchmarks
+            m_clusteredLights.init();
+
+            // everything the scene draws share is written once per frame into a block bound to every scene
+            // draw, the members are in the order of u_frame in uniforms.sh
+            u_lightPos = bgfx::createUniform("u_lightPos", bgfx::UniformType::Vec4);
+            u_lightColor = bgfx::createUniform("u_lightColor", bgfx::UniformType::Vec4);
+            u_viewPos = bgfx::createUniform("u_viewPos", bgfx::UniformType::Vec4);
+            u_frameParams = bgfx::createUniform("u_frameParams", bgfx::UniformType::Vec4);
+            const bgfx::UniformHandle frameUniforms[] = {
+                    u_lightPos, u_lightColor, u_viewPos, u_frameParams,
+                    m_clusteredLights.paramsUniform(), u_irradianceSh,
+                    u_lightMtx, u_shadowTiles, u_cascadeSplits, u_shadowParams, u_poissonDisk,
+            };
+            u_frame = bgfx::createUniformBlock(frameUniforms, BX_COUNTOF(frameUniforms));
+            // the irradiance and the poisson disk never change, the block keeps them
+            bgfx::updateUniformBlock(u_frame, u_irradianceSh, m_irradianceSh, Ibl::kNumShCoeffs);
+            bgfx::updateUniformBlock(u_frame, u_poissonDisk, m_poissonDisk, Shadow::kNumPoissonSamples / 2);
+            initPointLights();
+            bx::CommandLine cmdLine(_argc, _argv);
+            cmdLine.hasArg(m_settings.m_numPointLights, '\0', "point-lights");
+            m_settings.m_numPointLights = bx::clamp<int32_t>(m_settings.m_numPointLights, 0, Lights::kMaxLights);
 
             imguiCreate();
         }
@@ -273,39 +436,62 @@ namespace RenderCore {
         virtual int shutdown() override {
             imguiDestroy();
 
+            releaseSlot(m_meshSlot);
+            releaseSlot(m_texDiffuseSlot);
+            releaseSlot(m_texNormalSlot);
+            releaseSlot(m_texAORMSlot);
+            m_resources.shutdown();
+            asyncLoadShutdown();
+            bgfx::destroy(m_texPlaceholder);
+
             bgfx::destroy(m_lightVbh);
             bgfx::destroy(m_lightIbh);
             bgfx::destroy(m_lightProgram);
 
-            meshUnload(m_mesh);
-            bgfx::destroy(m_meshProgram);
-            bgfx::destroy(m_texDiffuse);
+            m_meshPrograms.destroy();
+            m_instancedMeshPrograms.destroy();
             bgfx::destroy(s_texDiffuse);
-            bgfx::destroy(m_texNormal);
             bgfx::destroy(s_texNormal);
-            bgfx::destroy(m_texAORM);
             bgfx::destroy(s_texAORM);
             bgfx::destroy(u_time);
 
             meshUnload(m_skyBoxMesh);
             bgfx::destroy(m_skyBoxProgram);
-            bgfx::destroy(m_texCube);
-            bgfx::destroy(m_texCubeIrr);
+            if (bgfx::isValid(m_texCube)) {
+                bgfx::destroy(m_texCube);
+            }
             bgfx::destroy(s_texCube);
-            bgfx::destroy(s_texCubeIrr);
+            bgfx::destroy(u_irradianceSh);
+            bgfx::destroy(m_brdfLut);
+            bgfx::destroy(s_brdfLut);
 
             m_uniforms.destroy();
+            m_clusteredLights.destroy();
+            m_toneMapping.destroy();
             meshUnload(m_hollowCube);
-            meshStateDestroy(m_state[0]);
-            meshStateDestroy(m_state[1]);
             bgfx::destroy(m_planeVbh);
             bgfx::destroy(m_planeIbh);
-            bgfx::destroy(m_shadowMap);
+            bgfx::destroy(u_frame);
+            bgfx::destroy(u_lightPos);
+            bgfx::destroy(u_lightColor);
+            bgfx::destroy(u_viewPos);
+            bgfx::destroy(u_frameParams);
             bgfx::destroy(s_shadowMap);
             bgfx::destroy(u_lightMtx);
+            bgfx::destroy(u_shadowTiles);
+            bgfx::destroy(u_cascadeSplits);
+            bgfx::destroy(u_shadowParams);
+            bgfx::destroy(s_shadowDepth);
+            bgfx::destroy(u_poissonDisk);
             bgfx::destroy(u_depthScaleOffset);
             bgfx::destroy(m_shadowProgram);
+            bgfx::destroy(m_shadowInstancedProgram);
+            bgfx::destroy(m_depthProgram);
+            bgfx::destroy(m_depthInstancedProgram);
             bgfx::destroy(m_shadowMapFB);
+            if (bgfx::isValid(m_staticShadowMapFB)) {
+                bgfx::destroy(m_staticShadowMapFB);
+            }
 
             cameraDestroy();
 
@@ -336,11 +522,33 @@ namespace RenderCore {
 
                 ImGui::SliderFloat3("Light Pos", m_settings.m_lightPos, -50, 50);
                 ImGui::SliderFloat3("Light Color", m_settings.m_lightColor, 0, 1000);
-                ImGui::SliderFloat("Exposure", &m_settings.m_exposure, 1, 10);
+                if (ImGui::TreeNode("Exposure")) {
+                    ImGui::Checkbox("Auto Exposure", &m_settings.m_exposure.m_autoExposure);
+                    ImGui::SliderFloat("Compensation", &m_settings.m_exposure.m_compensation, -5, 5, "%.1f EV");
+                    ImGui::DragFloatRange2("Log2 Luminance", &m_settings.m_exposure.m_minLogLum,
+                                           &m_settings.m_exposure.m_maxLogLum, 0.1f, -16, 16);
+                    ImGui::SliderFloat("Adaptation Rate", &m_settings.m_exposure.m_adaptationRate, 0.1f, 10);
+                    ImGui::TreePop();
+                }
                 ImGui::Separator();
                 ImGui::Text("Shadow Map:");
                 ImGui::Checkbox("Use Shadow Map", &m_settings.m_useShadowMap);
                 ImGui::SliderFloat("PCF Filter Size", &m_settings.m_pcfFilterSize, 1, 20);
+                ImGui::Checkbox("Point Light Shadow", &m_settings.m_pointLightShadow);
+                ImGui::Text("Shadow tiles drawn: %u / %u", m_numShadowTilesDrawn, m_numCascades);
+                ImGui::SliderInt("Cascades", &m_settings.m_numCascades, 1, Shadow::kMaxCascades);
+                ImGui::Combo("Cascade Size", &m_settings.m_cascadeSizeIdx, s_cascadeSizeNames,
+                             BX_COUNTOF(s_cascadeSizeNames));
+                ImGui::SliderFloat("Split Lambda", &m_settings.m_cascadeSplitLambda, 0.0f, 1.0f);
+                ImGui::Checkbox("PCSS", &m_settings.m_usePCSS);
+                ImGui::SliderFloat("PCSS Light Size", &m_settings.m_pcssLightSize, 10.0f, 1000.0f);
+                if (ImGui::SliderFloat("Shadow LOD Bias", &m_settings.m_shadowLodBias, 1.0f, 16.0f)) {
+                    m_staticShadowValid = false;
+                }
+                if (m_shadowCacheSupported) {
+                    ImGui::Checkbox("Cache Static Shadows", &m_settings.m_cacheStaticShadows);
+                    ImGui::Text("Static tiles redrawn: %u", m_numStaticShadowUpdates);
+                }
 
                 /* ImGui File Dialog from https://github.com/gallickgunner/ImGui-Addons
                  * Under MIT license
@@ -351,6 +559,10 @@ namespace RenderCore {
                 ImGui::SameLine();
                 ImGui::Checkbox("Specular IBL", &m_settings.m_useSpecularIBL);
                 ImGui::Checkbox("Vis Skybox", &m_settings.m_visSkyBox);
+                ImGui::Checkbox("Depth Pre-Pass", &m_settings.m_depthPrePass);
+                if (ImGui::SliderFloat("LOD Pixel Error", &m_settings.m_lodPixelError, 0.0f, 8.0f)) {
+                    m_staticShadowValid = false;
+                }
                 ImGui::Text("If not use IBL, use hardcoded ambient");
                 if (ImGui::Checkbox("Blinn Phong", &m_settings.m_useBlinnPhong)) {
                     m_settings.m_usePBR = false;
@@ -374,9 +586,11 @@ namespace RenderCore {
                                                    ImVec2(700, 310), ".bin")) {
                         std::cout << file_dialog.selected_path
                                   << std::endl;    // The absolute path to the selected file
+                        // the current mesh stays in the scene until the new one is uploaded
+                        requestSlot(m_meshSlot, m_resources.loadMesh(file_dialog.selected_path.c_str()));
                         m_meshName = file_dialog.selected_path;
-                        m_mesh = meshLoad(m_meshName.c_str());
                     }
+                    showSlotStatus(m_meshSlot);
 
                     ImGui::ColorEdit3("Diffuse Color", m_settings.m_diffuseColor);
                     ImGui::SliderFloat3("Mesh Pos", m_settings.m_meshPos, -50.0, 50.0);
@@ -391,20 +605,50 @@ namespace RenderCore {
                         ImGui::OpenPopup("Load Diffuse");
                     if (file_dialog.showFileDialog("Load Diffuse", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN,
                                                    ImVec2(700, 310), ".dds")) {
-                        m_texDiffuse = loadTexture(file_dialog.selected_path.c_str());
+                        requestSlot(m_texDiffuseSlot, m_resources.loadTexture(file_dialog.selected_path.c_str()));
                     }
+                    showSlotStatus(m_texDiffuseSlot);
                     if (ImGui::Button("Load Normal"))
                         ImGui::OpenPopup("Load Normal");
                     if (file_dialog.showFileDialog("Load Normal", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN,
                                                    ImVec2(700, 310), ".dds")) {
-                        m_texNormal = loadTexture(file_dialog.selected_path.c_str());
+                        requestSlot(m_texNormalSlot, m_resources.loadTexture(file_dialog.selected_path.c_str()));
                     }
+                    showSlotStatus(m_texNormalSlot);
                     if (ImGui::Button("Load AORM"))
                         ImGui::OpenPopup("Load AORM");
                     if (file_dialog.showFileDialog("Load AORM", imgui_addons::ImGuiFileBrowser::DialogMode::OPEN,
                                                    ImVec2(700, 310), ".dds")) {
-                        m_texAORM = loadTexture(file_dialog.selected_path.c_str());
+                        requestSlot(m_texAORMSlot, m_resources.loadTexture(file_dialog.selected_path.c_str()));
                     }
+                    showSlotStatus(m_texAORMSlot);
+                    ImGui::TreePop();
+                }
+
+                if (ImGui::TreeNode("Point Lights")) {
+                    ImGui::SliderInt("Count", &m_settings.m_numPointLights, 0, Lights::kMaxLights);
+                    ImGui::SliderFloat("Radius", &m_settings.m_pointLightRadius, 1.0f, 20.0f);
+                    ImGui::SliderFloat("Intensity", &m_settings.m_pointLightIntensity, 0.0f, 100.0f);
+                    ImGui::Checkbox("Animate", &m_settings.m_animatePointLights);
+
+                    const Lights::ClusterStats &stats = m_clusteredLights.stats();
+                    ImGui::Text("Visible: %u / %u", stats.m_numVisible, stats.m_numLights);
+                    ImGui::Text("Indices: %u, max per cluster: %u", stats.m_numIndices, stats.m_maxPerCluster);
+                    ImGui::Text("Cluster build: %.3f ms", stats.m_buildMs);
+                    ImGui::TreePop();
+                }
+
+                if (ImGui::TreeNode("Resources")) {
+                    ImGui::SliderInt("CPU Budget (MB)", &m_settings.m_cpuBudgetMB, 0, 1024);
+                    ImGui::SliderInt("GPU Budget (MB)", &m_settings.m_gpuBudgetMB, 0, 2048);
+
+                    const ResourceResidency residency = m_resources.residency();
+                    ImGui::Text("Resident: %u, referenced: %u", residency.m_numResident, residency.m_numReferenced);
+                    ImGui::Text("Pending: %u, evicted: %u", residency.m_numPending, residency.m_numEvicted);
+                    ImGui::Text("CPU: %.1f / %.1f MB", double(residency.m_cpuBytes) / (1 << 20),
+                                double(residency.m_cpuBudget) / (1 << 20));
+                    ImGui::Text("GPU: %.1f / %.1f MB", double(residency.m_gpuBytes) / (1 << 20),
+                                double(residency.m_gpuBudget) / (1 << 20));
                     ImGui::TreePop();
                 }
 
@@ -412,6 +656,22 @@ namespace RenderCore {
 
                 imguiEndFrame();
 
+                // swap in assets whose background load finished, the previous ones act as placeholders
+                asyncLoadUpdate();
+                m_resources.setBudget(uint64_t(m_settings.m_cpuBudgetMB) << 20,
+                                      uint64_t(m_settings.m_gpuBudgetMB) << 20);
+                m_resources.update();
+                if (updateSlot(m_meshSlot)) {
+                    m_mesh = m_resources.mesh(m_meshSlot.m_current, NULL);
+                    buildRenderList();
+                }
+                updateSlot(m_texDiffuseSlot);
+                updateSlot(m_texNormalSlot);
+                updateSlot(m_texAORMSlot);
+                m_texDiffuse = m_resources.texture(m_texDiffuseSlot.m_current, m_texPlaceholder);
+                m_texNormal = m_resources.texture(m_texNormalSlot.m_current, m_texPlaceholder);
+                m_texAORM = m_resources.texture(m_texAORMSlot.m_current, m_texPlaceholder);
+
                 // get delta time
                 int64_t now = bx::getHPCounter();
                 static int64_t last = now;
@@ -423,39 +683,47 @@ namespace RenderCore {
                 const auto deltaTime = float(frameTime / freq);
                 cameraUpdate(deltaTime, m_mouseState);
 
-                // shadow map settings
+                // shadow map settings, the atlas is recreated when the tile layout changes
+                const uint8_t numCascades = m_settings.m_pointLightShadow
+                                            ? Shadow::kNumOmniFaces
+                                            : uint8_t(m_settings.m_numCascades);
+                const uint16_t cascadeSize = s_cascadeSizes[m_settings.m_cascadeSizeIdx];
+                if (numCascades != m_numCascades || cascadeSize != m_shadowMapSize) {
+                    if (bgfx::isValid(m_shadowMapFB)) {
+                        bgfx::destroy(m_shadowMapFB);
+                        m_shadowMapFB = BGFX_INVALID_HANDLE;
+                    }
+                    if (bgfx::isValid(m_staticShadowMapFB)) {
+                        bgfx::destroy(m_staticShadowMapFB);
+                        m_staticShadowMapFB = BGFX_INVALID_HANDLE;
+                    }
+                    m_numCascades = numCascades;
+                    m_shadowMapSize = cascadeSize;
+                }
+
                 if (!bgfx::isValid(m_shadowMapFB)) {
-                    bgfx::TextureHandle shadowMapTexture = BGFX_INVALID_HANDLE;
-
-                    m_shadowProgram = loadProgram("shadow_vs", "shadow_fs");
-
-                    bgfx::TextureHandle fbtextures[] =
-                            {
-                                    bgfx::createTexture2D(
-                                            m_shadowMapSize, m_shadowMapSize, false, 1, bgfx::TextureFormat::BGRA8,
-                                            BGFX_TEXTURE_RT
-                                    ),
-                                    bgfx::createTexture2D(
-                                            m_shadowMapSize, m_shadowMapSize, false, 1, bgfx::TextureFormat::D16,
-                                            BGFX_TEXTURE_RT_WRITE_ONLY
-                                    ),
-                            };
-
-                    shadowMapTexture = fbtextures[0];
-                    m_shadowMapFB = bgfx::createFrameBuffer(BX_COUNTOF(fbtextures), fbtextures, true);
-
-                    m_state[0]->m_program = m_shadowProgram;
-                    m_state[0]->m_state = 0
-                                          | BGFX_STATE_WRITE_A
-                                          | BGFX_STATE_WRITE_Z
-                                          | BGFX_STATE_DEPTH_TEST_LESS
-                                          | BGFX_STATE_CULL_CCW
-                                          | BGFX_STATE_MSAA;
-
-                    m_state[1]->m_program = m_meshProgram;
-                    m_state[1]->m_textures[2].m_texture = shadowMapTexture;
-                    m_shadowMap = shadowMapTexture;
-                    // bgfx::setTexture(0, s_shadowMap, shadowMapTexture);
+                    uint8_t cols, rows;
+                    Shadow::atlasLayout(m_numCascades, cols, rows);
+                    const uint16_t atlasWidth = uint16_t(m_shadowMapSize * cols);
+                    const uint16_t atlasHeight = uint16_t(m_shadowMapSize * rows);
+
+                    // the working atlas receives the cached static atlas through a blit
+                    m_shadowMapFB = createShadowAtlas(atlasWidth, atlasHeight,
+                                                      m_shadowCacheSupported ? BGFX_TEXTURE_BLIT_DST : 0);
+                    m_shadowMap = bgfx::getTexture(m_shadowMapFB);
+                    if (m_shadowCacheSupported) {
+                        m_staticShadowMapFB = createShadowAtlas(atlasWidth, atlasHeight, 0);
+                    }
+                    m_staticShadowValid = false;
+                    m_shadowTilesUsed = UINT8_MAX;
+                    m_staticShadowTilesUsed = UINT8_MAX;
+
+                    m_shadowPassState = 0
+                                        | (m_shadowSamplerSupported ? 0 : BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A)
+                                        | BGFX_STATE_WRITE_Z
+                                        | BGFX_STATE_DEPTH_TEST_LESS
+                                        | BGFX_STATE_CULL_CCW
+                                        | BGFX_STATE_MSAA;
                 }
 
                 // load camera position to settings
@@ -467,210 +735,162 @@ namespace RenderCore {
                 // load settings to uniforms
                 m_uniforms.u_roughness = m_settings.m_roughness;
                 m_uniforms.u_metallic = m_settings.m_metallic;
-                m_uniforms.u_exposure = m_settings.m_exposure;
-                m_uniforms.u_isFloor = m_settings.m_isFloor;
-                m_uniforms.u_pcfFilterSize = m_settings.m_pcfFilterSize;
-                m_uniforms.u_useBlinnPhong = m_settings.m_useBlinnPhong;
-                m_uniforms.u_usePBR = m_settings.m_usePBR;
-                m_uniforms.u_useDiffuseIBL = m_settings.m_useDiffuseIBL;
-                m_uniforms.u_useSpecularIBL = m_settings.m_useSpecularIBL;
-                m_uniforms.u_useShadowMap = m_settings.m_useShadowMap;
-                bx::memCopy(m_uniforms.u_lightPos, m_settings.m_lightPos, 4 * sizeof(float));
-                bx::memCopy(m_uniforms.u_lightColor, m_settings.m_lightColor, 4 * sizeof(float));
-                bx::memCopy(m_uniforms.u_viewPos, m_settings.m_viewPos, 4 * sizeof(float));
                 bx::memCopy(m_uniforms.u_diffuseColor, m_settings.m_diffuseColor, 4 * sizeof(float));
 
-                // define matrices
-                float lightView[16];
-                float lightProj[16];
-
-                const bx::Vec3 at = {0.0f, 0.0f, 0.0f};
-                const bx::Vec3 eye = {m_settings.m_lightPos[0], m_settings.m_lightPos[1], m_settings.m_lightPos[2]};
-                bx::mtxLookAt(lightView, eye, at);
+                // select the mesh program permutations for the current settings
+                updateMaterials(meshFeatureMask());
 
                 const bgfx::Caps *caps = bgfx::getCaps();
-                const float area = 30.0f;
-                bx::mtxOrtho(lightProj, -area, area, -area, area, -100.0f, 100.0f, 0.0f, caps->homogeneousDepth);
 
-                // cross-platform texture coordinate procession
-                float mtxShadow[16];
-                float lightMtx[16];
-
-                const float sy = caps->originBottomLeft ? 0.5f : -0.5f;
-                const float sz = caps->homogeneousDepth ? 0.5f : 1.0f;
-                const float tz = caps->homogeneousDepth ? 0.5f : 0.0f;
-                const float mtxCrop[16] =
-                        {
-                                0.5f, 0.0f, 0.0f, 0.0f,
-                                0.0f, sy, 0.0f, 0.0f,
-                                0.0f, 0.0f, sz, 0.0f,
-                                0.5f, 0.5f, tz, 1.0f,
-                        };
+                // view and proj matrix for the scene camera
+                float viewMatrix[16];
+                float projMatrix[16];
+                const float aspect = float(m_width) / float(m_height);
+                cameraGetViewMtx(viewMatrix);
+                bx::mtxProj(projMatrix, cameraGetFoV(), aspect, CAMERA_NEAR, CAMERA_FAR, caps->homogeneousDepth);
 
-                float mtxTmp[16];
-                bx::mtxMul(mtxTmp, lightProj, mtxCrop);
-                bx::mtxMul(mtxShadow, lightView, mtxTmp);
+                // bin the point lights into the camera's clusters
+                updatePointLights(time);
+                m_clusteredLights.update(m_pointLights.data(), uint32_t(m_settings.m_numPointLights), viewMatrix,
+                                         projMatrix, CAMERA_NEAR, CAMERA_FAR);
 
-                // set shadow map pass
-                bgfx::setViewRect(SHADOW_PASS_ID, 0, 0, uint16_t(m_width), uint16_t(m_height));
-                bgfx::setViewFrameBuffer(SHADOW_PASS_ID, m_shadowMapFB);
-                bgfx::setViewTransform(SHADOW_PASS_ID, lightView, lightProj);
-                bgfx::setViewClear(SHADOW_PASS_ID, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
+                // one face per cube direction around the point light, or cascades fitted to the camera frustum
+                const bx::Vec3 at = {0.0f, 0.0f, 0.0f};
+                const bx::Vec3 eye = {m_settings.m_lightPos[0], m_settings.m_lightPos[1], m_settings.m_lightPos[2]};
+                if (m_settings.m_pointLightShadow) {
+                    Shadow::updateOmni(m_cascades, m_shadowMapSize, eye);
+                } else {
+                    Shadow::update(m_cascades, m_numCascades, m_shadowMapSize, viewMatrix, cameraGetFoV(), aspect,
+                                   CAMERA_NEAR, CAMERA_FAR, m_settings.m_cascadeSplitLambda, eye, at);
+                }
+                updateFrameUniforms();
+
+                // set shadow map passes, one atlas tile per cascade or face, with the cache the working atlas starts
+                // as a copy of the static atlas and is not cleared
+                const bool cacheStaticShadows = m_shadowCacheSupported && m_settings.m_cacheStaticShadows;
+                const uint16_t shadowClear = m_shadowSamplerSupported
+                                             ? BGFX_CLEAR_DEPTH
+                                             : BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH;
+                for (uint8_t ii = 0; ii < Shadow::kMaxViews; ++ii) {
+                    const uint16_t *rect = m_cascades.m_rects[ii];
+                    const bgfx::ViewId staticViewId = bgfx::ViewId(STATIC_SHADOW_PASS_ID + ii);
+                    bgfx::setViewRect(staticViewId, rect[0], rect[1], rect[2], rect[3]);
+                    bgfx::setViewFrameBuffer(staticViewId, m_staticShadowMapFB);
+                    bgfx::setViewTransform(staticViewId, m_cascades.m_lightView[ii], m_cascades.m_lightProj[ii]);
+                    bgfx::setViewClear(staticViewId, shadowClear, 0xffffffff, 1.0f, 0);
+
+                    const bgfx::ViewId viewId = bgfx::ViewId(SHADOW_PASS_ID + ii);
+                    bgfx::setViewRect(viewId, rect[0], rect[1], rect[2], rect[3]);
+                    bgfx::setViewFrameBuffer(viewId, m_shadowMapFB);
+                    bgfx::setViewTransform(viewId, m_cascades.m_lightView[ii], m_cascades.m_lightProj[ii]);
+                    bgfx::setViewClear(viewId, cacheStaticShadows ? 0 : shadowClear, 0xffffffff, 1.0f, 0);
+                }
 
-                // set scene pass
+                // set depth pre-pass and scene pass, rendered in HDR and tonemapped to the back buffer afterwards,
+                // the pre-pass sorts front to back and clears the target so the scene pass keeps its depth. It is
+                // touched since bgfx skips the clear of a view without draws, e.g. when the pre-pass is disabled.
+                const bgfx::FrameBufferHandle hdrFrameBuffer = m_toneMapping.frameBuffer(m_width, m_height);
+                bgfx::setViewRect(DEPTH_PASS_ID, 0, 0, uint16_t(m_width), uint16_t(m_height));
+                bgfx::setViewFrameBuffer(DEPTH_PASS_ID, hdrFrameBuffer);
+                bgfx::setViewClear(DEPTH_PASS_ID, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
+                bgfx::setViewTransform(DEPTH_PASS_ID, viewMatrix, projMatrix);
+                bgfx::setViewMode(DEPTH_PASS_ID, bgfx::ViewMode::DepthAscending);
+                bgfx::touch(DEPTH_PASS_ID);
                 bgfx::setViewRect(SCENE_PASS_ID, 0, 0, uint16_t(m_width), uint16_t(m_height));
-                bgfx::setViewClear(SCENE_PASS_ID, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0x303030ff, 1.0f, 0);
-                // view and proj matrix for
-                float viewMatrix[16];
-                float projMatrix[16];
-                cameraGetViewMtx(viewMatrix);
-                bx::mtxProj(projMatrix, cameraGetFoV(), float(m_width) / float(m_height),
-                            0.1f, 100.0f, caps->homogeneousDepth);
-                // view transform 0 for mesh
+                bgfx::setViewFrameBuffer(SCENE_PASS_ID, hdrFrameBuffer);
+                bgfx::setViewClear(SCENE_PASS_ID, 0, 0x303030ff, 1.0f, 0);
                 bgfx::setViewTransform(SCENE_PASS_ID, viewMatrix, projMatrix);
 
                 // set skybox pass
                 bgfx::setViewRect(SKYBOX_PASS_ID, 0, 0, uint16_t(m_width), uint16_t(m_height));
                 bgfx::setViewClear(SKYBOX_PASS_ID, 0, 0x303030ff, 1.0f, 0);
+                bgfx::setViewFrameBuffer(SKYBOX_PASS_ID, hdrFrameBuffer);
+
+                // move the dynamic objects, then cull and submit every pass from the render list
+                updateRenderList(time);
+                m_renderList.upload();
+
+                // shadow pass, culled against each tile so tiles without casters are skipped, static casters are
+                // only redrawn into the cache when they, the light or the tile frustum changed since it was filled
+                const bool staticShadowsDirty = !m_staticShadowValid
+                                                || m_staticShadowRevision != m_renderList.staticRevision();
+                m_numStaticShadowUpdates = 0;
+                m_numShadowTilesDrawn = 0;
+                for (uint8_t ii = 0; ii < m_numCascades; ++ii) {
+                    if (!cacheStaticShadows) {
+                        const uint32_t num = submitShadowCasters(SHADOW_PASS_ID + ii, ii, 0, 0);
+                        m_numShadowTilesDrawn += updateShadowTile(m_shadowTilesUsed, SHADOW_PASS_ID, ii, num);
+                        continue;
+                    }
 
-                // render pbr stone
-                if (m_settings.m_visPbrStone) {
-                    m_uniforms.u_usePBRMaps = true;
-                    float modelStone[16];
-                    // bx::mtxRotateXY(modelStone, 0.0f, time * 0.37f);
-                    bx::mtxSRT(modelStone, 0.3f, 0.3f, 0.3f, 0.0f, 0.0f, 0.0f, 5.0f, 3.0f, 5.0f
-                    );
-
-                    // shadow pass
-                    bx::mtxMul(lightMtx, modelStone, mtxShadow);
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    meshSubmit(m_pbrStone, &m_state[0], 1, modelStone);
-
-                    // scene pass
-                    uint64_t state = 0
-                                     | BGFX_STATE_WRITE_RGB
-                                     | BGFX_STATE_WRITE_Z
-                                     | BGFX_STATE_DEPTH_TEST_LESS
-                                     | BGFX_STATE_MSAA;
-                    // set texture
-                    bgfx::setTexture(0, s_texCube, m_texCube);
-                    bgfx::setTexture(1, s_texCubeIrr, m_texCubeIrr);
-                    bgfx::setTexture(2, s_shadowMap, m_shadowMap, UINT32_MAX);
-                    bgfx::setTexture(3, s_texDiffuse, m_texDiffuse);
-                    bgfx::setTexture(4, s_texNormal, m_texNormal);
-                    bgfx::setTexture(5, s_texAORM, m_texAORM);
-                    // submit uniforms
-                    m_uniforms.submit();
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    // draw mesh
-                    meshSubmit(m_pbrStone, SCENE_PASS_ID, m_meshProgram, modelStone, state);
-                    // set: not use pbr maps for other meshes
-                    m_uniforms.u_usePBRMaps = false;
-                }
-
-                // render floor
-                {
-                    float mtxFloor[16];
-                    bx::mtxSRT(mtxFloor, 30.0f, 30.0f, 30.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f
-                    );
-                    bx::mtxMul(lightMtx, mtxFloor, mtxShadow);
-
-                    // shadow pass
-                    bgfx::setIndexBuffer(m_planeIbh);
-                    bgfx::setVertexBuffer(0, m_planeVbh);
-                    bgfx::setState(m_state[SHADOW_PASS_ID]->m_state);
-                    bgfx::setTransform(mtxFloor);
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    bgfx::submit(SHADOW_PASS_ID, m_shadowProgram);
-
-                    // scene pass
-                    bgfx::setIndexBuffer(m_planeIbh);
-                    bgfx::setVertexBuffer(0, m_planeVbh);
-                    bgfx::setState(m_state[SCENE_PASS_ID]->m_state);
-                    bgfx::setTransform(mtxFloor);
-                    bgfx::setTexture(0, s_texCube, m_texCube);
-                    bgfx::setTexture(1, s_texCubeIrr, m_texCubeIrr);
-                    bgfx::setTexture(2, s_shadowMap, m_shadowMap);
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    m_settings.m_isFloor = true;
-                    m_uniforms.u_isFloor = m_settings.m_isFloor;
-                    m_uniforms.submit();
-                    bgfx::submit(SCENE_PASS_ID, m_meshProgram);
+                    if (staticShadowsDirty
+                        || 0 != bx::memCmp(m_staticLightView[ii], m_cascades.m_lightView[ii],
+                                           sizeof(m_staticLightView[ii]))
+                        || 0 != bx::memCmp(m_staticLightProj[ii], m_cascades.m_lightProj[ii],
+                                           sizeof(m_staticLightProj[ii]))) {
+                        const uint32_t num = submitShadowCasters(STATIC_SHADOW_PASS_ID + ii, ii, 0,
+                                                                 RenderFlags::Dynamic);
+                        updateShadowTile(m_staticShadowTilesUsed, STATIC_SHADOW_PASS_ID, ii, num);
+                        bx::memCopy(m_staticLightView[ii], m_cascades.m_lightView[ii], sizeof(m_staticLightView[ii]));
+                        bx::memCopy(m_staticLightProj[ii], m_cascades.m_lightProj[ii], sizeof(m_staticLightProj[ii]));
+                        ++m_numStaticShadowUpdates;
+                    }
+                    const uint32_t num = submitShadowCasters(SHADOW_PASS_ID + ii, ii, RenderFlags::Dynamic, 0);
+                    m_numShadowTilesDrawn += 0 != num ? 1 : 0;
                 }
 
-                m_settings.m_isFloor = false;
-                m_uniforms.u_isFloor = m_settings.m_isFloor;
+                if (cacheStaticShadows) {
+                    m_staticShadowRevision = m_renderList.staticRevision();
+                    m_staticShadowValid = true;
 
-                // render light
-                { // Current primitive topology
-                    uint64_t state = 0
-                                     | BGFX_STATE_WRITE_RGB
-                                     | BGFX_STATE_WRITE_Z
-                                     | BGFX_STATE_DEPTH_TEST_LESS
-                                     | BGFX_STATE_CULL_CW
-                                     | BGFX_STATE_MSAA
-                                     | BGFX_STATE_PT_TRISTRIP;
-                    float modelLight[16];
-                    m_uniforms.submit();
-                    bx::mtxSRT(modelLight,
-                               0.5f, 0.5f, 0.5f,
-                               0.0f, 0.0f, 0.0f,
-                               m_settings.m_lightPos[0],
-                               m_settings.m_lightPos[1],
-                               m_settings.m_lightPos[2]);
-                    // Set model matrix for rendering.
-                    bgfx::setTransform(modelLight);
-                    // Set vertex and index buffer.
-                    bgfx::setVertexBuffer(SCENE_PASS_ID, m_lightVbh);
-                    bgfx::setIndexBuffer(m_lightIbh);
-                    // Set render states.
-                    bgfx::setState(state);
-                    // Submit primitive for rendering to view 0.
-                    bgfx::submit(SCENE_PASS_ID, m_lightProgram);
-                }
+                    // the working atlas holds the blitted cache, uncached drawing has to clear every tile again
+                    m_shadowTilesUsed = UINT8_MAX;
 
-                // render hollow cube
-                {
-                    float modelHollowCube[16];
-                    bx::mtxSRT(modelHollowCube, 1.0f, 1.0f, 1.0f, 0.0f, 1.56f - time, 0.0f, -20.0f, 5.0f, 20.0f
-                    );
-                    // shadow pass
-                    bx::mtxMul(lightMtx, modelHollowCube, mtxShadow);
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    meshSubmit(m_hollowCube, &m_state[0], 1, modelHollowCube);
-
-                    // scene pass
-                    // submit uniforms
-                    m_uniforms.submit();
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    // draw mesh
-                    meshSubmit(m_hollowCube, &m_state[1], 1, modelHollowCube);
+                    // depth, and packed depth without comparison samplers, blitted before the dynamic casters
+                    const uint8_t numAttachments = m_shadowSamplerSupported ? 1 : 2;
+                    for (uint8_t ii = 0; ii < numAttachments; ++ii) {
+                        bgfx::blit(SHADOW_PASS_ID, bgfx::getTexture(m_shadowMapFB, ii), 0, 0,
+                                   bgfx::getTexture(m_staticShadowMapFB, ii));
+                    }
+                } else {
+                    m_staticShadowValid = false;
                 }
 
-                // render mesh
+                // scene pass, culled against the camera
                 {
-                    float modelMesh[16];
-                    // bx::mtxRotateXY(model_matrix, 0.0f, time * 0.37f);
-                    bx::mtxTranslate(modelMesh, m_settings.m_meshPos[0], m_settings.m_meshPos[1],
-                                     m_settings.m_meshPos[2]);
-
-                    // shadow pass
-                    bx::mtxMul(lightMtx, modelMesh, mtxShadow);
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    meshSubmit(m_mesh, &m_state[0], 1, modelMesh);
-
-                    // scene pass
-                    // submit uniforms
-                    m_uniforms.submit();
-                    bgfx::setUniform(u_lightMtx, lightMtx);
-                    // draw mesh
-                    meshSubmit(m_mesh, &m_state[1], 1, modelMesh);
+                    float viewProj[16];
+                    bx::mtxMul(viewProj, viewMatrix, projMatrix);
+                    const uint32_t numVisible = m_renderList.cull(m_visible.data(), viewProj, RenderFlags::Enabled);
+                    m_renderList.selectLods(m_visible.data(), numVisible, viewProj,
+                                            projMatrix[5] * float(m_height) * 0.5f, m_settings.m_lodPixelError);
+                    const uint32_t numBatches = m_renderList.batch(m_batches.data(), m_visible.data(), numVisible);
+                    for (uint32_t ii = 0; ii < numBatches; ++ii) {
+                        const RenderBatch &batch = m_batches[ii];
+                        const Material &material = m_materials[m_renderList.material(m_visible[batch.m_first])];
+                        if (bgfx::isValid(material.m_depthProgram)) {
+                            submitBatch(DEPTH_PASS_ID, batch, material.m_depthProgram, material.m_depthInstancedProgram,
+                                        [&]() {
+                                            bgfx::setState(material.m_depthState);
+                                        }, viewMatrix);
+                        }
+                        submitBatch(SCENE_PASS_ID, batch, material.m_program, material.m_instancedProgram,
+                                    [&]() {
+                                        bgfx::setState(material.m_state);
+                                        for (uint8_t tex = 0; tex < material.m_numTextures; ++tex) {
+                                            const MeshState::Texture &texture = material.m_textures[tex];
+                                            bgfx::setTexture(texture.m_stage, texture.m_sampler, texture.m_texture,
+                                                             texture.m_flags);
+                                        }
+                                        material.m_uniforms.submit();
+                                        bgfx::setUniformBlock(kFrameUniformStage, u_frame);
+                                        m_clusteredLights.submit();
+                                    });
+                    }
                 }
 
                 // render sky box
                 if (m_settings.m_visSkyBox) {
                     bgfx::setTexture(0, s_texCube, m_texCube);
-                    bgfx::setTexture(1, s_texCubeIrr, m_texCubeIrr);
                     uint64_t state = 0
                                      | BGFX_STATE_WRITE_RGB
                                      | BGFX_STATE_DEPTH_TEST_LEQUAL;
@@ -683,14 +903,17 @@ namespace RenderCore {
                     view_sky[13] = 0;
                     view_sky[14] = 0;
                     float proj_sky[16];
-                    bx::mtxProj(proj_sky, cameraGetFoV(), float(m_width) / float(m_height),
-                                0.1f, 100.0f, caps->homogeneousDepth);
+                    bx::mtxProj(proj_sky, cameraGetFoV(), aspect, CAMERA_NEAR, CAMERA_FAR, caps->homogeneousDepth);
                     bgfx::setViewTransform(SKYBOX_PASS_ID, view_sky, proj_sky);
                     float model_sky[16];
                     bx::mtxIdentity(model_sky);
                     meshSubmit(m_skyBoxMesh, SKYBOX_PASS_ID, m_skyBoxProgram, model_sky, state);
                 }
 
+                // exposure and tonemapping
+                m_toneMapping.submit(HISTOGRAM_PASS_ID, EXPOSURE_PASS_ID, TONEMAP_PASS_ID, m_settings.m_exposure,
+                                     deltaTime);
+
                 // Advance to next frame. Rendering thread will be kicked to
                 // process submitted rendering primitives.
                 bgfx::frame();
@@ -701,6 +924,348 @@ namespace RenderCore {
             return false;
         }
 
+        // replaces the pending request of a slot, the current resource stays until the new one is ready
+        void requestSlot(ResourceSlot &_slot, ResourceHandle _handle) {
+            m_resources.release(_slot.m_pending);
+            _slot.m_pending = _handle;
+        }
+
+        // returns true when the slot switched to its pending resource
+        bool updateSlot(ResourceSlot &_slot) {
+            const AsyncLoadStatus::Enum status = m_resources.status(_slot.m_pending);
+            if (AsyncLoadStatus::Ready == status) {
+                m_resources.release(_slot.m_current);
+                _slot.m_current = _slot.m_pending;
+                _slot.m_pending = kInvalidResource;
+                return true;
+            }
+
+            if (AsyncLoadStatus::Failed == status) {
+                m_resources.release(_slot.m_pending);
+                _slot.m_pending = kInvalidResource;
+            }
+
+            return false;
+        }
+
+        void releaseSlot(ResourceSlot &_slot) {
+            m_resources.release(_slot.m_current);
+            m_resources.release(_slot.m_pending);
+            _slot = {kInvalidResource, kInvalidResource};
+        }
+
+        void showSlotStatus(const ResourceSlot &_slot) const {
+            if (AsyncLoadStatus::Pending == m_resources.status(_slot.m_pending)) {
+                ImGui::SameLine();
+                ImGui::Text("Loading...");
+            }
+        }
+
+        // scattered over the floor with random colors, the count setting picks the first lights
+        void initPointLights() {
+            bx::RngMwc rng;
+            m_pointLightBase.resize(Lights::kMaxLights);
+            m_pointLights.resize(Lights::kMaxLights);
+            for (uint32_t ii = 0; ii < Lights::kMaxLights; ++ii) {
+                Lights::PointLight &light = m_pointLightBase[ii];
+                light.m_pos[0] = (bx::frnd(&rng) * 2.0f - 1.0f) * 25.0f;
+                light.m_pos[1] = 0.5f + bx::frnd(&rng) * 3.0f;
+                light.m_pos[2] = (bx::frnd(&rng) * 2.0f - 1.0f) * 25.0f;
+                light.m_radius = 0.5f + bx::frnd(&rng);
+
+                const float hsv[3] = {bx::frnd(&rng), 0.8f, 1.0f};
+                bx::hsvToRgb(light.m_color, hsv);
+            }
+        }
+
+        // lights circle around their base position, the base radius scales the radius setting
+        void updatePointLights(float _time) {
+            const float time = m_settings.m_animatePointLights ? _time : 0.0f;
+            for (int32_t ii = 0; ii < m_settings.m_numPointLights; ++ii) {
+                const Lights::PointLight &base = m_pointLightBase[ii];
+                Lights::PointLight &light = m_pointLights[ii];
+                const float phase = float(ii) * 2.4f + time;
+                light.m_pos[0] = base.m_pos[0] + bx::cos(phase) * 2.0f;
+                light.m_pos[1] = base.m_pos[1];
+                light.m_pos[2] = base.m_pos[2] + bx::sin(phase) * 2.0f;
+                light.m_radius = m_settings.m_pointLightRadius * base.m_radius;
+                light.m_color[0] = base.m_color[0] * m_settings.m_pointLightIntensity;
+                light.m_color[1] = base.m_color[1] * m_settings.m_pointLightIntensity;
+                light.m_color[2] = base.m_color[2] * m_settings.m_pointLightIntensity;
+            }
+        }
+
+        // static objects are placed here, dynamic ones are moved every frame by updateRenderList
+        void buildRenderList() {
+            m_renderList.clear();
+
+            float modelStone[16];
+            bx::mtxSRT(modelStone, 0.3f, 0.3f, 0.3f, 0.0f, 0.0f, 0.0f, 5.0f, 3.0f, 5.0f);
+            m_pbrStoneObject = m_renderList.add(m_pbrStone, MaterialId::PbrStone,
+                                                RenderFlags::Enabled | RenderFlags::CastShadow, modelStone);
+
+            float mtxFloor[16];
+            bx::mtxSRT(mtxFloor, 30.0f, 30.0f, 30.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+            const bx::Sphere planeSphere = {{0.0f, 0.0f, 0.0f}, bx::sqrt(2.0f)};
+            m_renderList.add(m_planeVbh, m_planeIbh, planeSphere, MaterialId::Floor,
+                             RenderFlags::Enabled | RenderFlags::CastShadow, mtxFloor);
+
+            float identity[16];
+            bx::mtxIdentity(identity);
+            const bx::Sphere cubeSphere = {{0.0f, 0.0f, 0.0f}, bx::sqrt(3.0f)};
+            m_lightObject = m_renderList.add(m_lightVbh, m_lightIbh, cubeSphere, MaterialId::Light,
+                                             RenderFlags::Enabled, identity);
+            m_hollowCubeObject = m_renderList.add(m_hollowCube, MaterialId::Default,
+                                                  RenderFlags::Enabled | RenderFlags::CastShadow | RenderFlags::Dynamic,
+                                                  identity);
+            // the mesh is absent until its first load finished
+            m_meshObject = NULL != m_mesh
+                           ? m_renderList.add(m_mesh, MaterialId::Default,
+                                              RenderFlags::Enabled | RenderFlags::CastShadow, identity)
+                           : RenderObject{m_renderList.size(), 0};
+
+            m_visible.resize(m_renderList.size());
+            m_batches.resize(m_renderList.size());
+        }
+
+        void updateRenderList(float _time) {
+            m_renderList.setFlags(m_pbrStoneObject, RenderFlags::Enabled, m_settings.m_visPbrStone);
+
+            float modelLight[16];
+            bx::mtxSRT(modelLight,
+                       0.5f, 0.5f, 0.5f,
+                       0.0f, 0.0f, 0.0f,
+                       m_settings.m_lightPos[0],
+                       m_settings.m_lightPos[1],
+                       m_settings.m_lightPos[2]);
+            m_renderList.setTransform(m_lightObject, modelLight);
+
+            float modelHollowCube[16];
+            bx::mtxSRT(modelHollowCube, 1.0f, 1.0f, 1.0f, 0.0f, 1.56f - _time, 0.0f, -20.0f, 5.0f, 20.0f);
+            m_renderList.setTransform(m_hollowCubeObject, modelHollowCube);
+
+            float modelMesh[16];
+            bx::mtxTranslate(modelMesh, m_settings.m_meshPos[0], m_settings.m_meshPos[1], m_settings.m_meshPos[2]);
+            m_renderList.setTransform(m_meshObject, modelMesh);
+        }
+
+        void updateMaterials(uint16_t _meshFeatures) {
+            const MeshState::Texture sceneTextures[] = {
+                    {0, s_texCube, m_texCube, 0},
+                    {UINT32_MAX, s_shadowMap, m_shadowMap, 2},
+                    {kShadowDepthSamplerFlags, s_shadowDepth, m_shadowMap, 6},
+                    {0, s_brdfLut, m_brdfLut, Ibl::kBrdfLutStage},
+            };
+            const uint64_t sceneState = 0
+                                        | BGFX_STATE_WRITE_RGB
+                                        | BGFX_STATE_WRITE_A
+                                        | BGFX_STATE_WRITE_Z
+                                        | BGFX_STATE_DEPTH_TEST_LESS
+                                        | BGFX_STATE_CULL_CCW
+                                        | BGFX_STATE_MSAA;
+
+            Material &material = m_materials[MaterialId::Default];
+            material.m_program = m_meshPrograms.get(_meshFeatures);
+            material.m_instancedProgram = m_instancedMeshPrograms.get(_meshFeatures);
+            material.m_state = sceneState;
+            material.m_depthProgram = m_depthProgram;
+            material.m_depthInstancedProgram = m_depthInstancedProgram;
+            material.m_uniforms = m_uniforms;
+            material.m_numTextures = BX_COUNTOF(sceneTextures);
+            bx::memCopy(material.m_textures, sceneTextures, sizeof(sceneTextures));
+
+            // the floor is a plain rough white dielectric regardless of the mesh material
+            Material &floor = m_materials[MaterialId::Floor];
+            floor = material;
+            floor.m_uniforms.u_roughness = 1.0f;
+            floor.m_uniforms.u_metallic = 0.0f;
+            floor.m_uniforms.u_diffuseColor[0] = 1.0f;
+            floor.m_uniforms.u_diffuseColor[1] = 1.0f;
+            floor.m_uniforms.u_diffuseColor[2] = 1.0f;
+
+            Material &stone = m_materials[MaterialId::PbrStone];
+            stone = material;
+            const uint16_t stoneFeatures = _meshFeatures | MeshFeature::PbrMaps
+                                           | MeshFeature::fromLayout(m_pbrStone->m_layout);
+            stone.m_program = m_meshPrograms.get(stoneFeatures);
+            stone.m_instancedProgram = m_instancedMeshPrograms.get(stoneFeatures);
+            stone.m_state = 0
+                            | BGFX_STATE_WRITE_RGB
+                            | BGFX_STATE_WRITE_Z
+                            | BGFX_STATE_DEPTH_TEST_LESS
+                            | BGFX_STATE_MSAA;
+            stone.m_textures[stone.m_numTextures++] = {0, s_texDiffuse, m_texDiffuse, 3};
+            stone.m_textures[stone.m_numTextures++] = {0, s_texNormal, m_texNormal, 4};
+            stone.m_textures[stone.m_numTextures++] = {0, s_texAORM, m_texAORM, 5};
+
+            // after the depth pre-pass the shaded materials only test for the depth they laid down,
+            // cheap unlit materials are left out of it and keep testing and writing depth themselves
+            for (Material *shaded: {&material, &floor, &stone}) {
+                if (m_settings.m_depthPrePass) {
+                    shaded->m_depthState = 0
+                                           | BGFX_STATE_WRITE_Z
+                                           | BGFX_STATE_DEPTH_TEST_LESS
+                                           | (shaded->m_state & (BGFX_STATE_CULL_MASK | BGFX_STATE_MSAA));
+                    shaded->m_state = (shaded->m_state & ~(BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_MASK))
+                                      | BGFX_STATE_DEPTH_TEST_EQUAL;
+                } else {
+                    shaded->m_depthProgram = BGFX_INVALID_HANDLE;
+                    shaded->m_depthInstancedProgram = BGFX_INVALID_HANDLE;
+                }
+            }
+
+            Material &light = m_materials[MaterialId::Light];
+            light.m_program = m_lightProgram;
+            light.m_instancedProgram = BGFX_INVALID_HANDLE;
+            light.m_depthProgram = BGFX_INVALID_HANDLE;
+            light.m_depthInstancedProgram = BGFX_INVALID_HANDLE;
+            light.m_state = 0
+                            | BGFX_STATE_WRITE_RGB
+                            | BGFX_STATE_WRITE_Z
+                            | BGFX_STATE_DEPTH_TEST_LESS
+                            | BGFX_STATE_CULL_CW
+                            | BGFX_STATE_MSAA
+                            | BGFX_STATE_PT_TRISTRIP;
+            light.m_uniforms = m_uniforms;
+            light.m_numTextures = 0;
+        }
+
+        // both atlases share the layout, the working one is also a blit destination for the cache
+        bgfx::FrameBufferHandle createShadowAtlas(uint16_t _width, uint16_t _height, uint64_t _flags) const {
+            if (m_shadowSamplerSupported) {
+                // depth only, sampled with a comparison sampler
+                bgfx::TextureHandle fbtextures[] =
+                        {
+                                bgfx::createTexture2D(
+                                        _width, _height, false, 1, bgfx::TextureFormat::D16,
+                                        BGFX_TEXTURE_RT | BGFX_SAMPLER_COMPARE_LEQUAL | _flags
+                                ),
+                        };
+                return bgfx::createFrameBuffer(BX_COUNTOF(fbtextures), fbtextures, true);
+            }
+
+            // depth packed into color, the depth buffer is only used for testing unless it is cached
+            bgfx::TextureHandle fbtextures[] =
+                    {
+                            bgfx::createTexture2D(
+                                    _width, _height, false, 1, bgfx::TextureFormat::BGRA8,
+                                    BGFX_TEXTURE_RT | _flags
+                            ),
+                            bgfx::createTexture2D(
+                                    _width, _height, false, 1, bgfx::TextureFormat::D16,
+                                    m_shadowCacheSupported ? BGFX_TEXTURE_RT | _flags : BGFX_TEXTURE_RT_WRITE_ONLY
+                            ),
+                    };
+            return bgfx::createFrameBuffer(BX_COUNTOF(fbtextures), fbtextures, true);
+        }
+
+        // culls the shadow casters carrying _flags but none of _exclude against one tile and draws them
+        // with the shadow level of detail bias, returns the number of casters drawn
+        uint32_t submitShadowCasters(bgfx::ViewId _viewId, uint8_t _tile, uint8_t _flags, uint8_t _exclude) {
+            const float *lightProj = m_cascades.m_lightProj[_tile];
+            float lightViewProj[16];
+            bx::mtxMul(lightViewProj, m_cascades.m_lightView[_tile], lightProj);
+
+            const uint32_t numVisible = m_renderList.cull(m_visible.data(), lightViewProj,
+                                                          RenderFlags::Enabled | RenderFlags::CastShadow | _flags,
+                                                          _exclude);
+            m_renderList.selectLods(m_visible.data(), numVisible, lightViewProj,
+                                    lightProj[5] * float(m_cascades.m_cascadeSize) * 0.5f,
+                                    m_settings.m_lodPixelError * m_settings.m_shadowLodBias);
+            const uint32_t numBatches = m_renderList.batch(m_batches.data(), m_visible.data(), numVisible);
+            for (uint32_t ii = 0; ii < numBatches; ++ii) {
+                submitBatch(_viewId, m_batches[ii], m_shadowProgram, m_shadowInstancedProgram,
+                            [&]() {
+                                bgfx::setState(m_shadowPassState);
+                            });
+            }
+
+            return numVisible;
+        }
+
+        // an untouched view is not cleared, so a tile that lost its casters is touched once to clear it
+        // and then skipped until casters enter it again, returns 1 if the tile was drawn or cleared
+        static uint32_t updateShadowTile(uint8_t &_used, bgfx::ViewId _firstView, uint8_t _tile, uint32_t _num) {
+            const uint8_t bit = uint8_t(1 << _tile);
+            if (0 != _num) {
+                _used |= bit;
+                return 1;
+            }
+
+            if (0 != (_used & bit)) {
+                bgfx::touch(_firstView + _tile);
+                _used &= ~bit;
+                return 1;
+            }
+
+            return 0;
+        }
+
+        // draws a batch with as few instanced draws as the instance data buffer allows, falls back to
+        // one draw per item for single items or when the pass has no instanced program
+        // _view gives every draw the depth of its nearest item, for views sorted by depth
+        template<typename BindFn>
+        void submitBatch(bgfx::ViewId _viewId, const RenderBatch &_batch, bgfx::ProgramHandle _program,
+                         bgfx::ProgramHandle _instancedProgram, const BindFn &_bind, const float *_view = NULL) {
+            const uint32_t *items = &m_visible[_batch.m_first];
+            uint32_t remaining = _batch.m_num;
+            while (0 < remaining) {
+                uint32_t num = 1 < remaining && bgfx::isValid(_instancedProgram)
+                               ? m_renderList.setInstancedGeometry(items, remaining)
+                               : 0;
+                const bool instanced = 0 != num;
+                if (!instanced) {
+                    m_renderList.setGeometry(*items);
+                    num = 1;
+                }
+
+                _bind();
+                const uint32_t depth = NULL != _view ? m_renderList.sortDepth(items, num, _view) : 0;
+                bgfx::submit(_viewId, instanced ? _instancedProgram : _program, depth);
+
+                items += num;
+                remaining -= num;
+            }
+        }
+
+        uint16_t meshFeatureMask() const {
+            uint16_t features = 0;
+            features |= m_settings.m_useBlinnPhong ? MeshFeature::BlinnPhong : 0;
+            features |= m_settings.m_usePBR ? MeshFeature::PBR : 0;
+            features |= m_settings.m_useDiffuseIBL ? MeshFeature::DiffuseIBL : 0;
+            features |= m_settings.m_useSpecularIBL && bgfx::isValid(m_texCube) ? MeshFeature::SpecularIBL : 0;
+            features |= m_settings.m_useShadowMap ? MeshFeature::ShadowMap : 0;
+            features |= m_settings.m_usePCSS ? MeshFeature::PCSS : 0;
+            features |= m_settings.m_pointLightShadow ? MeshFeature::PointShadow : 0;
+            features |= m_shadowSamplerSupported ? 0 : MeshFeature::ShadowPackedDepth;
+            return features;
+        }
+
+        // the block is uploaded once on bgfx::frame, the scene draws only bind it
+        void updateFrameUniforms() {
+            const float shadowParams[4] = {
+                    float(m_cascades.m_numCascades),
+                    1.0f / float(m_cascades.m_atlasWidth),
+                    1.0f / float(m_cascades.m_atlasHeight),
+                    m_settings.m_pcssLightSize,
+            };
+            const float frameParams[4] = {
+                    m_settings.m_pcfFilterSize,
+                    float(bx::max<uint8_t>(m_texCubeInfo.numMips, 1) - 1),
+                    float(m_texCubeInfo.width),
+                    0.0f,
+            };
+            bgfx::updateUniformBlock(u_frame, u_lightPos, m_settings.m_lightPos);
+            bgfx::updateUniformBlock(u_frame, u_lightColor, m_settings.m_lightColor);
+            bgfx::updateUniformBlock(u_frame, u_viewPos, m_settings.m_viewPos);
+            bgfx::updateUniformBlock(u_frame, u_frameParams, frameParams);
+            bgfx::updateUniformBlock(u_frame, m_clusteredLights.paramsUniform(), m_clusteredLights.params());
+            bgfx::updateUniformBlock(u_frame, u_lightMtx, m_cascades.m_lightMtx, Shadow::kMaxViews);
+            bgfx::updateUniformBlock(u_frame, u_shadowTiles, m_cascades.m_tiles, Shadow::kMaxViews);
+            bgfx::updateUniformBlock(u_frame, u_cascadeSplits, m_cascades.m_splits);
+            bgfx::updateUniformBlock(u_frame, u_shadowParams, shadowParams);
+        }
+
         entry::MouseState m_mouseState;
 
         uint32_t m_width;
@@ -716,38 +1281,96 @@ namespace RenderCore {
 
         Mesh *m_mesh;
         std::string m_meshName;
-        bgfx::ProgramHandle m_meshProgram;
+        ResourceSlot m_meshSlot;
+        ProgramCache m_meshPrograms;
+        ProgramCache m_instancedMeshPrograms;
         bgfx::TextureHandle m_texDiffuse;
         bgfx::UniformHandle s_texDiffuse;
         bgfx::TextureHandle m_texNormal;
         bgfx::UniformHandle s_texNormal;
         bgfx::TextureHandle m_texAORM;
         bgfx::UniformHandle s_texAORM;
+        ResourceSlot m_texDiffuseSlot;
+        ResourceSlot m_texNormalSlot;
+        ResourceSlot m_texAORMSlot;
+        bgfx::TextureHandle m_texPlaceholder;
+        ResourceCache m_resources;
 
         Mesh *m_skyBoxMesh;
         bgfx::ProgramHandle m_skyBoxProgram;
         bgfx::TextureHandle m_texCube;
-        bgfx::TextureHandle m_texCubeIrr;
         bgfx::UniformHandle s_texCube;
-        bgfx::UniformHandle s_texCubeIrr;
+        bgfx::UniformHandle u_irradianceSh;
+        float m_irradianceSh[Ibl::kNumShCoeffs * 4];
+        bgfx::TextureInfo m_texCubeInfo;
+        bgfx::TextureHandle m_brdfLut;
+        bgfx::UniformHandle s_brdfLut;
 
         bgfx::UniformHandle u_time;
         int64_t m_timeOffset;
+
+        // per frame uniform block, u_irradianceSh, the cluster parameters and the shadow uniforms below are
+        // members of it too
+        bgfx::UniformHandle u_lightPos;
+        bgfx::UniformHandle u_lightColor;
+        bgfx::UniformHandle u_viewPos;
+        bgfx::UniformHandle u_frameParams;
+        bgfx::UniformBlockHandle u_frame;
         int32_t m_pt;
 
         // shadow map related
         Mesh *m_hollowCube;
-        MeshState *m_state[2];
         bgfx::VertexBufferHandle m_planeVbh;
         bgfx::IndexBufferHandle m_planeIbh;
         uint16_t m_shadowMapSize;
+        uint8_t m_numCascades;
+        Shadow::Cascades m_cascades;
+        uint64_t m_shadowPassState;
         bgfx::TextureHandle m_shadowMap;
         bgfx::UniformHandle s_shadowMap;
         bgfx::UniformHandle u_lightMtx;
+        bgfx::UniformHandle u_shadowTiles;
+        bgfx::UniformHandle u_cascadeSplits;
+        bgfx::UniformHandle u_shadowParams;
+        bgfx::UniformHandle s_shadowDepth;
+        bgfx::UniformHandle u_poissonDisk;
+        float m_poissonDisk[Shadow::kNumPoissonSamples * 2];
         bgfx::UniformHandle u_depthScaleOffset;
         bgfx::ProgramHandle m_shadowProgram;
+        bgfx::ProgramHandle m_shadowInstancedProgram;
         bool m_shadowSamplerSupported;
+        bgfx::ProgramHandle m_depthProgram;
+        bgfx::ProgramHandle m_depthInstancedProgram;
         bgfx::FrameBufferHandle m_shadowMapFB;
+        bool m_shadowCacheSupported;
+        bgfx::FrameBufferHandle m_staticShadowMapFB;
+        bool m_staticShadowValid;
+        uint32_t m_staticShadowRevision;
+        float m_staticLightView[Shadow::kMaxViews][16];
+        float m_staticLightProj[Shadow::kMaxViews][16];
+        uint32_t m_numStaticShadowUpdates;
+        // tiles of each atlas that may hold depth from an earlier frame
+        uint8_t m_shadowTilesUsed;
+        uint8_t m_staticShadowTilesUsed;
+        uint32_t m_numShadowTilesDrawn;
+
+        // render list
+        RenderList m_renderList;
+        std::vector<uint32_t> m_visible;
+        std::vector<RenderBatch> m_batches;
+        RenderObject m_pbrStoneObject;
+        RenderObject m_lightObject;
+        RenderObject m_hollowCubeObject;
+        RenderObject m_meshObject;
+        Material m_materials[MaterialId::Count];
+
+        // clustered point lights
+        Lights::ClusteredLights m_clusteredLights;
+        std::vector<Lights::PointLight> m_pointLightBase;
+        std::vector<Lights::PointLight> m_pointLights;
+
+        // hdr scene target, auto exposure and tonemapping
+        Post::ToneMapping m_toneMapping;
 
         // settings
         Settings m_settings;
@@ -0,0 +1,131 @@
+//
+// Image based lighting resources, split-sum specular radiance and its environment BRDF.
+//
+
+#include <bimg/decode.h>
+#include <bimg/encode.h>
+#include <bx/file.h>
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_IBL_H
+#define ESTARHOMEWORK_IBL_H
+
+namespace RenderCore::Ibl {
+    constexpr uint16_t kBrdfLutSize = 128;
+
+    // number of vec4 in u_irradianceSh, three bands of spherical harmonics
+    constexpr uint16_t kNumShCoeffs = 9;
+
+    // texture stage of s_brdfLut in mesh_fs.sc
+    constexpr uint8_t kBrdfLutStage = 10;
+
+    static bimg::ImageContainer *parseImage(const char *_filePath) {
+        bx::FileReaderI *reader = entry::getFileReader();
+        if (!bx::open(reader, _filePath)) {
+            DBG("Failed to open %s.", _filePath);
+            return NULL;
+        }
+
+        bx::AllocatorI *allocator = entry::getAllocator();
+        const uint32_t size = uint32_t(bx::getSize(reader));
+        void *data = BX_ALLOC(allocator, size);
+        bx::read(reader, data, size, bx::ErrorAssert{});
+        bx::close(reader);
+
+        bimg::ImageContainer *image = bimg::imageParse(allocator, data, size);
+        BX_FREE(allocator, data);
+        return image;
+    }
+
+    // Loads a GGX prefiltered radiance cubemap, roughness maps linearly onto its mip chain. Filtering
+    // takes seconds, it's done offline with texturec --radiance GGX -t RGBA16F, a cubemap
+    // without mips is rejected instead of being filtered on load.
+    static bgfx::TextureHandle loadRadiance(const char *_filePath, bgfx::TextureInfo *_info) {
+        bimg::ImageContainer *image = parseImage(_filePath);
+        if (NULL == image) {
+            return BGFX_INVALID_HANDLE;
+        }
+
+        if (!image->m_cubeMap || 1 >= image->m_numMips) {
+            DBG("%s is not a prefiltered radiance cubemap.", _filePath);
+            bimg::imageFree(image);
+            return BGFX_INVALID_HANDLE;
+        }
+
+        const bgfx::TextureFormat::Enum format = bgfx::TextureFormat::Enum(image->m_format);
+        bgfx::TextureHandle handle = bgfx::createTextureCube(
+                uint16_t(image->m_width), 1 < image->m_numMips, image->m_numLayers, format,
+                BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE, bgfx::copy(image->m_data, image->m_size));
+        bgfx::setName(handle, _filePath);
+
+        if (NULL != _info) {
+            bgfx::calcTextureSize(*_info, uint16_t(image->m_width), uint16_t(image->m_height), 1, true,
+                                  1 < image->m_numMips, image->m_numLayers, format);
+        }
+
+        bimg::imageFree(image);
+        return handle;
+    }
+
+    // Projects the cubemap at _filePath onto spherical harmonics for diffuse irradiance, writes
+    // kNumShCoeffs vec4 to _outSh. A 9x1 image is taken as already projected, see texturec --irradiance sh.
+    static bool loadIrradianceSh(const char *_filePath, float *_outSh) {
+        bimg::ImageContainer *image = parseImage(_filePath);
+        if (NULL == image) {
+            return false;
+        }
+
+        bimg::ImageContainer *sh = image;
+        if (image->m_cubeMap) {
+            bx::Error err;
+            sh = bimg::imageCubemapIrradianceSh(entry::getAllocator(), *image, &err);
+            bimg::imageFree(image);
+            if (NULL == sh) {
+                DBG("Failed to project %s.", _filePath);
+                return false;
+            }
+        }
+
+        const bool valid = kNumShCoeffs == sh->m_width && 1 == sh->m_height
+                           && bimg::TextureFormat::RGBA32F == sh->m_format;
+        if (valid) {
+            bx::memCopy(_outSh, sh->m_data, kNumShCoeffs * 4 * sizeof(float));
+        } else {
+            DBG("%s is not a cubemap or 9x1 RGBA32F spherical harmonics.", _filePath);
+        }
+
+        bimg::imageFree(sh);
+        return valid;
+    }
+
+    // scale and bias of F0 by N dot V (u) and roughness (v), the second half of the split sum. Baked
+    // offline with texturec --brdf-lut, integrating it here costs seconds in unoptimized builds.
+    static bgfx::TextureHandle loadBrdfLut(const char *_filePath) {
+        bimg::ImageContainer *lut = parseImage(_filePath);
+        if (NULL != lut && bimg::TextureFormat::RG16F != lut->m_format) {
+            DBG("%s is not a RG16F BRDF LUT.", _filePath);
+            bimg::imageFree(lut);
+            lut = NULL;
+        }
+
+        if (NULL == lut) {
+            DBG("Integrating the BRDF LUT at startup.");
+            bx::Error err;
+            lut = bimg::imageBrdfLutGgx(entry::getAllocator(), kBrdfLutSize, &err);
+            if (NULL == lut) {
+                return BGFX_INVALID_HANDLE;
+            }
+        }
+
+        bgfx::TextureHandle handle = bgfx::createTexture2D(
+                uint16_t(lut->m_width), uint16_t(lut->m_height), false, 1, bgfx::TextureFormat::RG16F,
+                BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP, bgfx::copy(lut->m_data, lut->m_size));
+        bgfx::setName(handle, "brdf_lut");
+
+        bimg::imageFree(lut);
+        return handle;
+    }
+}
+
+#endif //ESTARHOMEWORK_IBL_H
@@ -0,0 +1,67 @@
+//
+// Point light shadow faces, the six cube faces laid out as tiles of the shadow atlas.
+//
+
+#include "common.h"
+#include "bgfx_utils.h"
+#include "cascaded_shadow.h"
+
+#ifndef ESTARHOMEWORK_OMNI_SHADOW_H
+#define ESTARHOMEWORK_OMNI_SHADOW_H
+
+namespace RenderCore::Shadow {
+    constexpr uint8_t kNumOmniFaces = 6;
+
+    // depth range of the point light faces
+    constexpr float kOmniNear = 0.5f;
+    constexpr float kOmniFar = 100.0f;
+
+    // texels each face extends past its 90 degree frustum, so filter taps near a face edge
+    // still read depth rendered by that face
+    constexpr uint16_t kOmniBorder = 16;
+
+    // face order must match omniFace in mesh_fs.sc: +x, -x, +y, -y, +z, -z
+    static void updateOmni(Cascades &_cascades, uint16_t _faceSize, const bx::Vec3 &_lightPos) {
+        const bgfx::Caps *caps = bgfx::getCaps();
+
+        static const bx::Vec3 s_dirs[kNumOmniFaces] = {
+                {1.0f, 0.0f, 0.0f},
+                {-1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, -1.0f},
+        };
+        static const bx::Vec3 s_ups[kNumOmniFaces] = {
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, 0.0f, -1.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+        };
+
+        uint8_t cols, rows;
+        atlasLayout(kNumOmniFaces, cols, rows);
+
+        _cascades.m_numCascades = kNumOmniFaces;
+        _cascades.m_cascadeSize = _faceSize;
+        _cascades.m_atlasWidth = uint16_t(_faceSize * cols);
+        _cascades.m_atlasHeight = uint16_t(_faceSize * rows);
+
+        for (uint8_t ii = 0; ii < kMaxCascades; ++ii) {
+            _cascades.m_splits[ii] = kOmniFar;
+        }
+
+        const float fovy = bx::toDeg(2.0f * bx::atan(float(_faceSize) / float(_faceSize - 2 * kOmniBorder)));
+        for (uint8_t ii = 0; ii < kNumOmniFaces; ++ii) {
+            bx::mtxLookAt(_cascades.m_lightView[ii], _lightPos, bx::add(_lightPos, s_dirs[ii]), s_ups[ii]);
+            bx::mtxProj(_cascades.m_lightProj[ii], fovy, 1.0f, kOmniNear, kOmniFar, caps->homogeneousDepth);
+            placeTile(_cascades, ii, cols, rows);
+        }
+
+        fillUnusedTiles(_cascades);
+    }
+}
+
+#endif //ESTARHOMEWORK_OMNI_SHADOW_H
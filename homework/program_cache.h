@@ -0,0 +1,147 @@
+//
+// Shader permutations of the mesh program, selected by a feature bitmask.
+//
+
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_PROGRAM_CACHE_H
+#define ESTARHOMEWORK_PROGRAM_CACHE_H
+
+namespace RenderCore {
+
+    // bit order must match MESH_FS_FEATURES in cmake/homework.cmake
+    namespace MeshFeature {
+        enum Enum : uint16_t {
+            PbrMaps = 1 << 0,
+            BlinnPhong = 1 << 1,
+            PBR = 1 << 2,
+            DiffuseIBL = 1 << 3,
+            SpecularIBL = 1 << 4,
+            ShadowMap = 1 << 5,
+            PCSS = 1 << 6,
+            ShadowPackedDepth = 1 << 7,
+            // the mesh has a geometryc --tangentframe quaternion instead of a normal, selects the vertex shader
+            VertexTangents = 1 << 8,
+            // shadow of the point light from the six cube faces instead of the cascades
+            PointShadow = 1 << 9,
+        };
+
+        constexpr uint32_t Count = 1 << 10;
+
+        // drops features that have no effect so every mask maps to a compiled variant
+        inline uint16_t sanitize(uint16_t _features) {
+            if (0 != (_features & BlinnPhong)) {
+                _features &= ~PBR;
+            }
+
+            if (0 == (_features & ShadowMap)) {
+                _features &= ~(PCSS | ShadowPackedDepth | PointShadow);
+            }
+
+            // the blocker search assumes linear depth, point light faces store perspective depth
+            if (0 != (_features & PointShadow)) {
+                _features &= ~PCSS;
+            }
+
+            return _features;
+        }
+
+        // features implied by the vertex attributes of a mesh
+        inline uint16_t fromLayout(const bgfx::VertexLayout &_layout) {
+            const bool tangentFrame = _layout.has(bgfx::Attrib::Tangent) && !_layout.has(bgfx::Attrib::Normal);
+            return tangentFrame ? VertexTangents : 0;
+        }
+    }
+
+    // Programs are created on first use, so only the permutations that are actually
+    // drawn get loaded. The vertex shader is shared by all fragment shader variants of
+    // the same vertex format, <vsName>_tangent decodes the packed tangent frame. A variant
+    // whose binary is missing is reported once and drawn with the variant that only has
+    // the vertex format features instead.
+    class ProgramCache {
+    public:
+        void init(const char *_vsName, const char *_fsName) {
+            bx::strCopy(m_vsName, BX_COUNTOF(m_vsName), _vsName);
+            bx::strCopy(m_fsName, BX_COUNTOF(m_fsName), _fsName);
+            m_vsh = loadShader(_vsName);
+            m_tangentVsh = BGFX_INVALID_HANDLE;
+            for (uint32_t ii = 0; ii < MeshFeature::Count; ++ii) {
+                m_programs[ii] = BGFX_INVALID_HANDLE;
+                m_missing[ii] = false;
+            }
+        }
+
+        bgfx::ProgramHandle get(uint16_t _features) {
+            const uint16_t features = MeshFeature::sanitize(_features);
+            bgfx::ProgramHandle &program = m_programs[features];
+
+            if (!bgfx::isValid(program) && !m_missing[features]) {
+                char fsName[128];
+                bx::snprintf(fsName, BX_COUNTOF(fsName), "%s_%d", m_fsName, features);
+
+                // the program keeps its own reference to both shaders
+                const bgfx::ShaderHandle vsh = vertexShader(features);
+                const bgfx::ShaderHandle fsh = loadShader(fsName);
+                if (bgfx::isValid(vsh) && bgfx::isValid(fsh)) {
+                    program = bgfx::createProgram(vsh, fsh, false);
+                }
+                if (bgfx::isValid(fsh)) {
+                    bgfx::destroy(fsh);
+                }
+
+                if (!bgfx::isValid(program)) {
+                    m_missing[features] = true;
+                    DBG("Error: mesh program variant %s can't be created, falling back to %s_%d.",
+                        fsName, m_fsName, features & MeshFeature::VertexTangents);
+                }
+            }
+
+            if (!bgfx::isValid(program)) {
+                const uint16_t fallback = features & MeshFeature::VertexTangents;
+                return fallback != features ? get(fallback) : program;
+            }
+
+            return program;
+        }
+
+        void destroy() {
+            for (uint32_t ii = 0; ii < MeshFeature::Count; ++ii) {
+                if (bgfx::isValid(m_programs[ii])) {
+                    bgfx::destroy(m_programs[ii]);
+                    m_programs[ii] = BGFX_INVALID_HANDLE;
+                }
+            }
+
+            if (bgfx::isValid(m_vsh)) {
+                bgfx::destroy(m_vsh);
+            }
+            if (bgfx::isValid(m_tangentVsh)) {
+                bgfx::destroy(m_tangentVsh);
+            }
+        }
+
+    private:
+        bgfx::ShaderHandle vertexShader(uint16_t _features) {
+            if (0 == (_features & MeshFeature::VertexTangents)) {
+                return m_vsh;
+            }
+
+            if (!bgfx::isValid(m_tangentVsh)) {
+                char vsName[128];
+                bx::snprintf(vsName, BX_COUNTOF(vsName), "%s_tangent", m_vsName);
+                m_tangentVsh = loadShader(vsName);
+            }
+            return m_tangentVsh;
+        }
+
+        char m_vsName[64];
+        char m_fsName[64];
+        bgfx::ShaderHandle m_vsh;
+        bgfx::ShaderHandle m_tangentVsh;
+        bgfx::ProgramHandle m_programs[MeshFeature::Count];
+        bool m_missing[MeshFeature::Count];
+    };
+}
+
+#endif //ESTARHOMEWORK_PROGRAM_CACHE_H
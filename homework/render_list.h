@@ -0,0 +1,376 @@
+//
+// Structure of arrays render list, culled per view and submitted in one loop per pass.
+//
+
+#include <vector>
+#include <bx/sort.h>
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_RENDER_LIST_H
+#define ESTARHOMEWORK_RENDER_LIST_H
+
+namespace RenderCore {
+
+    namespace RenderFlags {
+        enum Enum : uint8_t {
+            Enabled = 1 << 0,
+            CastShadow = 1 << 1,
+            // moves every frame, kept out of cached static shadows
+            Dynamic = 1 << 2,
+        };
+    }
+
+    // an object is a contiguous range of draw items, one item per mesh group
+    struct RenderObject {
+        uint32_t m_first;
+        uint32_t m_num;
+    };
+
+    // a run of visible items sharing material and geometry, drawn with a single instanced draw
+    struct RenderBatch {
+        uint32_t m_first;
+        uint32_t m_num;
+    };
+
+    // Every draw item stores its transform, bounds, geometry and material id in separate
+    // arrays so the culling loop only touches the world space bounding spheres and flags.
+    class RenderList {
+    public:
+        void reserve(uint32_t _num) {
+            m_transforms.reserve(_num * 16);
+            m_localSpheres.reserve(_num * 4);
+            m_centerX.reserve(_num);
+            m_centerY.reserve(_num);
+            m_centerZ.reserve(_num);
+            m_radius.reserve(_num);
+            m_scale.reserve(_num);
+            m_lodFirst.reserve(_num);
+            m_numLods.reserve(_num);
+            m_lod.reserve(_num);
+            m_vbh.reserve(_num);
+            m_ibh.reserve(_num);
+            m_materials.reserve(_num);
+            m_flags.reserve(_num);
+        }
+
+        void clear() {
+            m_transforms.clear();
+            m_localSpheres.clear();
+            m_centerX.clear();
+            m_centerY.clear();
+            m_centerZ.clear();
+            m_radius.clear();
+            m_scale.clear();
+            m_lodFirst.clear();
+            m_numLods.clear();
+            m_lod.clear();
+            m_lodIbh.clear();
+            m_lodError.clear();
+            m_vbh.clear();
+            m_ibh.clear();
+            m_materials.clear();
+            m_flags.clear();
+            m_numUploaded = 0;
+            ++m_staticRevision;
+        }
+
+        RenderObject add(bgfx::VertexBufferHandle _vbh, bgfx::IndexBufferHandle _ibh, const bx::Sphere &_sphere,
+                         uint16_t _material, uint8_t _flags, const float *_mtx) {
+            const RenderObject object = {size(), 1};
+            push(_vbh, _ibh, _sphere, _material, _flags, NULL, 0);
+            setTransform(object, _mtx);
+            return object;
+        }
+
+        RenderObject add(const Mesh *_mesh, uint16_t _material, uint8_t _flags, const float *_mtx) {
+            const RenderObject object = {size(), uint32_t(_mesh->m_groups.size())};
+            for (GroupArray::const_iterator it = _mesh->m_groups.begin(), itEnd = _mesh->m_groups.end();
+                 it != itEnd; ++it) {
+                push(it->m_vbh, it->m_ibh, it->m_sphere, _material, _flags, it->m_lods.data(),
+                     uint32_t(it->m_lods.size()));
+            }
+            setTransform(object, _mtx);
+            return object;
+        }
+
+        // also moves the world space bounding spheres, so culling never transforms bounds
+        void setTransform(const RenderObject &_object, const float *_mtx) {
+            const float scale = bx::sqrt(bx::max(
+                    _mtx[0] * _mtx[0] + _mtx[1] * _mtx[1] + _mtx[2] * _mtx[2],
+                    _mtx[4] * _mtx[4] + _mtx[5] * _mtx[5] + _mtx[6] * _mtx[6],
+                    _mtx[8] * _mtx[8] + _mtx[9] * _mtx[9] + _mtx[10] * _mtx[10]));
+
+            for (uint32_t ii = _object.m_first, end = _object.m_first + _object.m_num; ii < end; ++ii) {
+                float *transform = &m_transforms[ii * 16];
+                if (0 == (m_flags[ii] & RenderFlags::Dynamic) && 0 != bx::memCmp(transform, _mtx, 16 * sizeof(float))) {
+                    ++m_staticRevision;
+                }
+                bx::memCopy(transform, _mtx, 16 * sizeof(float));
+
+                const float *local = &m_localSpheres[ii * 4];
+                const bx::Vec3 center = bx::mul(bx::Vec3(local[0], local[1], local[2]), _mtx);
+                m_centerX[ii] = center.x;
+                m_centerY[ii] = center.y;
+                m_centerZ[ii] = center.z;
+                m_radius[ii] = local[3] * scale;
+                m_scale[ii] = scale;
+            }
+        }
+
+        void setFlags(const RenderObject &_object, uint8_t _flags, bool _enabled) {
+            for (uint32_t ii = _object.m_first, end = _object.m_first + _object.m_num; ii < end; ++ii) {
+                const uint8_t flags = _enabled ? uint8_t(m_flags[ii] | _flags) : uint8_t(m_flags[ii] & ~_flags);
+                if (flags != m_flags[ii] && 0 == (flags & RenderFlags::Dynamic)) {
+                    ++m_staticRevision;
+                }
+                m_flags[ii] = flags;
+            }
+        }
+
+        // copies every transform into the frame's matrix cache once, draws of all passes then
+        // reference the cached matrix instead of uploading it again per view. A single allocation
+        // holds at most UINT16_MAX matrices so the list is uploaded in chunks, items that don't fit
+        // into the cache any more are left out of culling.
+        void upload() {
+            m_transformCache.clear();
+            m_numUploaded = 0;
+
+            while (m_numUploaded < size()) {
+                const uint16_t num = uint16_t(bx::min<uint32_t>(size() - m_numUploaded, kTransformChunk));
+
+                bgfx::Transform transform;
+                const uint32_t first = bgfx::allocTransform(&transform, num);
+                if (0 == transform.num) {
+                    break;
+                }
+
+                m_transformCache.push_back(first);
+                bx::memCopy(transform.data, &m_transforms[m_numUploaded * 16], transform.num * 16 * sizeof(float));
+                m_numUploaded += transform.num;
+
+                if (transform.num < num) {
+                    break;
+                }
+            }
+
+            if (m_numUploaded < size() && m_numUploaded != m_numWarned) {
+                DBG("Warning: the matrix cache holds %u of %u render list transforms, the rest isn't drawn. "
+                    "Raise it with --max-matrix-cache.", m_numUploaded, size());
+            }
+            m_numWarned = m_numUploaded < size() ? m_numUploaded : UINT32_MAX;
+        }
+
+        // writes the indices of the items whose flags contain _flags but none of _exclude and whose bounding
+        // sphere touches the frustum of _viewProj, branch free so the loop stays cheap for large lists
+        uint32_t cull(uint32_t *_visible, const float *_viewProj, uint8_t _flags, uint8_t _exclude = 0) const {
+            bx::Plane planes[6] = {bx::init::None, bx::init::None, bx::init::None,
+                                   bx::init::None, bx::init::None, bx::init::None};
+            bx::buildFrustumPlanes(planes, _viewProj);
+
+            uint32_t num = 0;
+            for (uint32_t ii = 0; ii < m_numUploaded; ++ii) {
+                const float xx = m_centerX[ii];
+                const float yy = m_centerY[ii];
+                const float zz = m_centerZ[ii];
+
+                float distance = bx::kFloatMax;
+                for (uint32_t pp = 0; pp < 6; ++pp) {
+                    const bx::Plane &plane = planes[pp];
+                    distance = bx::min(distance, plane.normal.x * xx + plane.normal.y * yy + plane.normal.z * zz +
+                                                 plane.dist);
+                }
+
+                const bool inside = distance >= -m_radius[ii];
+                const bool flagged = (m_flags[ii] & _flags) == _flags && 0 == (m_flags[ii] & _exclude);
+                _visible[num] = ii;
+                num += uint32_t(inside & flagged);
+            }
+
+            return num;
+        }
+
+        // picks the level of detail of every culled item for the view, the coarsest level whose geometric
+        // error projected at the near side of the bounding sphere stays within _maxPixels, _pixelScale is
+        // the projection's y scale times half the view height. Batching and submission use the levels
+        // picked by the last call, so every pass selects after it culls.
+        void selectLods(const uint32_t *_visible, uint32_t _num, const float *_viewProj, float _pixelScale,
+                        float _maxPixels) {
+            // clip space w grows along this axis, it is zero for orthographic projections
+            const float wScale = bx::length(bx::Vec3(_viewProj[3], _viewProj[7], _viewProj[11]));
+
+            for (uint32_t ii = 0; ii < _num; ++ii) {
+                const uint32_t item = _visible[ii];
+                uint8_t lod = m_numLods[item];
+                if (0 != lod) {
+                    const float ww = _viewProj[3] * m_centerX[item] + _viewProj[7] * m_centerY[item] +
+                                     _viewProj[11] * m_centerZ[item] + _viewProj[15];
+                    const float pixelsPerUnit = m_scale[item] * _pixelScale /
+                                                bx::max(ww - m_radius[item] * wScale, bx::kFloatMin);
+
+                    const float *errors = &m_lodError[m_lodFirst[item]];
+                    while (0 != lod && errors[lod - 1] * pixelsPerUnit > _maxPixels) {
+                        --lod;
+                    }
+                }
+
+                m_lod[item] = lod;
+            }
+        }
+
+        // sorts the culled items so items with the same material and geometry are adjacent and
+        // writes one batch per run, batches index into the reordered _visible
+        uint32_t batch(RenderBatch *_batches, uint32_t *_visible, uint32_t _numVisible) {
+            m_sortKeys.resize(_numVisible);
+            m_sortTempKeys.resize(_numVisible);
+            m_sortTempItems.resize(_numVisible);
+
+            for (uint32_t ii = 0; ii < _numVisible; ++ii) {
+                const uint32_t item = _visible[ii];
+                m_sortKeys[ii] = 0
+                                 | uint64_t(m_materials[item]) << 32
+                                 | uint64_t(m_vbh[item].idx) << 16
+                                 | uint64_t(indexBuffer(item).idx);
+            }
+
+            bx::radixSort(m_sortKeys.data(), m_sortTempKeys.data(), _visible, m_sortTempItems.data(), _numVisible);
+
+            uint32_t numBatches = 0;
+            for (uint32_t ii = 0; ii < _numVisible;) {
+                uint32_t end = ii + 1;
+                while (end < _numVisible && m_sortKeys[end] == m_sortKeys[ii]) {
+                    ++end;
+                }
+
+                _batches[numBatches++] = {ii, end - ii};
+                ii = end;
+            }
+
+            return numBatches;
+        }
+
+        // view space distance to the nearest bounding sphere of _num items, as bits that sort like
+        // the float, for bgfx::ViewMode::DepthAscending
+        uint32_t sortDepth(const uint32_t *_items, uint32_t _num, const float *_view) const {
+            float depth = bx::kFloatMax;
+            for (uint32_t ii = 0; ii < _num; ++ii) {
+                const uint32_t item = _items[ii];
+                const float zz = _view[2] * m_centerX[item] + _view[6] * m_centerY[item] +
+                                 _view[10] * m_centerZ[item] + _view[14];
+                depth = bx::min(depth, zz - m_radius[item]);
+            }
+
+            return bx::floatToBits(bx::max(depth, 0.0f));
+        }
+
+        // gathers the transforms of up to _num items sharing geometry into instance data and sets
+        // it with their geometry, returns the number of items the next draw covers, 0 if none fit
+        uint32_t setInstancedGeometry(const uint32_t *_items, uint32_t _num) const {
+            bgfx::InstanceDataBuffer idb;
+            const uint32_t num = instanceDataAlloc(&idb, _num);
+            if (0 == num) {
+                return 0;
+            }
+
+            float *data = reinterpret_cast<float *>(idb.data);
+            for (uint32_t ii = 0; ii < num; ++ii) {
+                bx::memCopy(&data[ii * 16], &m_transforms[_items[ii] * 16], 16 * sizeof(float));
+            }
+
+            bgfx::setInstanceDataBuffer(&idb);
+            bgfx::setVertexBuffer(0, m_vbh[_items[0]]);
+            bgfx::setIndexBuffer(indexBuffer(_items[0]));
+            return num;
+        }
+
+        // sets the cached transform and geometry of an item, state and program are up to the pass
+        void setGeometry(uint32_t _item) const {
+            bgfx::setTransform(m_transformCache[_item / kTransformChunk] + _item % kTransformChunk);
+            bgfx::setVertexBuffer(0, m_vbh[_item]);
+            bgfx::setIndexBuffer(indexBuffer(_item));
+        }
+
+        uint16_t material(uint32_t _item) const {
+            return m_materials[_item];
+        }
+
+        uint32_t size() const {
+            return uint32_t(m_vbh.size());
+        }
+
+        // changes whenever an item that is not dynamic is added, moved or flagged differently
+        uint32_t staticRevision() const {
+            return m_staticRevision;
+        }
+
+    private:
+        // full resolution indices, or the simplified level picked by selectLods
+        bgfx::IndexBufferHandle indexBuffer(uint32_t _item) const {
+            const uint8_t lod = m_lod[_item];
+            return 0 != lod ? m_lodIbh[m_lodFirst[_item] + lod - 1] : m_ibh[_item];
+        }
+
+        void push(bgfx::VertexBufferHandle _vbh, bgfx::IndexBufferHandle _ibh, const bx::Sphere &_sphere,
+                  uint16_t _material, uint8_t _flags, const GroupLod *_lods, uint32_t _numLods) {
+            m_transforms.resize(m_transforms.size() + 16);
+            m_localSpheres.push_back(_sphere.center.x);
+            m_localSpheres.push_back(_sphere.center.y);
+            m_localSpheres.push_back(_sphere.center.z);
+            m_localSpheres.push_back(_sphere.radius);
+            m_centerX.push_back(0.0f);
+            m_centerY.push_back(0.0f);
+            m_centerZ.push_back(0.0f);
+            m_radius.push_back(0.0f);
+            m_scale.push_back(1.0f);
+            m_lodFirst.push_back(uint32_t(m_lodIbh.size()));
+            m_numLods.push_back(uint8_t(bx::min<uint32_t>(_numLods, UINT8_MAX)));
+            m_lod.push_back(0);
+            for (uint32_t ii = 0; ii < m_numLods.back(); ++ii) {
+                m_lodIbh.push_back(_lods[ii].m_ibh);
+                m_lodError.push_back(_lods[ii].m_error);
+            }
+            m_vbh.push_back(_vbh);
+            m_ibh.push_back(_ibh);
+            m_materials.push_back(_material);
+            m_flags.push_back(_flags);
+        }
+
+        // cold data, only touched when an object moves
+        std::vector<float> m_transforms;
+        std::vector<float> m_localSpheres;
+
+        // hot data, read by every cull
+        std::vector<float> m_centerX;
+        std::vector<float> m_centerY;
+        std::vector<float> m_centerZ;
+        std::vector<float> m_radius;
+        std::vector<uint8_t> m_flags;
+
+        // read by level of detail selection of visible items only, levels are ordered fine to coarse
+        std::vector<float> m_scale;
+        std::vector<uint32_t> m_lodFirst;
+        std::vector<uint8_t> m_numLods;
+        std::vector<float> m_lodError;
+
+        // read by submission of visible items only
+        std::vector<bgfx::VertexBufferHandle> m_vbh;
+        std::vector<bgfx::IndexBufferHandle> m_ibh;
+        std::vector<bgfx::IndexBufferHandle> m_lodIbh;
+        std::vector<uint8_t> m_lod;
+        std::vector<uint16_t> m_materials;
+
+        // scratch for batch
+        std::vector<uint64_t> m_sortKeys;
+        std::vector<uint64_t> m_sortTempKeys;
+        std::vector<uint32_t> m_sortTempItems;
+
+        // first matrix cache index of every uploaded chunk of transforms
+        static constexpr uint32_t kTransformChunk = 32 << 10;
+        std::vector<uint32_t> m_transformCache;
+        uint32_t m_numUploaded = 0;
+        uint32_t m_numWarned = UINT32_MAX;
+        uint32_t m_staticRevision = 0;
+    };
+}
+
+#endif //ESTARHOMEWORK_RENDER_LIST_H
@@ -0,0 +1,414 @@
+//
+// Reference counted mesh and texture cache on top of the async loader.
+//
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <bx/handlealloc.h>
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_RESOURCE_CACHE_H
+#define ESTARHOMEWORK_RESOURCE_CACHE_H
+
+namespace RenderCore {
+
+    struct ResourceHandle {
+        uint16_t idx;
+    };
+
+    inline bool isValid(ResourceHandle _handle) {
+        return UINT16_MAX != _handle.idx;
+    }
+
+    constexpr ResourceHandle kInvalidResource = {UINT16_MAX};
+
+    struct ResourceResidency {
+        uint32_t m_numResident;
+        uint32_t m_numReferenced;
+        uint32_t m_numPending;
+        uint32_t m_numEvicted;
+        uint64_t m_cpuBytes;
+        uint64_t m_gpuBytes;
+        uint64_t m_cpuBudget;
+        uint64_t m_gpuBudget;
+    };
+
+    // Handles name a canonical path (plus texture flags). Paths are deduplicated on request,
+    // files with equal contents are deduplicated once their load finished, in which case both
+    // paths share one resource. Unreferenced resources stay resident until the memory budget
+    // is exceeded, then the least recently used ones are destroyed first.
+    class ResourceCache {
+    public:
+        static constexpr uint16_t kMaxResources = 256;
+
+        void init(uint64_t _cpuBudget, uint64_t _gpuBudget) {
+            m_cpuBudget = _cpuBudget;
+            m_gpuBudget = _gpuBudget;
+            m_cpuBytes = 0;
+            m_gpuBytes = 0;
+            m_numEvicted = 0;
+            m_frame = 0;
+        }
+
+        void shutdown() {
+            while (0 < m_entryAlloc.getNumHandles()) {
+                freeEntry(m_entryAlloc.getHandleAt(0));
+            }
+
+            while (0 < m_resourceAlloc.getNumHandles()) {
+                destroyResource(m_resourceAlloc.getHandleAt(0));
+            }
+        }
+
+        void setBudget(uint64_t _cpuBudget, uint64_t _gpuBudget) {
+            m_cpuBudget = _cpuBudget;
+            m_gpuBudget = _gpuBudget;
+        }
+
+        // returns a referenced handle, loading the file in the background if it isn't resident
+        ResourceHandle loadMesh(const char *_filePath) {
+            return load(Type::Mesh, _filePath, 0);
+        }
+
+        ResourceHandle loadTexture(const char *_filePath, uint64_t _flags = BGFX_TEXTURE_NONE | BGFX_SAMPLER_NONE) {
+            return load(Type::Texture, _filePath, _flags);
+        }
+
+        void acquire(ResourceHandle _handle) {
+            Entry &entry = m_entries[_handle.idx];
+            ++entry.m_refs;
+            Resource &resource = m_resources[entry.m_resource];
+            ++resource.m_refs;
+            resource.m_lastUsed = m_frame;
+        }
+
+        void release(ResourceHandle _handle) {
+            if (!isValid(_handle)) {
+                return;
+            }
+
+            Entry &entry = m_entries[_handle.idx];
+            BX_ASSERT(0 < entry.m_refs, "Releasing an unreferenced resource.");
+            --entry.m_refs;
+            Resource &resource = m_resources[entry.m_resource];
+            --resource.m_refs;
+            resource.m_lastUsed = m_frame;
+        }
+
+        // finishes loads and enforces the budget, call once per frame after asyncLoadUpdate
+        void update() {
+            ++m_frame;
+
+            for (uint16_t ii = 0; ii < m_resourceAlloc.getNumHandles(); ++ii) {
+                const uint16_t idx = m_resourceAlloc.getHandleAt(ii);
+                if (AsyncLoadStatus::Pending == m_resources[idx].m_status) {
+                    finishLoad(idx);
+                }
+            }
+
+            evict();
+        }
+
+        AsyncLoadStatus::Enum status(ResourceHandle _handle) const {
+            return isValid(_handle) ? m_resources[m_entries[_handle.idx].m_resource].m_status
+                                    : AsyncLoadStatus::Invalid;
+        }
+
+        // the accessors count as a use, a resource that is still drawn from isn't the least recently used
+        Mesh *mesh(ResourceHandle _handle, Mesh *_placeholder) {
+            if (AsyncLoadStatus::Ready != status(_handle)) {
+                return _placeholder;
+            }
+
+            Resource &resource = m_resources[m_entries[_handle.idx].m_resource];
+            resource.m_lastUsed = m_frame;
+            return resource.m_mesh;
+        }
+
+        bgfx::TextureHandle texture(ResourceHandle _handle, bgfx::TextureHandle _placeholder) {
+            if (AsyncLoadStatus::Ready != status(_handle)) {
+                return _placeholder;
+            }
+
+            Resource &resource = m_resources[m_entries[_handle.idx].m_resource];
+            resource.m_lastUsed = m_frame;
+            return resource.m_texture;
+        }
+
+        ResourceResidency residency() const {
+            ResourceResidency residency = {};
+            for (uint16_t ii = 0; ii < m_resourceAlloc.getNumHandles(); ++ii) {
+                const Resource &resource = m_resources[m_resourceAlloc.getHandleAt(ii)];
+                residency.m_numResident += AsyncLoadStatus::Ready == resource.m_status;
+                residency.m_numPending += AsyncLoadStatus::Pending == resource.m_status;
+                residency.m_numReferenced += 0 < resource.m_refs;
+            }
+            residency.m_numEvicted = m_numEvicted;
+            residency.m_cpuBytes = m_cpuBytes;
+            residency.m_gpuBytes = m_gpuBytes;
+            residency.m_cpuBudget = m_cpuBudget;
+            residency.m_gpuBudget = m_gpuBudget;
+            return residency;
+        }
+
+    private:
+        struct Type {
+            enum Enum : uint8_t {
+                Mesh,
+                Texture,
+            };
+        };
+
+        struct Resource {
+            std::string m_filePath;
+            Type::Enum m_type;
+            AsyncLoadStatus::Enum m_status;
+            AsyncLoadHandle m_load;
+            uint64_t m_flags;
+            uint32_t m_hash;
+            uint32_t m_refs;
+            uint32_t m_lastUsed;
+            uint32_t m_cpuSize;
+            uint32_t m_gpuSize;
+            Mesh *m_mesh;
+            bgfx::TextureHandle m_texture;
+        };
+
+        // one per requested path, handles given out are entry indices
+        struct Entry {
+            std::string m_key;
+            uint32_t m_refs;
+            uint16_t m_resource;
+        };
+
+        static std::string canonicalKey(Type::Enum _type, const char *_filePath, uint64_t _flags) {
+            std::error_code ec;
+            const std::filesystem::path path = std::filesystem::weakly_canonical(_filePath, ec);
+            std::string key = ec ? std::string(_filePath) : path.generic_string();
+
+            char suffix[32];
+            bx::snprintf(suffix, BX_COUNTOF(suffix), "|%d|%016llx", _type, (unsigned long long) _flags);
+            return key + suffix;
+        }
+
+        ResourceHandle load(Type::Enum _type, const char *_filePath, uint64_t _flags) {
+            const std::string key = canonicalKey(_type, _filePath, _flags);
+
+            std::unordered_map<std::string, uint16_t>::const_iterator it = m_paths.find(key);
+            if (it != m_paths.end()) {
+                const uint16_t entryIdx = it->second;
+                const uint16_t resourceIdx = m_entries[entryIdx].m_resource;
+
+                // an unused failed load is retried, the file may have been fixed in the meantime
+                if (AsyncLoadStatus::Failed != m_resources[resourceIdx].m_status || 0 < m_entries[entryIdx].m_refs) {
+                    const ResourceHandle handle = {entryIdx};
+                    acquire(handle);
+                    return handle;
+                }
+
+                freeEntry(entryIdx);
+                if (0 == m_resources[resourceIdx].m_refs) {
+                    destroyResource(resourceIdx);
+                }
+            }
+
+            const uint16_t resourceIdx = m_resourceAlloc.alloc();
+            const uint16_t entryIdx = m_entryAlloc.alloc();
+            if (bx::kInvalidHandle == resourceIdx || bx::kInvalidHandle == entryIdx) {
+                if (bx::kInvalidHandle != resourceIdx) {
+                    m_resourceAlloc.free(resourceIdx);
+                }
+                if (bx::kInvalidHandle != entryIdx) {
+                    m_entryAlloc.free(entryIdx);
+                }
+                DBG("Resource cache is full, can't load %s.", _filePath);
+                return kInvalidResource;
+            }
+
+            Resource &resource = m_resources[resourceIdx];
+            resource.m_filePath = _filePath;
+            resource.m_type = _type;
+            resource.m_status = AsyncLoadStatus::Pending;
+            resource.m_load = Type::Mesh == _type ? meshLoadAsync(_filePath) : loadTextureAsync(_filePath, _flags);
+            resource.m_flags = _flags;
+            resource.m_hash = 0;
+            resource.m_refs = 0;
+            resource.m_lastUsed = m_frame;
+            resource.m_cpuSize = 0;
+            resource.m_gpuSize = 0;
+            resource.m_mesh = NULL;
+            resource.m_texture = BGFX_INVALID_HANDLE;
+
+            Entry &entry = m_entries[entryIdx];
+            entry.m_key = key;
+            entry.m_refs = 0;
+            entry.m_resource = resourceIdx;
+            m_paths[key] = entryIdx;
+
+            const ResourceHandle handle = {entryIdx};
+            acquire(handle);
+            return handle;
+        }
+
+        void finishLoad(uint16_t _resourceIdx) {
+            Resource &resource = m_resources[_resourceIdx];
+            const AsyncLoadStatus::Enum status = asyncLoadStatus(resource.m_load);
+            if (AsyncLoadStatus::Pending == status) {
+                return;
+            }
+
+            if (AsyncLoadStatus::Ready == status) {
+                resource.m_hash = asyncLoadHash(resource.m_load);
+                if (Type::Mesh == resource.m_type) {
+                    resource.m_mesh = asyncLoadMesh(resource.m_load, NULL);
+                    for (GroupArray::const_iterator it = resource.m_mesh->m_groups.begin(),
+                                 itEnd = resource.m_mesh->m_groups.end(); it != itEnd; ++it) {
+                        const uint32_t indexSize = it->m_index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+                        uint32_t size = it->m_numVertices * resource.m_mesh->m_layout.getStride()
+                                        + it->m_numIndices * indexSize;
+                        for (GroupLodArray::const_iterator lodIt = it->m_lods.begin(), lodEnd = it->m_lods.end();
+                             lodIt != lodEnd; ++lodIt) {
+                            size += lodIt->m_numIndices * indexSize;
+                        }
+                        resource.m_gpuSize += size;
+                        resource.m_cpuSize += NULL != it->m_vertices ? size : 0;
+                    }
+                } else {
+                    bgfx::TextureInfo info;
+                    resource.m_texture = asyncLoadTexture(resource.m_load, BGFX_INVALID_HANDLE, &info);
+                    resource.m_gpuSize = info.storageSize;
+                }
+            }
+
+            asyncLoadFree(resource.m_load);
+            resource.m_status = AsyncLoadStatus::Ready == status ? AsyncLoadStatus::Ready : AsyncLoadStatus::Failed;
+            m_cpuBytes += resource.m_cpuSize;
+            m_gpuBytes += resource.m_gpuSize;
+
+            if (AsyncLoadStatus::Ready == resource.m_status) {
+                dedupe(_resourceIdx);
+            }
+        }
+
+        // points the entries of a freshly loaded resource at an older resource with the same contents
+        void dedupe(uint16_t _resourceIdx) {
+            const Resource &resource = m_resources[_resourceIdx];
+            for (uint16_t ii = 0; ii < m_resourceAlloc.getNumHandles(); ++ii) {
+                const uint16_t idx = m_resourceAlloc.getHandleAt(ii);
+                Resource &other = m_resources[idx];
+                if (idx == _resourceIdx
+                    || AsyncLoadStatus::Ready != other.m_status
+                    || other.m_type != resource.m_type
+                    || other.m_flags != resource.m_flags
+                    || other.m_hash != resource.m_hash
+                    || !sameContents(other.m_filePath.c_str(), resource.m_filePath.c_str())) {
+                    continue;
+                }
+
+                for (uint16_t jj = 0; jj < m_entryAlloc.getNumHandles(); ++jj) {
+                    Entry &entry = m_entries[m_entryAlloc.getHandleAt(jj)];
+                    if (_resourceIdx == entry.m_resource) {
+                        entry.m_resource = idx;
+                    }
+                }
+
+                other.m_refs += resource.m_refs;
+                other.m_lastUsed = m_frame;
+                destroyResource(_resourceIdx);
+                return;
+            }
+        }
+
+        // the 32-bit hash only finds candidates, files are shared once their bytes compare equal
+        static bool sameContents(const char *_filePathA, const char *_filePathB) {
+            uint32_t sizeA = 0;
+            void *dataA = ::load(_filePathA, &sizeA);
+            uint32_t sizeB = 0;
+            void *dataB = ::load(_filePathB, &sizeB);
+
+            const bool same = NULL != dataA && NULL != dataB
+                              && sizeA == sizeB && 0 == bx::memCmp(dataA, dataB, sizeA);
+            unload(dataA);
+            unload(dataB);
+            return same;
+        }
+
+        void evict() {
+            while (m_cpuBytes > m_cpuBudget || m_gpuBytes > m_gpuBudget) {
+                uint16_t lru = bx::kInvalidHandle;
+                for (uint16_t ii = 0; ii < m_resourceAlloc.getNumHandles(); ++ii) {
+                    const uint16_t idx = m_resourceAlloc.getHandleAt(ii);
+                    const Resource &resource = m_resources[idx];
+                    if (0 == resource.m_refs
+                        && AsyncLoadStatus::Pending != resource.m_status
+                        && (bx::kInvalidHandle == lru || resource.m_lastUsed < m_resources[lru].m_lastUsed)) {
+                        lru = idx;
+                    }
+                }
+
+                // everything left is in use
+                if (bx::kInvalidHandle == lru) {
+                    break;
+                }
+
+                for (uint16_t jj = 0; jj < m_entryAlloc.getNumHandles();) {
+                    const uint16_t entryIdx = m_entryAlloc.getHandleAt(jj);
+                    if (lru == m_entries[entryIdx].m_resource) {
+                        freeEntry(entryIdx);
+                    } else {
+                        ++jj;
+                    }
+                }
+
+                destroyResource(lru);
+                ++m_numEvicted;
+            }
+        }
+
+        void freeEntry(uint16_t _entryIdx) {
+            m_paths.erase(m_entries[_entryIdx].m_key);
+            m_entries[_entryIdx].m_key.clear();
+            m_entryAlloc.free(_entryIdx);
+        }
+
+        void destroyResource(uint16_t _resourceIdx) {
+            Resource &resource = m_resources[_resourceIdx];
+            if (AsyncLoadStatus::Pending == resource.m_status) {
+                asyncLoadFree(resource.m_load);
+            }
+
+            if (NULL != resource.m_mesh) {
+                meshUnload(resource.m_mesh);
+                resource.m_mesh = NULL;
+            }
+
+            if (bgfx::isValid(resource.m_texture)) {
+                bgfx::destroy(resource.m_texture);
+                resource.m_texture = BGFX_INVALID_HANDLE;
+            }
+
+            m_cpuBytes -= resource.m_cpuSize;
+            m_gpuBytes -= resource.m_gpuSize;
+            resource.m_filePath.clear();
+            m_resourceAlloc.free(_resourceIdx);
+        }
+
+        Resource m_resources[kMaxResources];
+        bx::HandleAllocT<kMaxResources> m_resourceAlloc;
+
+        Entry m_entries[kMaxResources];
+        bx::HandleAllocT<kMaxResources> m_entryAlloc;
+        std::unordered_map<std::string, uint16_t> m_paths;
+
+        uint64_t m_cpuBudget;
+        uint64_t m_gpuBudget;
+        uint64_t m_cpuBytes;
+        uint64_t m_gpuBytes;
+        uint32_t m_numEvicted;
+        uint32_t m_frame;
+    };
+}
+
+#endif //ESTARHOMEWORK_RESOURCE_CACHE_H
@@ -0,0 +1,234 @@
+//
+// HDR scene target, tonemapped to the back buffer with exposure from a GPU luminance histogram.
+//
+
+#include "common.h"
+#include "bgfx_utils.h"
+
+#ifndef ESTARHOMEWORK_TONE_MAPPING_H
+#define ESTARHOMEWORK_TONE_MAPPING_H
+
+namespace RenderCore::Post {
+    // must match shaders/exposure.sh and the thread group size of histogram_cs.sc
+    constexpr uint32_t kNumHistogramBins = 256;
+    constexpr uint16_t kHistogramGroupSize = 16;
+
+    constexpr uint64_t kHdrSamplerFlags = 0
+                                          | BGFX_SAMPLER_POINT
+                                          | BGFX_SAMPLER_U_CLAMP
+                                          | BGFX_SAMPLER_V_CLAMP;
+
+    struct ExposureSettings {
+        bool m_autoExposure;
+        // in stops, applied on top of the auto exposure
+        float m_compensation;
+        float m_minLogLum;
+        float m_maxLogLum;
+        // how fast the adapted luminance follows the scene, per second
+        float m_adaptationRate;
+    };
+
+    struct TonemapVertex {
+        float m_x, m_y, m_z;
+        float m_u, m_v;
+
+        static void init() {
+            ms_layout
+                    .begin()
+                    .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+                    .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+                    .end();
+        }
+
+        static bgfx::VertexLayout ms_layout;
+    };
+
+    bgfx::VertexLayout TonemapVertex::ms_layout;
+
+    // The scene renders into an RGBA16F target. A compute pass bins its luminance into a log2
+    // histogram, a second one averages the histogram and adapts the exposure luminance stored
+    // in a 1x1 texture, and a fullscreen pass tonemaps with it. Nothing is read back to the CPU.
+    // Without compute support the exposure is the compensation alone.
+    class ToneMapping {
+    public:
+        void init() {
+            TonemapVertex::init();
+
+            m_computeSupported = 0 != (bgfx::getCaps()->supported & BGFX_CAPS_COMPUTE);
+            m_tonemapProgram = loadProgram("tonemap_vs", "tonemap_fs");
+            m_clearProgram = BGFX_INVALID_HANDLE;
+            m_histogramProgram = BGFX_INVALID_HANDLE;
+            m_exposureProgram = BGFX_INVALID_HANDLE;
+            m_histogram = BGFX_INVALID_HANDLE;
+            if (m_computeSupported) {
+                m_clearProgram = bgfx::createProgram(loadShader("histogram_clear_cs"), true);
+                m_histogramProgram = bgfx::createProgram(loadShader("histogram_cs"), true);
+                m_exposureProgram = bgfx::createProgram(loadShader("exposure_cs"), true);
+
+                // compute buffers can't be initialized from CPU and their initial contents are
+                // undefined, the first submit clears the bins and the exposure pass clears them
+                // after reading them every frame
+                m_histogram = bgfx::createDynamicIndexBuffer(kNumHistogramBins, BGFX_BUFFER_COMPUTE_READ_WRITE |
+                                                                                BGFX_BUFFER_INDEX32);
+            }
+            m_histogramCleared = false;
+
+            const float zero = 0.0f;
+            m_avgLum = bgfx::createTexture2D(1, 1, false, 1, bgfx::TextureFormat::R32F,
+                                             BGFX_TEXTURE_COMPUTE_WRITE | kHdrSamplerFlags,
+                                             bgfx::copy(&zero, sizeof(zero)));
+
+            s_hdrColor = bgfx::createUniform("s_hdrColor", bgfx::UniformType::Sampler);
+            s_avgLum = bgfx::createUniform("s_avgLum", bgfx::UniformType::Sampler);
+            u_histogramParams = bgfx::createUniform("u_histogramParams", bgfx::UniformType::Vec4);
+            u_exposureParams = bgfx::createUniform("u_exposureParams", bgfx::UniformType::Vec4);
+            u_tonemapParams = bgfx::createUniform("u_tonemapParams", bgfx::UniformType::Vec4);
+
+            m_frameBuffer = BGFX_INVALID_HANDLE;
+            m_width = 0;
+            m_height = 0;
+        }
+
+        void destroy() {
+            if (bgfx::isValid(m_frameBuffer)) {
+                bgfx::destroy(m_frameBuffer);
+            }
+            if (m_computeSupported) {
+                bgfx::destroy(m_clearProgram);
+                bgfx::destroy(m_histogramProgram);
+                bgfx::destroy(m_exposureProgram);
+                bgfx::destroy(m_histogram);
+            }
+            bgfx::destroy(m_tonemapProgram);
+            bgfx::destroy(m_avgLum);
+            bgfx::destroy(s_hdrColor);
+            bgfx::destroy(s_avgLum);
+            bgfx::destroy(u_histogramParams);
+            bgfx::destroy(u_exposureParams);
+            bgfx::destroy(u_tonemapParams);
+        }
+
+        // the HDR scene target, recreated when the back buffer size changes
+        bgfx::FrameBufferHandle frameBuffer(uint32_t _width, uint32_t _height) {
+            if (_width != m_width || _height != m_height || !bgfx::isValid(m_frameBuffer)) {
+                if (bgfx::isValid(m_frameBuffer)) {
+                    bgfx::destroy(m_frameBuffer);
+                }
+
+                m_width = _width;
+                m_height = _height;
+
+                bgfx::TextureHandle textures[] = {
+                        bgfx::createTexture2D(uint16_t(m_width), uint16_t(m_height), false, 1,
+                                              bgfx::TextureFormat::RGBA16F, BGFX_TEXTURE_RT | kHdrSamplerFlags),
+                        bgfx::createTexture2D(uint16_t(m_width), uint16_t(m_height), false, 1,
+                                              bgfx::TextureFormat::D24S8, BGFX_TEXTURE_RT_WRITE_ONLY),
+                };
+                m_frameBuffer = bgfx::createFrameBuffer(BX_COUNTOF(textures), textures, true);
+            }
+            return m_frameBuffer;
+        }
+
+        void submit(bgfx::ViewId _histogramView, bgfx::ViewId _exposureView, bgfx::ViewId _tonemapView,
+                    const ExposureSettings &_settings, float _deltaTime) {
+            const bgfx::TextureHandle hdrColor = bgfx::getTexture(m_frameBuffer);
+            const bool autoExposure = _settings.m_autoExposure && m_computeSupported;
+
+            if (autoExposure) {
+                const float logLumRange = bx::max(_settings.m_maxLogLum - _settings.m_minLogLum, 0.01f);
+
+                const float histogramParams[4] = {
+                        _settings.m_minLogLum,
+                        1.0f / logLumRange,
+                        float(m_width),
+                        float(m_height),
+                };
+                if (!m_histogramCleared) {
+                    bgfx::setBuffer(0, m_histogram, bgfx::Access::Write);
+                    bgfx::dispatch(_histogramView, m_clearProgram, 1, 1, 1);
+                    m_histogramCleared = true;
+                }
+
+                bgfx::setUniform(u_histogramParams, histogramParams);
+                bgfx::setImage(0, hdrColor, 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA16F);
+                bgfx::setBuffer(1, m_histogram, bgfx::Access::ReadWrite);
+                bgfx::dispatch(_histogramView, m_histogramProgram,
+                               (m_width + kHistogramGroupSize - 1) / kHistogramGroupSize,
+                               (m_height + kHistogramGroupSize - 1) / kHistogramGroupSize, 1);
+
+                const float exposureParams[4] = {
+                        _settings.m_minLogLum,
+                        logLumRange,
+                        1.0f - bx::exp(-_deltaTime * _settings.m_adaptationRate),
+                        float(m_width * m_height),
+                };
+                bgfx::setUniform(u_exposureParams, exposureParams);
+                bgfx::setBuffer(0, m_histogram, bgfx::Access::ReadWrite);
+                bgfx::setImage(1, m_avgLum, 0, bgfx::Access::ReadWrite, bgfx::TextureFormat::R32F);
+                bgfx::dispatch(_exposureView, m_exposureProgram, 1, 1, 1);
+            }
+
+            bgfx::setViewRect(_tonemapView, 0, 0, uint16_t(m_width), uint16_t(m_height));
+            bgfx::setViewTransform(_tonemapView, NULL, NULL);
+
+            const float tonemapParams[4] = {
+                    bx::exp2(_settings.m_compensation),
+                    autoExposure ? 1.0f : 0.0f,
+                    0.0f,
+                    0.0f,
+            };
+            bgfx::setUniform(u_tonemapParams, tonemapParams);
+            bgfx::setTexture(0, s_hdrColor, hdrColor, kHdrSamplerFlags);
+            bgfx::setTexture(1, s_avgLum, m_avgLum, kHdrSamplerFlags);
+            bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+            if (fullscreenTriangle()) {
+                bgfx::submit(_tonemapView, m_tonemapProgram);
+            } else {
+                bgfx::discard();
+            }
+        }
+
+    private:
+        // one triangle covering clip space, drawn with identity view and projection
+        static bool fullscreenTriangle() {
+            if (3 != bgfx::getAvailTransientVertexBuffer(3, TonemapVertex::ms_layout)) {
+                return false;
+            }
+
+            bgfx::TransientVertexBuffer tvb;
+            bgfx::allocTransientVertexBuffer(&tvb, 3, TonemapVertex::ms_layout);
+            auto *vertices = (TonemapVertex *) tvb.data;
+
+            // texture v runs down from the top unless render targets start at the bottom left
+            const bool originBottomLeft = bgfx::getCaps()->originBottomLeft;
+            const float vTop = originBottomLeft ? 1.0f : 0.0f;
+            const float vStep = originBottomLeft ? -2.0f : 2.0f;
+            vertices[0] = {-1.0f, 1.0f, 0.0f, 0.0f, vTop};
+            vertices[1] = {3.0f, 1.0f, 0.0f, 2.0f, vTop};
+            vertices[2] = {-1.0f, -3.0f, 0.0f, 0.0f, vTop + vStep};
+
+            bgfx::setVertexBuffer(0, &tvb);
+            return true;
+        }
+
+        bool m_computeSupported;
+        bgfx::ProgramHandle m_tonemapProgram;
+        bgfx::ProgramHandle m_clearProgram;
+        bgfx::ProgramHandle m_histogramProgram;
+        bgfx::ProgramHandle m_exposureProgram;
+        bgfx::DynamicIndexBufferHandle m_histogram;
+        bool m_histogramCleared;
+        bgfx::TextureHandle m_avgLum;
+        bgfx::UniformHandle s_hdrColor;
+        bgfx::UniformHandle s_avgLum;
+        bgfx::UniformHandle u_histogramParams;
+        bgfx::UniformHandle u_exposureParams;
+        bgfx::UniformHandle u_tonemapParams;
+
+        bgfx::FrameBufferHandle m_frameBuffer;
+        uint32_t m_width;
+        uint32_t m_height;
+    };
+}
+
+#endif //ESTARHOMEWORK_TONE_MAPPING_H
@@ -0,0 +1,54 @@
+// clustered forward lighting, the sizes must match RenderCore::Lights in homework/clustered_lights.h
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define CLUSTER_MAX_LIGHTS 1024
+#define CLUSTER_MAX_LIGHTS_PER_CLUSTER 128
+#define CLUSTER_INDEX_WIDTH 1024
+#define CLUSTER_INDEX_HEIGHT 32
+
+// u_clusterParams is a member of u_frame in uniforms.sh, slice = log(z) * y + z
+#define u_numPointLights u_clusterParams.x
+#define u_clusterSliceScale u_clusterParams.y
+#define u_clusterSliceBias u_clusterParams.z
+
+// one column per light, world position and radius in the first row, color in the second
+SAMPLER2D(s_pointLights, 7);
+// one texel per cluster, offset into s_lightIndices and light count
+SAMPLER2D(s_lightGrid, 8);
+// light indices of all clusters, packed row by row
+SAMPLER2D(s_lightIndices, 9);
+
+// returns the offset and count of the cluster containing a world space position
+vec2 clusterLights(vec3 _worldPos)
+{
+	float viewDepth = mul(u_view, vec4(_worldPos, 1.0) ).z;
+	vec4 clip = mul(u_viewProj, vec4(_worldPos, 1.0) );
+	vec2 ndc = clip.xy / clip.w;
+
+	vec2 tile = clamp(floor( (ndc * 0.5 + 0.5) * vec2(CLUSTER_X, CLUSTER_Y) ), vec2_splat(0.0), vec2(CLUSTER_X - 1, CLUSTER_Y - 1) );
+	float slice = clamp(floor(log(max(viewDepth, 0.0001) ) * u_clusterSliceScale + u_clusterSliceBias), 0.0, float(CLUSTER_Z - 1) );
+
+	vec2 uv = vec2(
+		  (tile.y * float(CLUSTER_X) + tile.x + 0.5) / float(CLUSTER_X * CLUSTER_Y)
+		, (slice + 0.5) / float(CLUSTER_Z)
+		);
+	return texture2DLod(s_lightGrid, uv, 0.0).xy;
+}
+
+float clusterLightIndex(float _index)
+{
+	vec2 uv = vec2(
+		  (mod(_index, float(CLUSTER_INDEX_WIDTH) ) + 0.5) / float(CLUSTER_INDEX_WIDTH)
+		, (floor(_index / float(CLUSTER_INDEX_WIDTH) ) + 0.5) / float(CLUSTER_INDEX_HEIGHT)
+		);
+	return texture2DLod(s_lightIndices, uv, 0.0).x;
+}
+
+// windowed inverse square falloff, reaches zero at the light radius so clusters can cull exactly
+float pointLightFalloff(float _distanceSq, float _radius)
+{
+	float ratio = _distanceSq / (_radius * _radius);
+	float window = saturate(1.0 - ratio * ratio);
+	return window * window / max(_distanceSq, 0.0001);
+}
@@ -0,0 +1,7 @@
+#include "../bgfx/examples/common/common.sh"
+
+void main()
+{
+	// depth only, color writes are masked out by the depth pre-pass state
+	gl_FragColor = vec4_splat(0.0);
+}
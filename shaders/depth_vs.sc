@@ -0,0 +1,23 @@
+#if INSTANCED
+$input a_position, i_data0, i_data1, i_data2, i_data3
+#else
+$input a_position
+#endif
+
+#include "../bgfx/examples/common/common.sh"
+#include "invariant.sh"
+
+void main()
+{
+	// same operations as mesh_vs.sc, the scene pass tests its depth for equality against this one
+#if INSTANCED
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+#else
+	mat4 model = u_model[0];
+#endif
+
+	PRECISE vec4 worldPos = mul(model, vec4(a_position, 1.0) );
+	PRECISE vec4 clipPos = mul(u_viewProj, worldPos);
+
+	gl_Position = clipPos;
+}
@@ -0,0 +1,15 @@
+// luminance histogram for auto exposure, the sizes must match RenderCore::Post in homework/tone_mapping.h
+#define NUM_HISTOGRAM_BINS 256
+
+// x: min log2 luminance, y: 1 / log2 luminance range, zw: size of the hdr color target
+uniform vec4 u_histogramParams;
+#define u_histogramMinLogLum u_histogramParams.x
+#define u_histogramInvLogLumRange u_histogramParams.y
+#define u_histogramSize u_histogramParams.zw
+
+// x: min log2 luminance, y: log2 luminance range, z: adaptation blend of this frame, w: pixel count
+uniform vec4 u_exposureParams;
+#define u_exposureMinLogLum u_exposureParams.x
+#define u_exposureLogLumRange u_exposureParams.y
+#define u_exposureAdaptation u_exposureParams.z
+#define u_exposurePixelCount u_exposureParams.w
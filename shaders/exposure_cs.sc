@@ -0,0 +1,41 @@
+#include "bgfx_compute.sh"
+#include "exposure.sh"
+
+BUFFER_RW(b_histogram, uint, 0);
+IMAGE2D_RW(s_avgLum, r32f, 1);
+
+SHARED float s_weighted[NUM_HISTOGRAM_BINS];
+
+NUM_THREADS(NUM_HISTOGRAM_BINS, 1, 1)
+void main()
+{
+	uint index = gl_LocalInvocationIndex;
+	float count = float(b_histogram[index]);
+	s_weighted[index] = count * float(index);
+
+	// cleared here so the next frame's histogram pass starts from zero
+	b_histogram[index] = 0u;
+	barrier();
+
+	for (uint stride = NUM_HISTOGRAM_BINS / 2u; stride > 0u; stride >>= 1u)
+	{
+		if (index < stride)
+		{
+			s_weighted[index] += s_weighted[index + stride];
+		}
+		barrier();
+	}
+
+	if (index == 0u)
+	{
+		// count is bin 0 for this thread, the unmeasured dark pixels don't pull the average down
+		float numPixels = max(u_exposurePixelCount - count, 1.0);
+		float logAverage = s_weighted[0] / numPixels - 1.0;
+		float avgLum = exp2(logAverage / 254.0 * u_exposureLogLumRange + u_exposureMinLogLum);
+
+		// exponential adaptation towards this frame's average, the texture starts at zero
+		float lastLum = imageLoad(s_avgLum, ivec2(0, 0) ).x;
+		float adapted = lastLum > 0.0 ? lastLum + (avgLum - lastLum) * u_exposureAdaptation : avgLum;
+		imageStore(s_avgLum, ivec2(0, 0), vec4(adapted, 0.0, 0.0, 0.0) );
+	}
+}
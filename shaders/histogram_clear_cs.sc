@@ -0,0 +1,11 @@
+#include "bgfx_compute.sh"
+#include "exposure.sh"
+
+BUFFER_WR(b_histogram, uint, 0);
+
+// zeroes the bins once after the buffer is created, the exposure pass clears them every frame after
+NUM_THREADS(NUM_HISTOGRAM_BINS, 1, 1)
+void main()
+{
+	b_histogram[gl_LocalInvocationIndex] = 0u;
+}
@@ -0,0 +1,37 @@
+#include "bgfx_compute.sh"
+#include "exposure.sh"
+
+IMAGE2D_RO(s_hdrColor, rgba16f, 0);
+BUFFER_RW(b_histogram, uint, 1);
+
+SHARED uint s_bins[NUM_HISTOGRAM_BINS];
+
+// bin 0 takes the pixels too dark to measure, the others cover the log2 luminance range
+uint luminanceBin(vec3 _color)
+{
+	float lum = dot(_color, vec3(0.2126, 0.7152, 0.0722) );
+	if (lum < 0.005)
+	{
+		return 0u;
+	}
+
+	float logLum = saturate( (log2(lum) - u_histogramMinLogLum) * u_histogramInvLogLumRange);
+	return uint(logLum * 254.0 + 1.0);
+}
+
+NUM_THREADS(16, 16, 1)
+void main()
+{
+	s_bins[gl_LocalInvocationIndex] = 0u;
+	barrier();
+
+	uvec2 coord = gl_GlobalInvocationID.xy;
+	if (coord.x < uint(u_histogramSize.x) && coord.y < uint(u_histogramSize.y) )
+	{
+		vec3 color = imageLoad(s_hdrColor, ivec2(coord) ).xyz;
+		atomicAdd(s_bins[luminanceBin(color)], 1u);
+	}
+	barrier();
+
+	atomicAdd(b_histogram[gl_LocalInvocationIndex], s_bins[gl_LocalInvocationIndex]);
+}
@@ -0,0 +1,8 @@
+// depth_vs.sc writes the depth the scene pass tests for equality, so both must compute the clip
+// position bit for bit the same, GLSL declares it invariant and HLSL marks the computation precise
+#if BGFX_SHADER_LANGUAGE_GLSL
+invariant gl_Position;
+#	define PRECISE
+#else
+#	define PRECISE precise
+#endif
@@ -1,26 +1,55 @@
-$input v_pos, v_normal, v_texcoord0, v_shadowcoord
+#if USE_VERTEX_TANGENTS
+$input v_pos, v_normal, v_tangent, v_bitangent, v_texcoord0
+#else
+$input v_pos, v_normal, v_texcoord0
+#endif
 
 #include "../bgfx/examples/common/common.sh"
 
+// permutation features, each variant is compiled by shaderc with its own define set
+// USE_PBR_MAPS, USE_BLINN_PHONG, USE_PBR, USE_DIFFUSE_IBL, USE_SPECULAR_IBL,
+// USE_SHADOW_MAP, USE_PCSS, SHADOW_PACKED_DEPTH, USE_VERTEX_TANGENTS and USE_POINT_SHADOW, see RenderCore::MeshFeature
+
 #define PI 3.14159265359
 #define PI2 6.283185307179586
 #define EPS 0.000001
-#define NUM_SAMPLES 100
 #define PCF_NUM_SAMPLES NUM_SAMPLES
-#define NUM_RINGS 10
+#define PROBE_NUM_SAMPLES 8
+#define BLOCKER_SEARCH_NUM_SAMPLES 16
 #define BIAS 0.02
+#define SHADOW_MAX_CASCADES 4
+// world space distance the receiver is moved towards the point light before the depth compare
+#define OMNI_BIAS 0.05
 
 #include "uniforms.sh"
+#include "clustered.sh"
 
 uniform vec4 u_time;
 
 SAMPLERCUBE(s_texCube, 0);
-SAMPLERCUBE(s_texCubeIrr, 1);
+// split-sum environment BRDF, scale and bias of F0 by N dot V and roughness
+SAMPLER2D(s_brdfLut, 10);
+#if SHADOW_PACKED_DEPTH
 SAMPLER2D(s_shadowMap, 2);
+#else
+SAMPLER2DSHADOW(s_shadowMap, 2);
+// same texture as s_shadowMap without depth compare, used by the PCSS blocker search
+SAMPLER2D(s_shadowDepth, 6);
+#endif
 SAMPLER2D(s_texDiffuse, 3);
 SAMPLER2D(s_texNormal, 4);
 SAMPLER2D(s_texAORM, 5);
 
+#if USE_VERTEX_TANGENTS
+// tangent frame interpolated from the vertices, see decodeTangentFrame in mesh_vs.sc
+vec3 getNormalFromMap(vec3 tangent, vec3 bitangent, vec3 normal, sampler2D texNormal, vec2 texcoord)
+{
+    vec3 tangentNormal = texture2D(texNormal, texcoord).xyz * 2.0 - 1.0;
+
+    return normalize(tangentNormal.x * tangent + tangentNormal.y * bitangent + tangentNormal.z * normalize(normal));
+}
+#else
+// tangent frame rebuilt per pixel from screen space derivatives, for meshes without tangents
 vec3 getNormalFromMap(vec3 pos, vec3 normal, sampler2D texNormal, vec2 texcoord)
 {
     vec3 tangentNormal = texture2D(texNormal, texcoord).xyz * 2.0 - 1.0;
@@ -37,6 +66,7 @@ vec3 getNormalFromMap(vec3 pos, vec3 normal, sampler2D texNormal, vec2 texcoord)
 
     return normalize(mul(TBN, tangentNormal));
 }
+#endif
 
 vec3 fresnelSchlick(float cos, vec3 f0)
 {
@@ -59,6 +89,23 @@ float normalDistributionGGX(float NoH, float roughness)
     return a2 / ( PI * btm * btm );
 }
 
+// basis constants and cosine convolution are folded into the coefficients on the CPU
+vec3 irradianceSh(vec3 _normal)
+{
+	vec3 n = _normal;
+	vec3 irradiance = u_irradianceSh[0].xyz
+		+ u_irradianceSh[1].xyz * n.y
+		+ u_irradianceSh[2].xyz * n.z
+		+ u_irradianceSh[3].xyz * n.x
+		+ u_irradianceSh[4].xyz * (n.x * n.y)
+		+ u_irradianceSh[5].xyz * (n.y * n.z)
+		+ u_irradianceSh[6].xyz * (3.0 * n.z * n.z - 1.0)
+		+ u_irradianceSh[7].xyz * (n.x * n.z)
+		+ u_irradianceSh[8].xyz * (n.x * n.x - n.y * n.y)
+		;
+	return max(irradiance, vec3_splat(0.0) );
+}
+
 float occlusionSchlickGGX(float NoV, float roughness)
 {
     float r = roughness + 1.0;
@@ -75,57 +122,246 @@ float occlusionMicrofacet(float NoV, float NoL, float roughness)
     return ggx1 * ggx2;
 }
 
-float hardShadow(sampler2D _sampler, vec4 _shadowCoord, float _bias)
+// direct lighting of a single light arriving from lightDir with the given radiance
+vec3 shadeLight(vec3 normal, vec3 viewDir, vec3 lightDir, vec3 radiance, vec3 diffuseColor, vec3 f0, float roughness, float metallic)
 {
-	vec3 texCoord = _shadowCoord.xyz/_shadowCoord.w;
+	vec3 halfVector = normalize(lightDir + viewDir);
+
+	// calculate related cosine
+	float NoV = max(dot(normal, viewDir), 0.0);
+	float NoL = max(dot(normal, lightDir), 0.0);
+	float NoH = max(dot(normal, halfVector), 0.0);
+	float HoV = max(dot(halfVector, viewDir), 0.0);
+
+	vec3 directLighting = vec3_splat(0.0);
+
+#if USE_BLINN_PHONG
+    // diffuse
+    vec3 diffuse = NoL * radiance * diffuseColor;
+
+    // specular
+    float specularStrength = 0.5;
+    vec3 specular = pow(HoV, 32.0) * specularStrength * radiance * diffuseColor;
+
+    directLighting = diffuse + specular;
+#endif
+
+#if USE_PBR
+    // Fresnel
+    vec3 F = fresnelSchlick(HoV, f0);
 
-	return step(texCoord.z-_bias, unpackRgbaToFloat(texture2D(_sampler, texCoord.xy)));
+    // Distribution of microfacet normal
+    float NDF = normalDistributionGGX(NoH, roughness);
+
+    // Geometry: microfacet occlusion relationship
+    float G = occlusionMicrofacet(NoV, NoL, roughness);
+
+    // calculate specualr reflection energy
+    vec3 Fs = (F * NDF * G) / (4.0 * NoV * NoL + EPS);
+
+    // assume there is no refraction, then Fs + Fd = 1.0
+    vec3 Fd = vec3_splat(1.0) - Fs;
+    Fd *= 1.0 - metallic;
+
+    // calculate final direct lighting
+    directLighting = (Fd * diffuseColor / PI + Fs) * radiance * NoL;
+#endif
+
+	return directLighting;
+}
+
+// unshadowed point lights of the cluster containing the fragment
+vec3 clusteredLighting(vec3 worldPos, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 f0, float roughness, float metallic)
+{
+	vec3 color = vec3_splat(0.0);
+	if (u_numPointLights < 0.5)
+	{
+		return color;
+	}
+
+	vec2 cluster = clusterLights(worldPos);
+	for (int i = 0; i < CLUSTER_MAX_LIGHTS_PER_CLUSTER; i++)
+	{
+		if (float(i) >= cluster.y)
+		{
+			break;
+		}
+
+		float u = (clusterLightIndex(cluster.x + float(i) ) + 0.5) / float(CLUSTER_MAX_LIGHTS);
+		vec4 posRadius = texture2DLod(s_pointLights, vec2(u, 0.25), 0.0);
+		vec3 lightColor = texture2DLod(s_pointLights, vec2(u, 0.75), 0.0).xyz;
+
+		vec3 toLight = posRadius.xyz - worldPos;
+		float distanceSq = dot(toLight, toLight);
+		vec3 radiance = lightColor * pointLightFalloff(distanceSq, posRadius.w);
+		color += shadeLight(normal, viewDir, toLight * inversesqrt(max(distanceSq, EPS) ), radiance, diffuseColor, f0, roughness, metallic);
+	}
+
+	return color;
 }
 
-float rand(vec2 uv) {
-    // 0 - 1
-	const float a = 12.9898, b = 78.233, c = 43758.5453;
-	float dt = dot(uv.xy, vec2(a,b)), sn = mod(dt, PI);
+// returns 1.0 if the receiver depth is not occluded at the given shadow map texel
+float shadowTest(vec2 _texCoord, float _depth, float _bias)
+{
+#if SHADOW_PACKED_DEPTH
+	return step(_depth - _bias, unpackRgbaToFloat(texture2D(s_shadowMap, _texCoord)));
+#else
+	// hardware depth compare, bilinear filtered on most GPUs
+	return shadow2D(s_shadowMap, vec3(_texCoord, _depth - _bias));
+#endif
+}
 
-	return fract(sin(sn) * c);
+float shadowDepth(vec2 _texCoord)
+{
+#if SHADOW_PACKED_DEPTH
+	return unpackRgbaToFloat(texture2D(s_shadowMap, _texCoord));
+#else
+	return texture2D(s_shadowDepth, _texCoord).x;
+#endif
 }
 
-vec2 poissonDisk[NUM_SAMPLES];
+float hardShadow(vec4 _shadowCoord, float _bias)
+{
+	vec3 texCoord = _shadowCoord.xyz/_shadowCoord.w;
+
+	return shadowTest(texCoord.xy, texCoord.z, _bias);
+}
 
-void poissonDiskSamples(vec2 randomSeed) {
-    float ANGLE_STEP = PI2 * float(NUM_RINGS) / float(NUM_SAMPLES);
-    float INV_NUM_SAMPLES = 1.0 / float(NUM_SAMPLES);
+// per-pixel kernel rotation, interleaved gradient noise has a blue-noise like spectrum
+vec2 kernelRotation(vec2 fragCoord)
+{
+    float angle = PI2 * fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715) ) ) );
+    return vec2(cos(angle), sin(angle) );
+}
 
-    float angle = rand(randomSeed) * PI2;
-    float radius = INV_NUM_SAMPLES;
-    float radiusStep = radius;
+vec2 rotate(vec2 p, vec2 cs)
+{
+    return vec2(p.x * cs.x - p.y * cs.y, p.x * cs.y + p.y * cs.x);
+}
 
-    for( int i = 0; i < NUM_SAMPLES; i ++ ) {
-        poissonDisk[i] = vec2(cos(angle), sin(angle)) * pow(radius, 0.75);
-        radius += radiusStep;
-        angle += ANGLE_STEP;
+float findBlockerDepth(vec2 uv, float receiverDepth, float searchRadius, vec2 rotation, vec2 tileMin, vec2 tileMax)
+{
+    float blockerSum = 0.0;
+    float numBlockers = 0.0;
+
+    for(int i = 0; i < BLOCKER_SEARCH_NUM_SAMPLES / 2; i++){
+        vec4 pair = u_poissonDisk[i];
+        vec2 uv0 = clamp(uv + rotate(pair.xy, rotation) * searchRadius * u_shadowTexelSize, tileMin, tileMax);
+        vec2 uv1 = clamp(uv + rotate(pair.zw, rotation) * searchRadius * u_shadowTexelSize, tileMin, tileMax);
+        float depth0 = shadowDepth(uv0);
+        float depth1 = shadowDepth(uv1);
+        float blocker0 = step(depth0, receiverDepth - BIAS);
+        float blocker1 = step(depth1, receiverDepth - BIAS);
+        blockerSum += depth0 * blocker0 + depth1 * blocker1;
+        numBlockers += blocker0 + blocker1;
     }
+
+    return numBlockers > 0.0 ? blockerSum / numBlockers : -1.0;
 }
 
-float PCF(sampler2D shadowMap, vec4 coords, float filterSize) {
+float PCF(vec4 coords, float filterSize, vec4 tile, vec2 fragCoord, float bias) {
     // cited from my homework PCF of Games202
     vec3 shadowCoords = coords.xyz;
-    float shadowDepth = shadowCoords.z;
-    poissonDiskSamples(shadowCoords.xy);
-    float filter = 0.0;
-    vec2 textureResolution = vec2_splat(512.0);
-
-    for(int i=0; i < PCF_NUM_SAMPLES; i++){
-        vec2 sampleCoords = shadowCoords.xy + poissonDisk[i] * filterSize / textureResolution;
-        float sampleDepth = unpackRgbaToFloat(texture2D(shadowMap, sampleCoords));
-        if(shadowDepth <= (sampleDepth + BIAS)){
-            filter += 1.0;
-        }
+    float receiverDepth = shadowCoords.z;
+    vec2 rotation = kernelRotation(fragCoord);
+
+    // keep taps inside the cascade tile so neighbouring cascades never bleed in
+    vec2 tileMin = tile.xy + 0.5 * u_shadowTexelSize;
+    vec2 tileMax = tile.zw - 0.5 * u_shadowTexelSize;
+
+#if USE_PCSS
+    // percentage closer soft shadows, the penumbra width follows from similar triangles between the
+    // light, the blocker and the receiver
+    float blockerDepth = findBlockerDepth(shadowCoords.xy, receiverDepth, filterSize, rotation, tileMin, tileMax);
+    if (blockerDepth < 0.0) {
+        return 1.0;
+    }
+    filterSize = max(1.0, (receiverDepth - blockerDepth) / max(blockerDepth, EPS) * u_pcssLightSize);
+#endif
+
+    vec2 kernelScale = filterSize * u_shadowTexelSize;
+
+    // probe the outermost ring first, fully lit or fully shadowed pixels skip the full kernel
+    float probe = 0.0;
+    for(int i = (PCF_NUM_SAMPLES - PROBE_NUM_SAMPLES) / 2; i < PCF_NUM_SAMPLES / 2; i++){
+        vec4 pair = u_poissonDisk[i];
+        probe += shadowTest(clamp(shadowCoords.xy + rotate(pair.xy, rotation) * kernelScale, tileMin, tileMax), receiverDepth, bias);
+        probe += shadowTest(clamp(shadowCoords.xy + rotate(pair.zw, rotation) * kernelScale, tileMin, tileMax), receiverDepth, bias);
+    }
+
+    if (probe == 0.0 || probe == float(PROBE_NUM_SAMPLES) ) {
+        return probe / float(PROBE_NUM_SAMPLES);
+    }
+
+    float visibility = probe;
+    for(int i = 0; i < (PCF_NUM_SAMPLES - PROBE_NUM_SAMPLES) / 2; i++){
+        vec4 pair = u_poissonDisk[i];
+        visibility += shadowTest(clamp(shadowCoords.xy + rotate(pair.xy, rotation) * kernelScale, tileMin, tileMax), receiverDepth, bias);
+        visibility += shadowTest(clamp(shadowCoords.xy + rotate(pair.zw, rotation) * kernelScale, tileMin, tileMax), receiverDepth, bias);
+    }
+    visibility /= float(PCF_NUM_SAMPLES);
+
+    return visibility;
+}
+
+float cascadedShadow(vec3 worldPos, float filterSize, vec2 fragCoord)
+{
+    // pick the first cascade whose far split lies beyond the fragment
+    float viewDepth = mul(u_view, vec4(worldPos, 1.0) ).z;
+    float cascade = dot(step(u_cascadeSplits.xyz, vec3_splat(viewDepth) ), vec3_splat(1.0) );
+    cascade = min(cascade, u_numCascades - 1.0);
+
+    int index = int(cascade);
+    vec4 shadowCoord = mul(u_lightMtx[index], vec4(worldPos, 1.0) );
+    vec4 tile = u_shadowTiles[index];
+
+    // beyond the last cascade or outside the fitted tile is treated as lit
+    if (viewDepth > u_cascadeSplits.w
+    ||  any(lessThan(shadowCoord.xy, tile.xy) )
+    ||  any(greaterThan(shadowCoord.xy, tile.zw) ) )
+    {
+        return 1.0;
+    }
+
+    return PCF(shadowCoord, filterSize, tile, fragCoord, BIAS);
+}
+
+#if USE_POINT_SHADOW
+// cube face the point light sees _dir through, order matches Shadow::updateOmni
+int omniFace(vec3 _dir)
+{
+    vec3 a = abs(_dir);
+    if (a.x >= a.y && a.x >= a.z) {
+        return _dir.x > 0.0 ? 0 : 1;
+    }
+    if (a.y >= a.z) {
+        return _dir.y > 0.0 ? 2 : 3;
+    }
+    return _dir.z > 0.0 ? 4 : 5;
+}
+
+float omniShadow(vec3 worldPos, vec3 lightPos, float filterSize, vec2 fragCoord)
+{
+    vec3 toFragment = worldPos - lightPos;
+    float distance = length(toFragment);
+
+    // compare at a biased distance from the light instead of offsetting the perspective depth,
+    // the bias grows with the texel footprint, a face texel spans about 4 * distance * texel size
+    float bias = OMNI_BIAS + 8.0 * distance * u_shadowTexelSize.y;
+    vec3 receiverPos = worldPos - toFragment * (min(bias, distance) / max(distance, EPS) );
+
+    int index = omniFace(toFragment);
+    vec4 shadowCoord = mul(u_lightMtx[index], vec4(receiverPos, 1.0) );
+    shadowCoord.xyz /= shadowCoord.w;
+
+    // beyond the far plane of the faces is treated as lit
+    if (shadowCoord.z > 1.0) {
+        return 1.0;
     }
-    filter /= float(NUM_SAMPLES);
 
-    return filter;
+    return PCF(shadowCoord, filterSize, u_shadowTiles[index], fragCoord, 0.0);
 }
+#endif
 
 void main()
 {
@@ -137,126 +373,98 @@ void main()
 
     float roughness = u_roughness;
     float metallic = u_metallic;
-    float exposure = u_exposure;
     vec3 diffuseColor = u_diffuseColor.xyz;
     float ao = 1.0;
 
-    if(u_usePbrMaps != 0.0){
-        diffuseColor = texture2D(s_texDiffuse, v_texcoord0).rgb;
-        normal = getNormalFromMap(v_pos, v_normal, s_texNormal, v_texcoord0);
-        vec3 texAORM = texture2D(s_texAORM, v_texcoord0).rgb;
-        ao = texAORM.r;
-        roughness = texAORM.g;
-        metallic = texAORM.b;
-    }
-
-    if(u_isFloor != 0.0){
-        roughness = 1.0;
-        metallic = 0.0;
-        exposure = 2.2;
-        diffuseColor = vec3_splat(1.0);
-        ao = 1.0;
-    }
+#if USE_PBR_MAPS
+    diffuseColor = texture2D(s_texDiffuse, v_texcoord0).rgb;
+#if USE_VERTEX_TANGENTS
+    normal = getNormalFromMap(v_tangent, v_bitangent, v_normal, s_texNormal, v_texcoord0);
+#else
+    normal = getNormalFromMap(v_pos, v_normal, s_texNormal, v_texcoord0);
+#endif
+    vec3 texAORM = texture2D(s_texAORM, v_texcoord0).rgb;
+    ao = texAORM.r;
+    roughness = texAORM.g;
+    metallic = texAORM.b;
+#endif
 
 	vec3 lightDir = normalize(lightPos - v_pos);
 	// vec3 normal = getNormalFromMap();
 	vec3 viewDir = normalize(viewPos - v_pos);
-	vec3 halfVector = normalize(lightDir + viewDir);
 
-	// calculate related cosine
 	float NoV = max(dot(normal, viewDir), 0.0);
 	float NoL = max(dot(normal, lightDir), 0.0);
-	float NoH = max(dot(normal, halfVector), 0.0);
-	float HoV = max(dot(halfVector, viewDir), 0.0);
 
-	// calculate Li
+	// calculate Li, the blinn phong light is not attenuated
 	float distance = length(lightPos - v_pos);
 	float attenuation = 1.0 / (distance * distance);
 	vec3 Li = lightColor * attenuation;
+#if USE_BLINN_PHONG
+	Li = lightColor;
+#endif
 
 	// define direct and indirect lighting
-	vec3 directLighting = vec3_splat(0.0);
 	vec3 indirectLighting = vec3_splat(0.0);
 
     // Fresnel
     vec3 f0 = vec3_splat(0.04);
     f0 = mix(f0, diffuseColor, metallic);
-    vec3 F = fresnelSchlick(HoV, f0);
-
-	if(u_useBlinnPhong != 0.0){
-        // diffuse
-        vec3 diffuse = NoL * lightColor * diffuseColor;
 
-        // specular
-        float specularStrength = 0.5;
-        vec3 specular = pow(HoV, 32) * specularStrength * lightColor * diffuseColor;
+	vec3 directLighting = shadeLight(normal, viewDir, lightDir, Li, diffuseColor, f0, roughness, metallic);
 
-        directLighting = diffuse + specular;
-	}
-
-    if(u_usePBR != 0.0){
-        // Distribution of microfacet normal
-        float NDF = normalDistributionGGX(NoH, roughness);
-
-        // Geometry: microfacet occlusion relationship
-        float G = occlusionMicrofacet(NoV, NoL, roughness);
-
-        // calculate specualr reflection energy
-        vec3 Fs = (F * NDF * G) / (4.0 * NoV * NoL + EPS);
-
-        // assume there is no refraction, then Fs + Fd = 1.0
-        vec3 Fd = vec3_splat(1.0) - Fs;
-        Fd *= 1.0 - metallic;
-
-        // calculate final direct lighting
-        directLighting = (Fd * diffuseColor / PI + Fs) * Li * NoL;
-    }
-
-    if(u_useDiffuseIBL == 0.0){
-        // ambient
-        float ambientStrength = 0.1;
-        indirectLighting += ambientStrength * normalize(lightColor) * diffuseColor;
-    }
-    else{
+#if USE_DIFFUSE_IBL
+    {
         // ibl ambient
         vec3 kS = fresnelSchlick(NoV, f0, roughness);
         vec3 kD = vec3_splat(1.0) - kS;
         kD *= (1.0 - metallic);
-        vec3 irradiance = toLinear(textureCube(s_texCubeIrr, normal).rgb);
+        vec3 irradiance = toLinear(irradianceSh(normal) );
         // vec3 irradiance = vec3_splat(0.2);
         vec3 indirectAmbient = irradiance * diffuseColor * kD;
         // vec3 indirectAmbient = irradiance * diffuseColor * texAO;
 
         indirectLighting += indirectAmbient * ao;
     }
-
-    if(u_useSpecularIBL != 0.0){
-        vec3 kS = fresnelSchlick(NoV, f0, roughness);
-        // ibl specular
+#else
+    // ambient
+    float ambientStrength = 0.1;
+    indirectLighting += ambientStrength * normalize(lightColor) * diffuseColor;
+#endif
+
+#if USE_SPECULAR_IBL
+    {
+        // ibl specular, s_texCube is GGX prefiltered with roughness linear over its mip chain
         vec3 reflectLightDir = -reflect(viewDir, normal);
         // vec3 reflectLightDir = 2.0 * NoV * normal - viewDir;
-        float mip = 1.0 + 5.0 * roughness;
-        reflectLightDir = fixCubeLookup(reflectLightDir, mip, 256.0);
+        float mip = roughness * u_envMaxMip;
+        reflectLightDir = fixCubeLookup(reflectLightDir, mip, u_envSize);
         vec3 radiance = toLinear(textureCubeLod(s_texCube, reflectLightDir, mip).xyz);
-        vec3 indirectSpecular = radiance * kS;
+        vec2 envBrdf = texture2DLod(s_brdfLut, vec2(NoV, roughness), 0.0).xy;
+        vec3 indirectSpecular = radiance * (f0 * envBrdf.x + envBrdf.y);
         indirectLighting += indirectSpecular * ao;
     }
+#endif
 
 	// apply shadow map
 	float visibility = 1.0;
-	if(u_useShadowMap != 0.0){
-	    visibility = PCF(s_shadowMap, v_shadowcoord, u_pcfFilterSize);
+#if USE_SHADOW_MAP
+	if(NoL > 0.0){
+#if USE_POINT_SHADOW
+	    visibility = omniShadow(v_pos, lightPos, u_pcfFilterSize, gl_FragCoord.xy);
+#else
+	    visibility = cascadedShadow(v_pos, u_pcfFilterSize, gl_FragCoord.xy);
+#endif
     }
+#endif
 
     // combine direct and indirect lighting
     // vec3 color = directLighting + indirectLighting;
     vec3 color = directLighting * visibility + indirectLighting;
+    color += clusteredLighting(v_pos, normal, viewDir, diffuseColor, f0, roughness, metallic);
     // color = vec3(u_usePBRMaps);
 
-    // gamma correction
-    color = color / (color + vec3_splat(1.0));
-    color = pow(color, vec3_splat(1.0 / exposure));
-
+    // HDR output, exposure and tonemapping are applied by tonemap_fs
 	gl_FragColor.xyz = color;
 	// gl_FragColor.xyz = normal;
 	// gl_FragColor.xyz = vec3(metallic, 0.0, 0.0);
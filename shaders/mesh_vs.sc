@@ -1,27 +1,78 @@
+#if USE_VERTEX_TANGENTS
+#	if INSTANCED
+$input a_position, a_tangent, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+#	else
+$input a_position, a_tangent, a_texcoord0
+#	endif
+$output v_pos, v_normal, v_tangent, v_bitangent, v_texcoord0
+#else
+#	if INSTANCED
+$input a_position, a_normal, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+#	else
 $input a_position, a_normal, a_texcoord0
-$output v_pos, v_normal, v_texcoord0, v_shadowcoord
+#	endif
+$output v_pos, v_normal, v_texcoord0
+#endif
 
 #include "../bgfx/examples/common/common.sh"
+#include "invariant.sh"
 
 uniform vec4 u_time;
-uniform mat4 u_lightMtx;
+
+#if USE_VERTEX_TANGENTS
+// tangent frame written by geometryc --tangentframe, a unit quaternion rotating the tangent
+// to x and the normal to z, the sign of w is the handedness of the bitangent
+void decodeTangentFrame(vec4 _packed, out vec3 _normal, out vec3 _tangent, out vec3 _bitangent)
+{
+	// undo the 8-bit packing of bgfx::vertexPack, v * 127 + 128
+	vec4 q = normalize(_packed * (255.0 / 127.0) - 128.0 / 127.0);
+
+	_tangent = vec3(
+		  1.0 - 2.0 * (q.y * q.y + q.z * q.z)
+		, 2.0 * (q.x * q.y + q.w * q.z)
+		, 2.0 * (q.x * q.z - q.w * q.y)
+		);
+	_normal = vec3(
+		  2.0 * (q.x * q.z + q.w * q.y)
+		, 2.0 * (q.y * q.z - q.w * q.x)
+		, 1.0 - 2.0 * (q.x * q.x + q.y * q.y)
+		);
+	_bitangent = cross(_normal, _tangent) * sign(q.w);
+}
+#endif
 
 void main()
 {
 	vec3 pos = a_position;
 
+#if USE_VERTEX_TANGENTS
+	vec3 normal;
+	vec3 tangent;
+	vec3 bitangent;
+	decodeTangentFrame(a_tangent, normal, tangent, bitangent);
+#else
 	vec3 normal = a_normal.xyz * 2.0 - 1.0;
+#endif
 
-	gl_Position = mul(u_modelViewProj, vec4(pos, 1.0) );
+#if INSTANCED
+	// model matrix comes from the instance data buffer
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+#else
+	mat4 model = u_model[0];
+#endif
 
-	v_pos = mul(u_model[0], vec4(pos, 1.0) ).xyz;
+	PRECISE vec4 worldPos = mul(model, vec4(pos, 1.0) );
+	PRECISE vec4 clipPos = mul(u_viewProj, worldPos);
 
-    v_normal = normalize(mul(u_model[0], vec4(normal, 0.0) ).xyz);
+	gl_Position = clipPos;
 
-    v_texcoord0 = vec2(a_texcoord0.x, 1.0 - a_texcoord0.y);
+	v_pos = worldPos.xyz;
+
+    v_normal = normalize(mul(model, vec4(normal, 0.0) ).xyz);
+#if USE_VERTEX_TANGENTS
+    v_tangent = normalize(mul(model, vec4(tangent, 0.0) ).xyz);
+    v_bitangent = normalize(mul(model, vec4(bitangent, 0.0) ).xyz);
+#endif
 
-	// const float shadowMapOffset = 0.001;
-	// vec3 posOffset = a_position + normal * shadowMapOffset;
-	// v_shadowcoord = mul(u_lightMtx, vec4(posOffset, 1.0) );
-	v_shadowcoord = mul(u_lightMtx, vec4(a_position, 1.0) );
+    v_texcoord0 = vec2(a_texcoord0.x, 1.0 - a_texcoord0.y);
 }
\ No newline at end of file
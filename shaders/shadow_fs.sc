@@ -2,12 +2,19 @@ $input v_position
 
 #include "../bgfx/examples/common/common.sh"
 
+#if SHADOW_PACKED_DEPTH
 uniform vec4 u_depthScaleOffset;  // for GL, map depth values into [0, 1] range
 #define u_depthScale u_depthScaleOffset.x
 #define u_depthOffset u_depthScaleOffset.y
+#endif
 
 void main()
 {
+#if SHADOW_PACKED_DEPTH
 	float depth = v_position.z/v_position.w * u_depthScale + u_depthOffset;
 	gl_FragColor = packFloatToRgba(depth);
-}
\ No newline at end of file
+#else
+	// depth only, color writes are masked out by the shadow pass state
+	gl_FragColor = vec4_splat(0.0);
+#endif
+}
@@ -1,10 +1,19 @@
+#if INSTANCED
+$input a_position, i_data0, i_data1, i_data2, i_data3
+#else
 $input a_position
+#endif
 $output v_position
 
 #include "../bgfx/examples/common/common.sh"
 
 void main()
 {
+#if INSTANCED
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+	gl_Position = mul(u_viewProj, mul(model, vec4(a_position, 1.0)));
+#else
 	gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
+#endif
 	v_position = gl_Position;
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+$input v_texcoord0
+
+#include "../bgfx/examples/common/common.sh"
+
+SAMPLER2D(s_hdrColor, 0);
+SAMPLER2D(s_avgLum, 1);
+
+// x: exposure scale from the compensation in stops, y: 1 to scale by the adapted average luminance
+uniform vec4 u_tonemapParams;
+
+void main()
+{
+    vec3 color = texture2D(s_hdrColor, v_texcoord0).xyz;
+
+    // the adapted average luminance is mapped to middle grey
+    float avgLum = max(texture2DLod(s_avgLum, vec2(0.5, 0.5), 0.0).x, 0.0001);
+    float exposure = u_tonemapParams.x * mix(1.0, 0.18 / avgLum, u_tonemapParams.y);
+    color *= exposure;
+
+    // tonemap and gamma correction
+    color = color / (color + vec3_splat(1.0));
+    color = pow(color, vec3_splat(1.0 / 2.2));
+
+    gl_FragColor = vec4(color, 1.0);
+}
@@ -1,20 +1,39 @@
-uniform vec4 u_params[7];
+// per material
+uniform vec4 u_params[2];
 
-#define u_lightPos u_params[0]
-#define u_lightColor u_params[1]
-#define u_viewPos u_params[2]
-#define u_roughness u_params[3].x
-#define u_metallic u_params[3].y
-#define u_exposure u_params[3].z
-#define u_usePbrMaps u_params[3].w
-#define u_diffuseColor u_params[4]
+#define u_roughness u_params[0].x
+#define u_metallic u_params[0].y
+#define u_diffuseColor u_params[1]
 
-#define u_isFloor u_params[5].x
-#define u_pcfFilterSize u_params[5].y
-#define u_useBlinnPhong u_params[5].z
-#define u_usePBR u_params[5].w
+// atlas tiles, the cascades or the six faces of the point light, see Shadow::kMaxViews
+#define SHADOW_MAX_VIEWS 6
+// poisson disk samples, see Shadow::kNumPoissonSamples
+#define NUM_SAMPLES 64
 
-#define u_useDiffuseIBL u_params[6].x
-#define u_useSpecularIBL u_params[6].y
-#define u_useShadowMap u_params[6].z
+// camera, light, shadow and environment, updated once per frame and bound to every scene draw at
+// stage 11, the members are in the same order as the uniforms passed to createUniformBlock in homework.cpp
+UNIFORM_BLOCK_BEGIN(u_frame, 11)
+UNIFORM_BLOCK_MEMBER(vec4, u_lightPos);
+UNIFORM_BLOCK_MEMBER(vec4, u_lightColor);
+UNIFORM_BLOCK_MEMBER(vec4, u_viewPos);
+// x: pcf filter size, y: max mip of s_texCube, z: size of s_texCube
+UNIFORM_BLOCK_MEMBER(vec4, u_frameParams);
+// x: number of point lights, y and z: view depth to slice scale and bias, see clustered.sh
+UNIFORM_BLOCK_MEMBER(vec4, u_clusterParams);
+// diffuse irradiance as 9 spherical harmonics coefficients, see Ibl::loadIrradianceSh
+UNIFORM_BLOCK_MEMBER(vec4, u_irradianceSh[9]);
+// cascaded or point light shadow map, world space to atlas tile texture space per tile
+UNIFORM_BLOCK_MEMBER(mat4, u_lightMtx[SHADOW_MAX_VIEWS]);
+UNIFORM_BLOCK_MEMBER(vec4, u_shadowTiles[SHADOW_MAX_VIEWS]);
+UNIFORM_BLOCK_MEMBER(vec4, u_cascadeSplits);
+UNIFORM_BLOCK_MEMBER(vec4, u_shadowParams);
+// precomputed poisson disk, two samples per vec4, outermost samples last
+UNIFORM_BLOCK_MEMBER(vec4, u_poissonDisk[NUM_SAMPLES / 2]);
+UNIFORM_BLOCK_END()
 
+#define u_numCascades u_shadowParams.x
+#define u_shadowTexelSize u_shadowParams.yz
+#define u_pcssLightSize u_shadowParams.w
+#define u_pcfFilterSize u_frameParams.x
+#define u_envMaxMip u_frameParams.y
+#define u_envSize u_frameParams.z
@@ -15,3 +15,7 @@ vec4 a_color0    : COLOR0;
 vec2 a_texcoord0 : TEXCOORD0;
 vec3 a_normal    : NORMAL;
 vec4 a_tangent   : TANGENT;
+vec4 i_data0     : TEXCOORD7;
+vec4 i_data1     : TEXCOORD6;
+vec4 i_data2     : TEXCOORD5;
+vec4 i_data3     : TEXCOORD4;